@@ -0,0 +1,152 @@
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#include "allocation_counter.h"
+
+static std::atomic<uint64_t> heapAllocationCount{0};
+static std::atomic<uint64_t> heapAllocationBytes{0};
+
+uint64_t getHeapAllocationCount() {
+    return heapAllocationCount.load(std::memory_order_relaxed);
+}
+
+uint64_t getHeapAllocationBytes() {
+    return heapAllocationBytes.load(std::memory_order_relaxed);
+}
+
+#ifdef SCENE_MODELING_COUNT_ALLOCATIONS
+static void* tryAllocate(std::size_t size, std::size_t alignment) noexcept {
+    size = size != 0 ? size : 1;
+    if (alignment <= alignof(std::max_align_t)) {
+        return std::malloc(size);
+    }
+
+#ifdef _WIN32
+    return _aligned_malloc(size, alignment);
+#else
+    // aligned_alloc wants a multiple of the alignment
+    return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+}
+
+static void release(void* pointer, std::size_t alignment) noexcept {
+#ifdef _WIN32
+    if (alignment > alignof(std::max_align_t)) {
+        _aligned_free(pointer);
+        return;
+    }
+#endif
+    (void)alignment;
+    std::free(pointer);
+}
+
+static void* allocate(std::size_t size, std::size_t alignment) {
+    heapAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    heapAllocationBytes.fetch_add(size, std::memory_order_relaxed);
+
+    // like the default operator new, the new handler gets to free memory before giving up
+    while (true) {
+        if (void* pointer = tryAllocate(size, alignment)) {
+            return pointer;
+        }
+
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+static void* allocateNoThrow(std::size_t size, std::size_t alignment) noexcept {
+    try {
+        return allocate(size, alignment);
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+static constexpr std::size_t defaultAlignment = alignof(std::max_align_t);
+
+void* operator new(std::size_t size) {
+    return allocate(size, defaultAlignment);
+}
+
+void* operator new[](std::size_t size) {
+    return allocate(size, defaultAlignment);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return allocateNoThrow(size, defaultAlignment);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return allocateNoThrow(size, defaultAlignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocateNoThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocateNoThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* pointer) noexcept {
+    release(pointer, defaultAlignment);
+}
+
+void operator delete[](void* pointer) noexcept {
+    release(pointer, defaultAlignment);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    release(pointer, defaultAlignment);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept {
+    release(pointer, defaultAlignment);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept {
+    release(pointer, defaultAlignment);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept {
+    release(pointer, defaultAlignment);
+}
+
+void operator delete(void* pointer, std::align_val_t alignment) noexcept {
+    release(pointer, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* pointer, std::align_val_t alignment) noexcept {
+    release(pointer, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t alignment) noexcept {
+    release(pointer, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* pointer, std::size_t, std::align_val_t alignment) noexcept {
+    release(pointer, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* pointer, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    release(pointer, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* pointer, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    release(pointer, static_cast<std::size_t>(alignment));
+}
+#endif
\ No newline at end of file
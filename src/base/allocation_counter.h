@@ -0,0 +1,10 @@
+#pragma once
+
+#include <cstdint>
+
+// the global operator new and delete overloads are replaced by counting ones when the target is
+// built with SCENE_MODELING_COUNT_ALLOCATIONS, every thread is counted. both stay 0 otherwise
+uint64_t getHeapAllocationCount();
+
+// bytes requested, alignment padding excluded
+uint64_t getHeapAllocationBytes();
\ No newline at end of file
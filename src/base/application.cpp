@@ -1,9 +1,190 @@
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+#ifdef SCENE_MODELING_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
 #include "application.h"
+#include "frame_allocator.h"
+#include "geometry_arena.h"
+#include "gl_state_cache.h"
+#include "render_statistics.h"
+#include "profiler.h"
+#include "readback_service.h"
+#include "trace_recorder.h"
 
 Application::Application(const Options& options)
     : _assetRootDir(options.assetRootDir), _windowTitle(options.windowTitle),
       _windowWidth(options.windowWidth), _windowHeight(options.windowHeight),
-      _clearColor(options.backgroundColor) {
+      _headless(options.headless), _frameStatisticsPath(options.frameStatisticsPath),
+      _memoryReportPath(options.memoryReportPath), _clearColor(options.backgroundColor) {
+    if (_headless) {
+        createHeadlessContext(options);
+    } else {
+        createWindow(options);
+    }
+
+    std::cout << "OpenGL\n";
+    std::cout << "+ version:    " << glGetString(GL_VERSION) << '\n';
+    std::cout << "+ renderer:   " << glGetString(GL_RENDERER) << '\n';
+    std::cout << "+ glsl:       " << glGetString(GL_SHADING_LANGUAGE_VERSION) << '\n';
+    std::cout << std::endl;
+
+    if (_headless) {
+        createOffscreenFramebuffer();
+    } else {
+        // framebuffer and viewport
+        glfwGetFramebufferSize(_window, &_windowWidth, &_windowHeight);
+    }
+    glViewport(0, 0, _windowWidth, _windowHeight);
+
+    if (options.msaa && !_headless) {
+        glEnable(GL_MULTISAMPLE);
+    }
+
+    TraceRecorder::get().setThreadName("main");
+    JobSystem::get().start();
+    if (options.traceFrames > 0) {
+        TraceRecorder::get().start(options.traceFrames, options.tracePath);
+    }
+
+    // record time
+    _lastTimeStamp = std::chrono::high_resolution_clock::now();
+}
+
+Application::~Application() {
+    // pending screenshots are written before the workers go away
+    ReadbackService::get().release();
+    JobSystem::get().stop();
+
+    Profiler::get().release();
+
+    GeometryArena::get().release();
+
+    if (_headless) {
+        destroyHeadlessContext();
+        return;
+    }
+
+    if (_window != nullptr) {
+        glfwDestroyWindow(_window);
+        _window = nullptr;
+    }
+
+    glfwTerminate();
+}
+
+int Application::run() {
+    TraceRecorder& trace = TraceRecorder::get();
+    while (!_closeRequested && (_headless || !glfwWindowShouldClose(_window))) {
+        trace.onFrameBoundary();
+        TraceScope frameScope("frame");
+
+        GLStateCache::get().beginFrame();
+        RenderStatistics::get().beginFrame();
+        FrameAllocator::get().beginFrame();
+        Profiler::get().beginFrame();
+        updateTime();
+        {
+            TraceScope scope("input");
+            handleInput();
+        }
+        {
+            TraceScope scope("render");
+            renderFrame();
+        }
+        {
+            TraceScope scope("readback");
+            ReadbackService::get().update();
+            trace.counter("pending readbacks", static_cast<double>(ReadbackService::get().getPendingCount()));
+        }
+        {
+            TraceScope scope("wait frame jobs");
+            JobSystem::get().wait(_frameJobs);
+        }
+        Profiler::get().endFrame();
+
+        if (!_headless) {
+            {
+                TraceScope scope("swap buffers");
+                glfwSwapBuffers(_window);
+            }
+            TraceScope scope("poll events");
+            glfwPollEvents();
+        }
+    }
+
+    // a recording cut short by closing the window is still written
+    trace.stop();
+
+    const FrameAllocator& frameAllocator = FrameAllocator::get();
+    if (frameAllocator.getLastFrameHeapAllocations() >= 0) {
+        std::cout << "heap allocations per frame: last " << frameAllocator.getLastFrameHeapAllocations()
+                  << ", mean " << frameAllocator.getMeanHeapAllocations() << ", max "
+                  << frameAllocator.getMaxHeapAllocations() << std::endl;
+    }
+
+    if (!_frameStatisticsPath.empty()) {
+        std::ofstream file(_frameStatisticsPath);
+        file << _frameStatistics.getSummary().toJson() << std::endl;
+        if (!file) {
+            std::cerr << "write frame statistics " + _frameStatisticsPath + " failure" << std::endl;
+        }
+    }
+
+    if (!_memoryReportPath.empty()) {
+        std::ofstream file(_memoryReportPath);
+        MemoryTracker::get().dump(file);
+        if (!file) {
+            std::cerr << "write memory report " + _memoryReportPath + " failure" << std::endl;
+        }
+    }
+
+    return _exitCode;
+}
+
+std::string Application::getAssetFullPath(const std::string& resourceRelPath) const {
+    return _assetRootDir + resourceRelPath;
+}
+
+void Application::updateTime() {
+    auto now = std::chrono::high_resolution_clock::now();
+    _deltaTime = 0.001f * std::chrono::duration<float, std::milli>(now - _lastTimeStamp).count();
+    _lastTimeStamp = now;
+    if (_deltaTime != 0.0f) {
+        _frameStatistics.push(1000.0f * _deltaTime);
+    }
+}
+
+void Application::requestClose(int exitCode) {
+    _closeRequested = true;
+    _exitCode = exitCode;
+}
+
+void Application::showFpsInWindowTitle() {
+    if (_window == nullptr) {
+        return;
+    }
+
+    // setting the title is not free, a few times a second is enough to read it
+    _titleUpdateTime += _deltaTime;
+    if (_titleUpdateTime < 0.25f) {
+        return;
+    }
+    _titleUpdateTime = 0.0f;
+
+    const FrameTimeSummary summary = _frameStatistics.getWindowSummary();
+    char detail[128];
+    std::snprintf(
+        detail, sizeof(detail), ": %.2f ms (%.1f fps), p99 %.2f ms, %zu hitches", summary.meanMs,
+        summary.getFramesPerSecond(), summary.p99Ms, summary.hitchCount);
+    glfwSetWindowTitle(_window, (_windowTitle + detail).c_str());
+}
+
+void Application::createWindow(const Options& options) {
     // set error callback
     glfwSetErrorCallback(errorCallback);
 
@@ -49,68 +230,129 @@ Application::Application(const Options& options)
         throw std::runtime_error("glad initialization OpenGL failure");
     }
 
-    std::cout << "OpenGL\n";
-    std::cout << "+ version:    " << glGetString(GL_VERSION) << '\n';
-    std::cout << "+ renderer:   " << glGetString(GL_RENDERER) << '\n';
-    std::cout << "+ glsl:       " << glGetString(GL_SHADING_LANGUAGE_VERSION) << '\n';
-    std::cout << std::endl;
-
-    // framebuffer and viewport
-    glfwGetFramebufferSize(_window, &_windowWidth, &_windowHeight);
-    glViewport(0, 0, _windowWidth, _windowHeight);
-
-    if (options.msaa) {
-        glEnable(GL_MULTISAMPLE);
-    }
-
     // callback functions
     glfwSetFramebufferSizeCallback(_window, framebufferResizeCallback);
     glfwSetKeyCallback(_window, keyCallback);
     glfwSetMouseButtonCallback(_window, mouseButtonCallback);
     glfwSetCursorPosCallback(_window, cursorPosCallback);
     glfwSetScrollCallback(_window, scrollCallback);
-
-    // record time
-    _lastTimeStamp = std::chrono::high_resolution_clock::now();
 }
 
-Application::~Application() {
-    if (_window != nullptr) {
-        glfwDestroyWindow(_window);
-        _window = nullptr;
+#ifdef SCENE_MODELING_EGL
+void Application::createHeadlessContext(const Options& options) {
+    // mesa can create a display without any window system, llvmpipe renders on the cpu
+    EGLDisplay display = EGL_NO_DISPLAY;
+    const auto getPlatformDisplay =
+        (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (getPlatformDisplay != nullptr) {
+        display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    }
+    if (display == EGL_NO_DISPLAY) {
+        display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
     }
 
-    glfwTerminate();
-}
+    EGLint major, minor;
+    if (display == EGL_NO_DISPLAY || eglInitialize(display, &major, &minor) != EGL_TRUE) {
+        throw std::runtime_error("init egl display failure");
+    }
+    _eglDisplay = display;
 
-void Application::run() {
-    while (!glfwWindowShouldClose(_window)) {
-        updateTime();
-        handleInput();
-        renderFrame();
+    const EGLint configAttributes[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT, EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE};
+    EGLConfig config = nullptr;
+    EGLint configCount = 0;
+    eglChooseConfig(display, configAttributes, &config, 1, &configCount);
 
-        glfwSwapBuffers(_window);
-        glfwPollEvents();
+    const EGLint contextAttributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION, options.glVersion.first,
+        EGL_CONTEXT_MINOR_VERSION, options.glVersion.second,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE};
+    if (eglBindAPI(EGL_OPENGL_API) != EGL_TRUE) {
+        destroyHeadlessContext();
+        throw std::runtime_error("egl has no desktop opengl");
     }
-}
 
-std::string Application::getAssetFullPath(const std::string& resourceRelPath) const {
-    return _assetRootDir + resourceRelPath;
+    // the surfaceless display has no configs, the context is then created without one
+    EGLContext context = eglCreateContext(
+        display, configCount > 0 ? config : EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, contextAttributes);
+    if (context == EGL_NO_CONTEXT) {
+        destroyHeadlessContext();
+        throw std::runtime_error("create egl context failure");
+    }
+    _eglContext = context;
+
+    if (eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context) != EGL_TRUE) {
+        destroyHeadlessContext();
+        throw std::runtime_error("egl context without surface is not supported");
+    }
+
+    if (!gladLoadGL((GLADloadfunc)eglGetProcAddress)) {
+        destroyHeadlessContext();
+        throw std::runtime_error("glad initialization OpenGL failure");
+    }
 }
 
-void Application::updateTime() {
-    auto now = std::chrono::high_resolution_clock::now();
-    _deltaTime = 0.001f * std::chrono::duration<float, std::milli>(now - _lastTimeStamp).count();
-    _lastTimeStamp = now;
-    if (_deltaTime != 0.0f) {
-        _fpsIndicator.push(1.0f / _deltaTime);
+void Application::destroyHeadlessContext() {
+    if (_offscreenFBO != 0) {
+        GLStateCache::get().onFramebufferDeleted(_offscreenFBO);
+        glDeleteFramebuffers(1, &_offscreenFBO);
+        glDeleteRenderbuffers(1, &_offscreenColor);
+        glDeleteRenderbuffers(1, &_offscreenDepth);
+        RenderStatistics::get().onDeleted(GLObjectType::Framebuffer);
+        RenderStatistics::get().onDeleted(GLObjectType::Renderbuffer, 2);
+        MemoryTracker::get().remove(_offscreenMemory);
+        _offscreenFBO = _offscreenColor = _offscreenDepth = 0;
+        _offscreenMemory = MemoryTracker::invalidId;
+    }
+
+    if (_eglDisplay != nullptr) {
+        eglMakeCurrent(_eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        if (_eglContext != nullptr) {
+            eglDestroyContext(_eglDisplay, _eglContext);
+            _eglContext = nullptr;
+        }
+        eglTerminate(_eglDisplay);
+        _eglDisplay = nullptr;
     }
 }
+#else
+void Application::createHeadlessContext(const Options& options) {
+    throw std::runtime_error("headless mode needs a build with egl");
+}
 
-void Application::showFpsInWindowTitle() {
-    float fps = _fpsIndicator.getAverageFrameRate();
-    std::string detailTitle = _windowTitle + ": " + std::to_string(fps) + " fps";
-    glfwSetWindowTitle(_window, detailTitle.c_str());
+void Application::destroyHeadlessContext() {}
+#endif
+
+void Application::createOffscreenFramebuffer() {
+    glGenRenderbuffers(1, &_offscreenColor);
+    glBindRenderbuffer(GL_RENDERBUFFER, _offscreenColor);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, _windowWidth, _windowHeight);
+
+    glGenRenderbuffers(1, &_offscreenDepth);
+    glBindRenderbuffer(GL_RENDERBUFFER, _offscreenDepth);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, _windowWidth, _windowHeight);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &_offscreenFBO);
+    RenderStatistics::get().onCreated(GLObjectType::Framebuffer);
+    RenderStatistics::get().onCreated(GLObjectType::Renderbuffer, 2);
+    MemoryOwnerScope owner("offscreen framebuffer");
+    _offscreenMemory = MemoryTracker::get().add(
+        MemoryCategory::Renderbuffer,
+        (MemoryTracker::getTexelSize(GL_RGBA8) + MemoryTracker::getTexelSize(GL_DEPTH24_STENCIL8))
+            * _windowWidth * _windowHeight);
+    GLStateCache& state = GLStateCache::get();
+    state.bindFramebuffer(GL_FRAMEBUFFER, _offscreenFBO);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, _offscreenColor);
+    glFramebufferRenderbuffer(
+        GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, _offscreenDepth);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        throw std::runtime_error("offscreen framebuffer is incomplete");
+    }
+
+    // code written for the window framebuffer now draws here
+    state.setDefaultFramebuffer(_offscreenFBO);
 }
 
 void Application::errorCallback(int error, const char* description) {
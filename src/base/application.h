@@ -1,17 +1,21 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
 #include <functional>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 #define GLFW_INCLUDE_NONE
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
 
-#include "frame_rate_indicator.h"
+#include "frame_statistics.h"
 #include "gl_utility.h"
 #include "input.h"
+#include "job_system.h"
+#include "memory_tracker.h"
 
 struct Options {
     std::string assetRootDir;
@@ -23,6 +27,32 @@ struct Options {
     bool msaa;
     std::pair<int, int> glVersion;
     glm::vec4 backgroundColor;
+    /* render into an offscreen framebuffer of the window size without a window, needs egl */
+    bool headless = false;
+    /* assets rendered one per frame in headless mode */
+    std::vector<std::string> batchAssets;
+    std::string outputDir = ".";
+    /* frames of a turntable per asset in headless mode, 0 renders one still image */
+    int turntableFrames = 0;
+    /* png or qoi */
+    std::string imageFormat = "png";
+    /* frames recorded into a chrome trace written to tracePath, 0 records none */
+    int traceFrames = 0;
+    std::string tracePath = "trace.json";
+    /* the frame time summary of the run is written here as json on exit, empty writes none */
+    std::string frameStatisticsPath;
+    /* the memory tracker's breakdown at the end of the run is written here, empty writes none */
+    std::string memoryReportPath;
+    /* a benchmark script run instead of the editor, see BenchmarkScript */
+    std::string benchmarkScript;
+    std::string benchmarkReport = "benchmark.json";
+    /* a stress scene of each count is generated and measured in turn instead of the editor */
+    std::vector<int> stressObjectCounts;
+    uint32_t stressSeed = 1;
+    /* split between point and spot lights */
+    int stressLightCount = 8;
+    /* compare views rendered with and without hi-z culling instead of the editor, see HiZCheck */
+    bool checkHiZ = false;
 };
 
 class Application {
@@ -35,23 +65,38 @@ public:
 
     virtual ~Application();
 
-    void run();
+    /* the exit code of the process */
+    int run();
 
 protected:
     /* _assetPath */
     std::string _assetRootDir;
 
-    /* window info */
+    /* window info, there is no window in headless mode */
     GLFWwindow* _window = nullptr;
     std::string _windowTitle;
     int _windowWidth = 0;
     int _windowHeight = 0;
     bool _windowReized = false;
 
-    /* timer for fps */
+    /* headless mode renders into _offscreenFBO through an egl context without a surface */
+    bool _headless = false;
+    bool _closeRequested = false;
+    int _exitCode = 0;
+    void* _eglDisplay = nullptr;
+    void* _eglContext = nullptr;
+    GLuint _offscreenFBO = 0;
+    GLuint _offscreenColor = 0;
+    GLuint _offscreenDepth = 0;
+    MemoryTracker::Id _offscreenMemory = MemoryTracker::invalidId;
+
+    /* frame timer, the statistics keep the last 240 frame times */
     std::chrono::time_point<std::chrono::high_resolution_clock> _lastTimeStamp;
     float _deltaTime = 0.0f;
-    FrameRateIndicator _fpsIndicator{64};
+    FrameStatistics _frameStatistics{240};
+    std::string _frameStatisticsPath;
+    std::string _memoryReportPath;
+    float _titleUpdateTime = 0.0f;
 
     /* input handler */
     Input _input;
@@ -59,8 +104,14 @@ protected:
     /* clear color */
     glm::vec4 _clearColor = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
 
+    /* jobs submitted with this counter are joined before the frame is presented */
+    JobCounter _frameJobs;
+
     std::string getAssetFullPath(const std::string& resourceRelPath) const;
 
+    /* leave run() after the current frame, which then returns exitCode */
+    void requestClose(int exitCode = 0);
+
     void updateTime();
 
     /* derived class can override this function to handle input */
@@ -71,6 +122,14 @@ protected:
 
     void showFpsInWindowTitle();
 
+    void createWindow(const Options& options);
+
+    void createHeadlessContext(const Options& options);
+
+    void createOffscreenFramebuffer();
+
+    void destroyHeadlessContext();
+
     static void errorCallback(int error, const char* description);
 
     static void framebufferResizeCallback(GLFWwindow* window, int width, int height);
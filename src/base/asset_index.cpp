@@ -0,0 +1,329 @@
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <utility>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include "asset_index.h"
+#include "trace_recorder.h"
+
+#ifdef __linux__
+static constexpr uint32_t watchMask = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR;
+#endif
+
+static const std::pair<const char*, AssetType> extensionTypes[] = {
+    {"obj", AssetType::Model},    {"png", AssetType::Texture},  {"jpg", AssetType::Texture},
+    {"jpeg", AssetType::Texture}, {"bmp", AssetType::Texture},  {"tga", AssetType::Texture},
+    {"hdr", AssetType::Texture},  {"vert", AssetType::Shader},  {"frag", AssetType::Shader},
+    {"geom", AssetType::Shader},  {"comp", AssetType::Shader},  {"glsl", AssetType::Shader}};
+
+static bool startsWith(const std::string& text, const std::string& prefix) {
+    return text.compare(0, prefix.size(), prefix) == 0;
+}
+
+static void insertSorted(AssetIndex::FileList& list, const std::string& path) {
+    auto position = std::lower_bound(list.begin(), list.end(), path);
+    if (position == list.end() || *position != path) {
+        list.insert(position, path);
+    }
+}
+
+AssetIndex& AssetIndex::get() {
+    static AssetIndex index;
+    return index;
+}
+
+AssetIndex::AssetIndex() {
+    for (auto& files : _files) {
+        files = std::make_shared<const FileList>();
+    }
+}
+
+AssetIndex::~AssetIndex() {
+    stop();
+}
+
+void AssetIndex::start(const std::string& rootDir) {
+    stop();
+
+    _rootDir = rootDir;
+    _ready = false;
+    _thread = std::thread([this]() {
+        TraceRecorder::get().setThreadName("asset index");
+        scan();
+        watch();
+    });
+}
+
+void AssetIndex::stop() {
+    _quit = true;
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+    _quit = false;
+
+#ifdef __linux__
+    if (_inotify >= 0) {
+        close(_inotify);
+        _inotify = -1;
+    }
+#endif
+    _watches.clear();
+}
+
+void AssetIndex::rescan() {
+    if (!_rootDir.empty()) {
+        start(_rootDir);
+    }
+}
+
+bool AssetIndex::isReady() const {
+    return _ready;
+}
+
+const std::string& AssetIndex::getRootDir() const {
+    return _rootDir;
+}
+
+std::shared_ptr<const AssetIndex::FileList> AssetIndex::getFiles(AssetType type) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _files[static_cast<size_t>(type)];
+}
+
+uint64_t AssetIndex::getVersion() const {
+    return _version;
+}
+
+AssetType AssetIndex::getType(const std::string& path) {
+    const size_t dot = path.find_last_of('.');
+    const size_t slash = path.find_last_of('/');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        return AssetType::Other;
+    }
+
+    char extension[8] = {};
+    const size_t length = path.size() - dot - 1;
+    if (length >= sizeof(extension)) {
+        return AssetType::Other;
+    }
+    for (size_t i = 0; i < length; ++i) {
+        extension[i] = static_cast<char>(std::tolower(static_cast<unsigned char>(path[dot + 1 + i])));
+    }
+
+    for (const auto& extensionType : extensionTypes) {
+        if (std::strcmp(extension, extensionType.first) == 0) {
+            return extensionType.second;
+        }
+    }
+
+    return AssetType::Other;
+}
+
+bool AssetIndex::matches(const std::string& path, const char* filter) {
+    const size_t filterLength = std::strlen(filter);
+    for (size_t start = 0; start + filterLength <= path.size(); ++start) {
+        size_t i = 0;
+        while (i < filterLength
+               && std::tolower(static_cast<unsigned char>(path[start + i]))
+                      == std::tolower(static_cast<unsigned char>(filter[i]))) {
+            ++i;
+        }
+        if (i == filterLength) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void AssetIndex::scan() {
+    TraceScope scope("scan assets");
+
+#ifdef __linux__
+    _inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (_inotify < 0) {
+        std::cerr << "watch " + _rootDir + " failure, the asset index is only updated by a rescan"
+                  << std::endl;
+    }
+#endif
+
+    // the watches are added while listing, so no change after the listing is missed
+    Lists lists;
+    addTree("", lists);
+
+    if (_quit) {
+        return;
+    }
+
+    for (size_t i = 0; i < typeCount; ++i) {
+        std::sort(lists[i].begin(), lists[i].end());
+        publish(static_cast<AssetType>(i), std::move(lists[i]));
+    }
+    _ready = true;
+}
+
+void AssetIndex::addTree(const std::string& relativeDir, Lists& lists) {
+    const std::string rootPrefix = std::filesystem::path(_rootDir).generic_string();
+    const auto addWatch = [this](const std::string& dir) {
+#ifdef __linux__
+        if (_inotify >= 0) {
+            const int descriptor = inotify_add_watch(_inotify, (_rootDir + dir).c_str(), watchMask);
+            if (descriptor >= 0) {
+                _watches[descriptor] = dir;
+            }
+        }
+#endif
+    };
+
+    addWatch(relativeDir);
+
+    std::error_code error;
+    std::filesystem::recursive_directory_iterator iter(_rootDir + relativeDir, error);
+    for (; !error && !_quit && iter != std::filesystem::recursive_directory_iterator();
+         iter.increment(error)) {
+        const std::string path = iter->path().generic_string().substr(rootPrefix.size());
+        if (iter->is_directory(error)) {
+            addWatch(path);
+        } else if (iter->is_regular_file(error)) {
+            lists[static_cast<size_t>(getType(path))].push_back(path);
+        }
+    }
+
+    if (error) {
+        std::cerr << "scan " + _rootDir + relativeDir + " failure: " << error.message() << std::endl;
+    }
+}
+
+void AssetIndex::publish(AssetType type, FileList list) {
+    auto files = std::make_shared<const FileList>(std::move(list));
+    std::lock_guard<std::mutex> lock(_mutex);
+    _files[static_cast<size_t>(type)] = std::move(files);
+    ++_version;
+}
+
+void AssetIndex::watch() {
+#ifdef __linux__
+    if (_inotify < 0) {
+        return;
+    }
+
+    alignas(inotify_event) char buffer[16 * 1024];
+    while (!_quit) {
+        // wakes up regularly to notice stop()
+        pollfd descriptor = {_inotify, POLLIN, 0};
+        if (poll(&descriptor, 1, 200) <= 0) {
+            continue;
+        }
+
+        const ssize_t length = read(_inotify, buffer, sizeof(buffer));
+        if (length <= 0) {
+            continue;
+        }
+
+        // the events are applied in order to copies of the lists they touch, which are published
+        // once the batch is through
+        std::array<std::unique_ptr<FileList>, typeCount> changed;
+        const auto getList = [&](size_t type) -> FileList& {
+            if (changed[type] == nullptr) {
+                changed[type] = std::make_unique<FileList>(*getFiles(static_cast<AssetType>(type)));
+            }
+            return *changed[type];
+        };
+
+        bool overflowed = false;
+        for (ssize_t offset = 0; offset < length && !overflowed;) {
+            const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            offset += sizeof(inotify_event) + event->len;
+
+            // events were dropped, e.g. by a bulk copy into the library
+            if (event->mask & IN_Q_OVERFLOW) {
+                overflowed = true;
+                continue;
+            }
+
+            if (event->mask & IN_IGNORED) {
+                _watches.erase(event->wd);
+                continue;
+            }
+
+            const auto dir = _watches.find(event->wd);
+            if (dir == _watches.end() || event->len == 0) {
+                continue;
+            }
+            const std::string path = dir->second.empty() ? std::string(event->name)
+                                                         : dir->second + "/" + event->name;
+
+            const bool added = (event->mask & (IN_CREATE | IN_MOVED_TO)) != 0;
+            const bool removed = (event->mask & (IN_DELETE | IN_MOVED_FROM)) != 0;
+            if (!(event->mask & IN_ISDIR)) {
+                FileList& list = getList(static_cast<size_t>(getType(path)));
+                if (added) {
+                    insertSorted(list, path);
+                } else if (removed) {
+                    auto position = std::lower_bound(list.begin(), list.end(), path);
+                    if (position != list.end() && *position == path) {
+                        list.erase(position);
+                    }
+                }
+            } else if (added) {
+                // files may have landed in a new directory before its watch was added
+                Lists lists;
+                addTree(path, lists);
+                for (size_t type = 0; type < typeCount; ++type) {
+                    for (const std::string& file : lists[type]) {
+                        insertSorted(getList(type), file);
+                    }
+                }
+            } else if (removed) {
+                const std::string prefix = path + "/";
+                for (size_t type = 0; type < typeCount; ++type) {
+                    FileList& list = getList(type);
+                    auto first = std::lower_bound(list.begin(), list.end(), prefix);
+                    auto last = first;
+                    while (last != list.end() && startsWith(*last, prefix)) {
+                        ++last;
+                    }
+                    list.erase(first, last);
+                }
+
+                // a directory moved elsewhere keeps its watches, they would report stale paths
+                for (auto iter = _watches.begin(); iter != _watches.end();) {
+                    if (iter->second == path || startsWith(iter->second, prefix)) {
+                        inotify_rm_watch(_inotify, iter->first);
+                        iter = _watches.erase(iter);
+                    } else {
+                        ++iter;
+                    }
+                }
+            }
+        }
+
+        if (overflowed) {
+            // nothing tells what was missed, the tree is listed and watched again from scratch.
+            // the lists in use stay published until the new ones replace them
+            std::cerr << "watch " + _rootDir + " overflow, the assets are listed again" << std::endl;
+            close(_inotify);
+            _inotify = -1;
+            _watches.clear();
+            scan();
+            if (_inotify < 0) {
+                return;
+            }
+            continue;
+        }
+
+        for (size_t type = 0; type < typeCount; ++type) {
+            if (changed[type] != nullptr) {
+                publish(static_cast<AssetType>(type), std::move(*changed[type]));
+            }
+        }
+    }
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+enum class AssetType {
+    // obj files, the only format the model loader reads
+    Model,
+    // the formats stb_image reads
+    Texture,
+    Shader,
+    Other,
+    Count
+};
+
+// the files under the asset root, listed once by a thread of its own, which then keeps them up to
+// date through inotify on linux, elsewhere rescan() must be called. the lookups never touch the
+// disk, so the ui can query the index every frame.
+class AssetIndex {
+public:
+    using FileList = std::vector<std::string>;
+
+    static constexpr size_t typeCount = static_cast<size_t>(AssetType::Count);
+
+    static AssetIndex& get();
+
+    AssetIndex(const AssetIndex&) = delete;
+
+    AssetIndex& operator=(const AssetIndex&) = delete;
+
+    ~AssetIndex();
+
+    // rootDir ends with a separator, like Application::getAssetFullPath expects
+    void start(const std::string& rootDir);
+
+    // abandons a listing in progress
+    void stop();
+
+    void rescan();
+
+    // the first listing is complete, the lists are empty before
+    bool isReady() const;
+
+    const std::string& getRootDir() const;
+
+    // paths relative to the root with '/' separators, sorted. a change publishes a new list,
+    // so the one returned here stays valid and unchanged for as long as it is held
+    std::shared_ptr<const FileList> getFiles(AssetType type) const;
+
+    // incremented whenever a list changes
+    uint64_t getVersion() const;
+
+    static AssetType getType(const std::string& path);
+
+    // case-insensitive substring test, an empty filter matches every path
+    static bool matches(const std::string& path, const char* filter);
+
+private:
+    using Lists = std::array<FileList, typeCount>;
+
+    std::string _rootDir;
+
+    mutable std::mutex _mutex;
+    std::array<std::shared_ptr<const FileList>, typeCount> _files;
+    std::atomic<uint64_t> _version{0};
+    std::atomic<bool> _ready{false};
+
+    // lists the tree then watches it, the frame jobs are never held up by the disk
+    std::thread _thread;
+    std::atomic<bool> _quit{false};
+
+    // inotify descriptor and the watched directories relative to the root, "" for the root.
+    // only touched by _thread
+    int _inotify = -1;
+    std::unordered_map<int, std::string> _watches;
+
+    AssetIndex();
+
+    void scan();
+
+    // lists and watches relativeDir and the directories below it
+    void addTree(const std::string& relativeDir, Lists& lists);
+
+    void publish(AssetType type, FileList list);
+
+    void watch();
+};
\ No newline at end of file
@@ -0,0 +1,171 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include "capture_recorder.h"
+#include "job_system.h"
+#include "readback_service.h"
+
+static size_t getPeakResidentBytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.PeakWorkingSetSize;
+    }
+    return 0;
+#else
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return static_cast<size_t>(usage.ru_maxrss);
+#else
+    // kilobytes on linux
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+CameraAnimation CaptureRecorder::makeTurntable(
+    const glm::vec3& target, float distance, float height, float period) {
+    return [=](float time, Transform& camera) {
+        const float angle = glm::two_pi<float>() * time / period;
+        camera.position = target + glm::vec3(std::sin(angle) * distance, height, std::cos(angle) * distance);
+        camera.lookAt(target);
+    };
+}
+
+CameraAnimation CaptureRecorder::makePath(std::vector<CameraKeyframe> keyframes) {
+    return [keyframes = std::move(keyframes)](float time, Transform& camera) {
+        if (keyframes.empty()) {
+            return;
+        }
+
+        // catmull-rom through the keyframes, the end keys are repeated as the outer control points
+        size_t next = 0;
+        while (next < keyframes.size() && keyframes[next].time <= time) {
+            ++next;
+        }
+        if (next == 0 || next == keyframes.size()) {
+            const CameraKeyframe& key = keyframes[next == 0 ? 0 : keyframes.size() - 1];
+            camera.position = key.eye;
+            camera.lookAt(key.target);
+            return;
+        }
+
+        const CameraKeyframe& k0 = keyframes[next > 1 ? next - 2 : 0];
+        const CameraKeyframe& k1 = keyframes[next - 1];
+        const CameraKeyframe& k2 = keyframes[next];
+        const CameraKeyframe& k3 = keyframes[std::min(next + 1, keyframes.size() - 1)];
+        const float t = (time - k1.time) / std::max(k2.time - k1.time, 1e-6f);
+        const auto spline = [t](const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3) {
+            return 0.5f * (2.0f * p1 + (p2 - p0) * t + (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t * t
+                           + (3.0f * p1 - p0 - 3.0f * p2 + p3) * t * t * t);
+        };
+
+        camera.position = spline(k0.eye, k1.eye, k2.eye, k3.eye);
+        camera.lookAt(spline(k0.target, k1.target, k2.target, k3.target));
+    };
+}
+
+void CaptureRecorder::start(
+    const std::string& outputDir, const std::string& extension, int frameCount, float frameRate,
+    CameraAnimation animation) {
+    if (_recording || frameCount <= 0) {
+        return;
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(outputDir, error);
+    if (error) {
+        std::cerr << "create capture directory " + outputDir + " failure" << std::endl;
+        return;
+    }
+
+    _outputDir = outputDir;
+    _extension = extension;
+    _frameCount = frameCount;
+    _frameIndex = 0;
+    _frameRate = frameRate;
+    _animation = std::move(animation);
+    _recording = true;
+
+    // one transfer per encoder plus one being filled and one being mapped
+    ReadbackService& readback = ReadbackService::get();
+    _previousCapacity = readback.getCapacity();
+    readback.setCapacity(JobSystem::get().getWorkerCount() + 2);
+    readback.resetPeakBytes();
+
+    _report = CaptureReport{};
+    _startTime = std::chrono::high_resolution_clock::now();
+}
+
+bool CaptureRecorder::isRecording() const {
+    return _recording;
+}
+
+int CaptureRecorder::getFrameIndex() const {
+    return _frameIndex;
+}
+
+int CaptureRecorder::getFrameCount() const {
+    return _frameCount;
+}
+
+void CaptureRecorder::animate(Transform& camera) const {
+    if (_recording && _animation) {
+        _animation(_frameIndex / _frameRate, camera);
+    }
+}
+
+void CaptureRecorder::capture(GLuint framebuffer, int width, int height) {
+    if (!_recording) {
+        return;
+    }
+
+    char filename[32];
+    std::snprintf(filename, sizeof(filename), "frame_%05d.", _frameIndex);
+    ReadbackService::get().readFramebuffer(
+        framebuffer, ReadbackFormat::Color, width, height,
+        (std::filesystem::path(_outputDir) / filename).string() + _extension);
+
+    if (++_frameIndex == _frameCount) {
+        finish();
+    }
+}
+
+const CaptureReport& CaptureRecorder::getReport() const {
+    return _report;
+}
+
+void CaptureRecorder::finish() {
+    ReadbackService& readback = ReadbackService::get();
+    readback.finish();
+
+    _report.frameCount = _frameCount;
+    _report.seconds = std::chrono::duration<double>(
+        std::chrono::high_resolution_clock::now() - _startTime).count();
+    _report.framesPerSecond = _report.seconds > 0.0 ? _frameCount / _report.seconds : 0.0;
+    _report.peakReadbackBytes = readback.getPeakBytes();
+    _report.peakResidentBytes = getPeakResidentBytes();
+
+    readback.setCapacity(_previousCapacity);
+    _animation = nullptr;
+    _recording = false;
+
+    std::cout << "captured " << _report.frameCount << " frames to " << _outputDir << " in "
+              << _report.seconds << " s, " << _report.framesPerSecond << " frames/s, peak readback "
+              << _report.peakReadbackBytes / 1024 << " KB, peak resident "
+              << _report.peakResidentBytes / (1024 * 1024) << " MB" << std::endl;
+}
\ No newline at end of file
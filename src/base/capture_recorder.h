@@ -0,0 +1,77 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "gl_utility.h"
+#include "transform.h"
+
+// places the camera at a time in seconds since the capture started
+using CameraAnimation = std::function<void(float time, Transform& camera)>;
+
+// where the camera is and what it looks at, at a time in seconds
+struct CameraKeyframe {
+    float time;
+    glm::vec3 eye;
+    glm::vec3 target;
+};
+
+struct CaptureReport {
+    int frameCount = 0;
+    double seconds = 0.0;
+    double framesPerSecond = 0.0;
+    // pixel pack buffers held by the frames in flight
+    size_t peakReadbackBytes = 0;
+    // of the whole process since it started
+    size_t peakResidentBytes = 0;
+};
+
+// renders an image sequence at a fixed time step, independent of how long a frame takes.
+// the owner calls animate() before rendering a frame and capture() after it. the frames are
+// read back and encoded by ReadbackService, whose bounded ring stalls the renderer when the
+// encoders fall behind, so a long capture does not buffer more and more frames.
+class CaptureRecorder {
+public:
+    // a full turn around target every period seconds, at distance from it and height above it
+    static CameraAnimation makeTurntable(
+        const glm::vec3& target, float distance, float height, float period);
+
+    // a smooth path through keyframes sorted by time, held at the ends
+    static CameraAnimation makePath(std::vector<CameraKeyframe> keyframes);
+
+    // frames are written to outputDir/frame_NNNNN.extension, extension is png or qoi
+    void start(
+        const std::string& outputDir, const std::string& extension, int frameCount,
+        float frameRate, CameraAnimation animation);
+
+    bool isRecording() const;
+
+    int getFrameIndex() const;
+
+    int getFrameCount() const;
+
+    // move the camera to the time of the current frame
+    void animate(Transform& camera) const;
+
+    // read back the rendered frame, the last frame waits for the encoders and fills the report
+    void capture(GLuint framebuffer, int width, int height);
+
+    const CaptureReport& getReport() const;
+
+private:
+    std::string _outputDir;
+    std::string _extension;
+    int _frameCount = 0;
+    int _frameIndex = 0;
+    float _frameRate = 30.0f;
+    CameraAnimation _animation;
+    bool _recording = false;
+
+    size_t _previousCapacity = 0;
+    std::chrono::time_point<std::chrono::high_resolution_clock> _startTime;
+    CaptureReport _report;
+
+    void finish();
+};
\ No newline at end of file
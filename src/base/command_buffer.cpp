@@ -0,0 +1,246 @@
+#include "command_buffer.h"
+#include "geometry_arena.h"
+#include "gl_state_cache.h"
+#include "render_statistics.h"
+
+// payloads, one per command type
+struct UseProgramCommand {
+    GLuint program;
+};
+
+struct SetUniformIntCommand {
+    GLint location;
+    int value;
+};
+
+struct SetUniformVec3Command {
+    GLint location;
+    glm::vec3 value;
+};
+
+struct SetUniformMat4Command {
+    GLint location;
+    glm::mat4 value;
+};
+
+struct BindUniformBufferRangeCommand {
+    GLuint index;
+    GLuint buffer;
+    uint64_t offset;
+    uint64_t size;
+};
+
+struct BindTextureCommand {
+    int unit;
+    GLenum target;
+    GLuint texture;
+};
+
+struct BindVertexArrayCommand {
+    GLuint vao;
+};
+
+struct SetDepthMaskCommand {
+    uint32_t enable;
+};
+
+struct SetDepthFuncCommand {
+    GLenum func;
+};
+
+struct SetInstanceSourceCommand {
+    GLuint buffer;
+    uint32_t padding;
+    uint64_t offset;
+};
+
+struct DrawArraysCommand {
+    GLenum mode;
+    GLint first;
+    GLsizei count;
+};
+
+struct DrawElementsInstancedCommand {
+    uint32_t count;
+    uint32_t firstIndex;
+    uint32_t instanceCount;
+    int32_t baseVertex;
+};
+
+struct MultiDrawIndirectCommand {
+    GLuint commandBuffer;
+    GLsizei drawCount;
+    uint64_t offset;
+};
+
+template <typename T>
+static T read(const uint8_t*& cursor) {
+    T payload;
+    std::memcpy(&payload, cursor, sizeof(T));
+    cursor += sizeof(T);
+    return payload;
+}
+
+void CommandBuffer::clear() {
+    _data.clear();
+    _commandCount = 0;
+    _drawCount = 0;
+}
+
+bool CommandBuffer::empty() const {
+    return _commandCount == 0;
+}
+
+size_t CommandBuffer::getCommandCount() const {
+    return _commandCount;
+}
+
+size_t CommandBuffer::getDrawCount() const {
+    return _drawCount;
+}
+
+size_t CommandBuffer::getSize() const {
+    return _data.size();
+}
+
+void CommandBuffer::useProgram(GLuint program) {
+    record(CommandType::UseProgram, UseProgramCommand{program});
+}
+
+void CommandBuffer::setUniformInt(GLint location, int value) {
+    record(CommandType::SetUniformInt, SetUniformIntCommand{location, value});
+}
+
+void CommandBuffer::setUniformVec3(GLint location, const glm::vec3& value) {
+    record(CommandType::SetUniformVec3, SetUniformVec3Command{location, value});
+}
+
+void CommandBuffer::setUniformMat4(GLint location, const glm::mat4& value) {
+    record(CommandType::SetUniformMat4, SetUniformMat4Command{location, value});
+}
+
+void CommandBuffer::bindUniformBufferRange(GLuint index, GLuint buffer, size_t offset, size_t size) {
+    record(
+        CommandType::BindUniformBufferRange,
+        BindUniformBufferRangeCommand{index, buffer, offset, size});
+}
+
+void CommandBuffer::bindTexture(int unit, GLenum target, GLuint texture) {
+    record(CommandType::BindTexture, BindTextureCommand{unit, target, texture});
+}
+
+void CommandBuffer::bindVertexArray(GLuint vao) {
+    record(CommandType::BindVertexArray, BindVertexArrayCommand{vao});
+}
+
+void CommandBuffer::setDepthMask(bool enable) {
+    record(CommandType::SetDepthMask, SetDepthMaskCommand{enable ? 1u : 0u});
+}
+
+void CommandBuffer::setDepthFunc(GLenum func) {
+    record(CommandType::SetDepthFunc, SetDepthFuncCommand{func});
+}
+
+void CommandBuffer::setInstanceSource(GLuint buffer, size_t offset) {
+    record(CommandType::SetInstanceSource, SetInstanceSourceCommand{buffer, 0, offset});
+}
+
+void CommandBuffer::drawArrays(GLenum mode, GLint first, GLsizei count) {
+    record(CommandType::DrawArrays, DrawArraysCommand{mode, first, count});
+    ++_drawCount;
+}
+
+void CommandBuffer::drawElementsInstanced(
+    uint32_t count, uint32_t firstIndex, uint32_t instanceCount, int32_t baseVertex) {
+    record(
+        CommandType::DrawElementsInstanced,
+        DrawElementsInstancedCommand{count, firstIndex, instanceCount, baseVertex});
+    ++_drawCount;
+}
+
+void CommandBuffer::multiDrawIndirect(GLuint commandBuffer, size_t offset, GLsizei drawCount) {
+    record(CommandType::MultiDrawIndirect, MultiDrawIndirectCommand{commandBuffer, drawCount, offset});
+    ++_drawCount;
+}
+
+void CommandBuffer::execute() const {
+    GLStateCache& state = GLStateCache::get();
+    GeometryArena& arena = GeometryArena::get();
+    RenderStatistics& statistics = RenderStatistics::get();
+
+    const uint8_t* cursor = _data.data();
+    const uint8_t* end = cursor + _data.size();
+    while (cursor < end) {
+        switch (read<CommandType>(cursor)) {
+        case CommandType::UseProgram:
+            state.useProgram(read<UseProgramCommand>(cursor).program);
+            break;
+        case CommandType::SetUniformInt: {
+            const auto command = read<SetUniformIntCommand>(cursor);
+            glUniform1i(command.location, command.value);
+            statistics.add(RenderCounter::UniformCalls);
+            break;
+        }
+        case CommandType::SetUniformVec3: {
+            const auto command = read<SetUniformVec3Command>(cursor);
+            glUniform3fv(command.location, 1, &command.value[0]);
+            statistics.add(RenderCounter::UniformCalls);
+            break;
+        }
+        case CommandType::SetUniformMat4: {
+            const auto command = read<SetUniformMat4Command>(cursor);
+            glUniformMatrix4fv(command.location, 1, GL_FALSE, &command.value[0][0]);
+            statistics.add(RenderCounter::UniformCalls);
+            break;
+        }
+        case CommandType::BindUniformBufferRange: {
+            const auto command = read<BindUniformBufferRangeCommand>(cursor);
+            glBindBufferRange(
+                GL_UNIFORM_BUFFER, command.index, command.buffer,
+                static_cast<GLintptr>(command.offset), static_cast<GLsizeiptr>(command.size));
+            break;
+        }
+        case CommandType::BindTexture: {
+            const auto command = read<BindTextureCommand>(cursor);
+            state.bindTexture(command.unit, command.target, command.texture);
+            break;
+        }
+        case CommandType::BindVertexArray:
+            state.bindVertexArray(read<BindVertexArrayCommand>(cursor).vao);
+            break;
+        case CommandType::SetDepthMask:
+            state.setDepthMask(read<SetDepthMaskCommand>(cursor).enable != 0);
+            break;
+        case CommandType::SetDepthFunc:
+            state.setDepthFunc(read<SetDepthFuncCommand>(cursor).func);
+            break;
+        case CommandType::SetInstanceSource: {
+            const auto command = read<SetInstanceSourceCommand>(cursor);
+            arena.setInstanceSource(command.buffer, static_cast<size_t>(command.offset));
+            break;
+        }
+        case CommandType::DrawArrays: {
+            const auto command = read<DrawArraysCommand>(cursor);
+            glDrawArrays(command.mode, command.first, command.count);
+            statistics.addDraw(command.mode == GL_TRIANGLES ? command.count / 3 : 0);
+            break;
+        }
+        case CommandType::DrawElementsInstanced: {
+            const auto command = read<DrawElementsInstancedCommand>(cursor);
+            arena.bind();
+            glDrawElementsInstancedBaseVertex(
+                GL_TRIANGLES, static_cast<GLsizei>(command.count), GL_UNSIGNED_INT,
+                (void*)(command.firstIndex * sizeof(uint32_t)),
+                static_cast<GLsizei>(command.instanceCount), command.baseVertex);
+            statistics.addDraw(static_cast<uint64_t>(command.count / 3) * command.instanceCount);
+            break;
+        }
+        case CommandType::MultiDrawIndirect: {
+            const auto command = read<MultiDrawIndirectCommand>(cursor);
+            arena.multiDrawIndirect(
+                command.commandBuffer, static_cast<size_t>(command.offset), command.drawCount);
+            break;
+        }
+        }
+    }
+}
\ No newline at end of file
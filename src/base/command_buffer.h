@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "gl_utility.h"
+
+// gl commands recorded into a linear block of memory and replayed later.
+// recording makes no gl calls, so any thread can record its own buffer while the thread
+// that owns the context replays them in order. the replay goes through GLStateCache and
+// GeometryArena, which drop the binds that are already in place.
+// uniform locations must be looked up beforehand on the gl thread.
+class CommandBuffer {
+public:
+    // forget the commands but keep the memory for the next recording
+    void clear();
+
+    bool empty() const;
+
+    size_t getCommandCount() const;
+
+    size_t getDrawCount() const;
+
+    // bytes used by the recorded commands
+    size_t getSize() const;
+
+    void useProgram(GLuint program);
+
+    void setUniformInt(GLint location, int value);
+
+    void setUniformVec3(GLint location, const glm::vec3& value);
+
+    void setUniformMat4(GLint location, const glm::mat4& value);
+
+    void bindUniformBufferRange(GLuint index, GLuint buffer, size_t offset, size_t size);
+
+    void bindTexture(int unit, GLenum target, GLuint texture);
+
+    void bindVertexArray(GLuint vao);
+
+    void setDepthMask(bool enable);
+
+    void setDepthFunc(GLenum func);
+
+    // the per-instance attribute source of the geometry arena
+    void setInstanceSource(GLuint buffer, size_t offset);
+
+    void drawArrays(GLenum mode, GLint first, GLsizei count);
+
+    // indexed draw from the geometry arena
+    void drawElementsInstanced(
+        uint32_t count, uint32_t firstIndex, uint32_t instanceCount, int32_t baseVertex);
+
+    // indirect draw from the geometry arena
+    void multiDrawIndirect(GLuint commandBuffer, size_t offset, GLsizei drawCount);
+
+    // must be called on the gl thread
+    void execute() const;
+
+private:
+    enum class CommandType : uint32_t {
+        UseProgram,
+        SetUniformInt,
+        SetUniformVec3,
+        SetUniformMat4,
+        BindUniformBufferRange,
+        BindTexture,
+        BindVertexArray,
+        SetDepthMask,
+        SetDepthFunc,
+        SetInstanceSource,
+        DrawArrays,
+        DrawElementsInstanced,
+        MultiDrawIndirect
+    };
+
+    std::vector<uint8_t> _data;
+    size_t _commandCount = 0;
+    size_t _drawCount = 0;
+
+    // the payload is copied behind the type, both padded to 4 bytes
+    template <typename T>
+    void record(CommandType type, const T& payload) {
+        static_assert(sizeof(T) % 4 == 0, "command payloads are padded to 4 bytes");
+
+        const size_t offset = _data.size();
+        _data.resize(offset + sizeof(CommandType) + sizeof(T));
+        std::memcpy(_data.data() + offset, &type, sizeof(CommandType));
+        std::memcpy(_data.data() + offset + sizeof(CommandType), &payload, sizeof(T));
+        ++_commandCount;
+    }
+};
\ No newline at end of file
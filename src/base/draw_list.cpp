@@ -0,0 +1,94 @@
+#include <algorithm>
+#include <array>
+
+#include "draw_list.h"
+
+static uint64_t maskBits(uint32_t value, int bits) {
+    return static_cast<uint64_t>(value) & ((uint64_t(1) << bits) - 1);
+}
+
+uint64_t DrawKey::make(
+    uint32_t pass, uint32_t program, uint32_t texture, uint32_t mesh, float depth) {
+    return (maskBits(pass, passBits) << passShift) | (maskBits(program, programBits) << programShift)
+           | (maskBits(texture, textureBits) << textureShift)
+           | (maskBits(mesh, meshBits) << meshShift)
+           | (maskBits(quantizeDepth(depth), depthBits) << depthShift);
+}
+
+uint32_t DrawKey::quantizeDepth(float depth) {
+    constexpr uint32_t maxBucket = (1u << depthBits) - 1;
+    depth = std::min(std::max(depth, 0.0f), 1.0f);
+    return static_cast<uint32_t>(depth * static_cast<float>(maxBucket));
+}
+
+void DrawList::clear() {
+    _packets.clear();
+}
+
+void DrawList::reserve(size_t capacity) {
+    _packets.reserve(capacity);
+    _scratch.reserve(capacity);
+}
+
+void DrawList::add(uint64_t key, uint32_t index) {
+    _packets.push_back({key, index});
+}
+
+void DrawList::sort() {
+    const size_t count = _packets.size();
+    if (count < 2) {
+        return;
+    }
+
+    // one read pass builds the histograms of all 8 digits
+    std::array<std::array<uint32_t, 256>, 8> histograms{};
+    for (const auto& packet : _packets) {
+        for (int digit = 0; digit < 8; ++digit) {
+            ++histograms[digit][(packet.key >> (digit * 8)) & 0xff];
+        }
+    }
+
+    _scratch.resize(count);
+    DrawPacket* src = _packets.data();
+    DrawPacket* dst = _scratch.data();
+
+    for (int digit = 0; digit < 8; ++digit) {
+        auto& histogram = histograms[digit];
+
+        // skip the digit when every key shares the same byte, e.g. pass or program
+        const uint32_t firstByte = (src[0].key >> (digit * 8)) & 0xff;
+        if (histogram[firstByte] == count) {
+            continue;
+        }
+
+        uint32_t offset = 0;
+        for (auto& bucket : histogram) {
+            const uint32_t n = bucket;
+            bucket = offset;
+            offset += n;
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            const uint32_t byte = (src[i].key >> (digit * 8)) & 0xff;
+            dst[histogram[byte]++] = src[i];
+        }
+
+        std::swap(src, dst);
+    }
+
+    if (src != _packets.data()) {
+        std::copy(src, src + count, _packets.data());
+    }
+}
+
+const std::vector<DrawPacket>& DrawList::getPackets() const {
+    return _packets;
+}
+
+size_t DrawList::size() const {
+    return _packets.size();
+}
+
+bool DrawList::empty() const {
+    return _packets.empty();
+}
\ No newline at end of file
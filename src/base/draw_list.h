@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 64-bit sort key, most significant field first:
+// | pass (4) | program (8) | texture (16) | mesh (16) | depth (20) |
+// fields are only used for ordering, the submit loop compares the real state before changing it,
+// so truncated handles or ids never produce wrong output.
+struct DrawKey {
+    static constexpr int depthBits = 20;
+    static constexpr int meshBits = 16;
+    static constexpr int textureBits = 16;
+    static constexpr int programBits = 8;
+    static constexpr int passBits = 4;
+
+    static constexpr int depthShift = 0;
+    static constexpr int meshShift = depthShift + depthBits;
+    static constexpr int textureShift = meshShift + meshBits;
+    static constexpr int programShift = textureShift + textureBits;
+    static constexpr int passShift = programShift + programBits;
+
+    static uint64_t make(
+        uint32_t pass, uint32_t program, uint32_t texture, uint32_t mesh, float depth);
+
+    // map a normalized depth in [0, 1] to a bucket, near objects get small buckets
+    static uint32_t quantizeDepth(float depth);
+};
+
+struct DrawPacket {
+    uint64_t key;
+    uint32_t index;
+};
+
+class DrawList {
+public:
+    DrawList() = default;
+
+    ~DrawList() = default;
+
+    void clear();
+
+    void reserve(size_t capacity);
+
+    void add(uint64_t key, uint32_t index);
+
+    // stable lsd radix sort by key
+    void sort();
+
+    const std::vector<DrawPacket>& getPackets() const;
+
+    size_t size() const;
+
+    bool empty() const;
+
+private:
+    std::vector<DrawPacket> _packets;
+    std::vector<DrawPacket> _scratch;
+};
\ No newline at end of file
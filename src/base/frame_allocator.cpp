@@ -0,0 +1,134 @@
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+#include "allocation_counter.h"
+#include "frame_allocator.h"
+
+// enough for the ui labels and uniform names of a few thousand objects
+static constexpr size_t initialFrameCapacity = 256 * 1024;
+
+LinearArena::LinearArena(size_t capacity) {
+    addBlock(capacity);
+}
+
+void* LinearArena::allocate(size_t size, size_t alignment) {
+    Block* block = &_blocks.back();
+    size_t offset = (_offset + alignment - 1) & ~(alignment - 1);
+    if (offset + size > block->size) {
+        _fullSize += _offset;
+        addBlock(std::max(block->size * 2, size + alignment));
+        block = &_blocks.back();
+        offset = 0;
+    }
+
+    // the padding counts as used, so the folded block fits the same allocations again
+    _offset = offset + size;
+    return block->data.get() + offset;
+}
+
+void LinearArena::reset() {
+    if (_blocks.size() > 1) {
+        const size_t capacity = _capacity;
+        _blocks.clear();
+        _capacity = 0;
+        addBlock(capacity);
+    }
+
+    _offset = 0;
+    _fullSize = 0;
+}
+
+size_t LinearArena::getUsedSize() const {
+    return _fullSize + _offset;
+}
+
+size_t LinearArena::getCapacity() const {
+    return _capacity;
+}
+
+void LinearArena::addBlock(size_t size) {
+    // new[] rounds the start to the largest fundamental alignment
+    _blocks.push_back({std::make_unique<unsigned char[]>(size), size});
+    _capacity += size;
+    _offset = 0;
+}
+
+FrameAllocator& FrameAllocator::get() {
+    static FrameAllocator allocator;
+    return allocator;
+}
+
+FrameAllocator::FrameAllocator()
+    : _arenas{LinearArena(initialFrameCapacity), LinearArena(initialFrameCapacity)} {}
+
+void FrameAllocator::beginFrame() {
+    _current = 1 - _current;
+    _arenas[_current].reset();
+
+#ifdef SCENE_MODELING_COUNT_ALLOCATIONS
+    const uint64_t count = getHeapAllocationCount();
+    // the allocations before the first frame are the start-up's
+    if (_frameCount > 0) {
+        _lastFrameHeapAllocations = static_cast<int64_t>(count - _heapAllocationsAtFrameStart);
+        _maxHeapAllocations = std::max(_maxHeapAllocations, _lastFrameHeapAllocations);
+        _totalHeapAllocations += _lastFrameHeapAllocations;
+    }
+    _heapAllocationsAtFrameStart = count;
+#endif
+    ++_frameCount;
+}
+
+void* FrameAllocator::allocate(size_t size, size_t alignment) {
+    return _arenas[_current].allocate(size, alignment);
+}
+
+size_t FrameAllocator::getUsedSize() const {
+    return _arenas[_current].getUsedSize();
+}
+
+size_t FrameAllocator::getCapacity() const {
+    return _arenas[0].getCapacity() + _arenas[1].getCapacity();
+}
+
+int64_t FrameAllocator::getLastFrameHeapAllocations() const {
+    return _lastFrameHeapAllocations;
+}
+
+double FrameAllocator::getMeanHeapAllocations() const {
+    if (_frameCount < 2) {
+        return 0.0;
+    }
+    return static_cast<double>(_totalHeapAllocations) / (_frameCount - 1);
+}
+
+int64_t FrameAllocator::getMaxHeapAllocations() const {
+    return _maxHeapAllocations;
+}
+
+const char* frameFormat(const char* format, ...) {
+    char buffer[256];
+
+    va_list args;
+    va_start(args, format);
+    va_list retry;
+    va_copy(retry, args);
+    const int length = std::vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+
+    if (length < 0) {
+        va_end(retry);
+        return "";
+    }
+
+    char* text = static_cast<char*>(FrameAllocator::get().allocate(length + 1, 1));
+    if (static_cast<size_t>(length) < sizeof(buffer)) {
+        std::memcpy(text, buffer, length + 1);
+    } else {
+        std::vsnprintf(text, length + 1, format, retry);
+    }
+    va_end(retry);
+
+    return text;
+}
\ No newline at end of file
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// bump allocator, memory is only released all at once by reset(). when a block runs out another
+// one is chained, reset() folds them into a single block so a steady workload stops allocating
+class LinearArena {
+public:
+    explicit LinearArena(size_t capacity);
+
+    LinearArena(const LinearArena&) = delete;
+
+    LinearArena& operator=(const LinearArena&) = delete;
+
+    // alignment must be a power of two
+    void* allocate(size_t size, size_t alignment);
+
+    void reset();
+
+    // bytes handed out since the last reset, alignment padding included
+    size_t getUsedSize() const;
+
+    size_t getCapacity() const;
+
+private:
+    struct Block {
+        std::unique_ptr<unsigned char[]> data;
+        size_t size;
+    };
+
+    std::vector<Block> _blocks;
+    // offset in the last block
+    size_t _offset = 0;
+    // bytes used in the blocks before the last one
+    size_t _fullSize = 0;
+    size_t _capacity = 0;
+
+    void addBlock(size_t size);
+};
+
+// transient memory of the frames, gl thread only and never from jobs, it has no locking. an
+// allocation stays valid until the end of the frame after the one that made it, so what was
+// recorded for a frame can still be read while the next one is built. destructors are never run.
+class FrameAllocator {
+public:
+    static FrameAllocator& get();
+
+    FrameAllocator(const FrameAllocator&) = delete;
+
+    FrameAllocator& operator=(const FrameAllocator&) = delete;
+
+    // releases the allocations of the frame before last
+    void beginFrame();
+
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    // bytes allocated by the current frame
+    size_t getUsedSize() const;
+
+    // of both frames
+    size_t getCapacity() const;
+
+    // global operator new calls of every thread during the last frame, -1 unless the build
+    // counts them (SCENE_MODELING_COUNT_ALLOCATIONS)
+    int64_t getLastFrameHeapAllocations() const;
+
+    // over the frames since the start, 0 unless the build counts them
+    double getMeanHeapAllocations() const;
+
+    int64_t getMaxHeapAllocations() const;
+
+private:
+    LinearArena _arenas[2];
+    int _current = 0;
+
+    uint64_t _heapAllocationsAtFrameStart = 0;
+    int64_t _lastFrameHeapAllocations = -1;
+    int64_t _maxHeapAllocations = 0;
+    uint64_t _totalHeapAllocations = 0;
+    uint64_t _frameCount = 0;
+
+    FrameAllocator();
+};
+
+// stl adapter over the frame allocator, deallocation is a no-op. a container using it must not
+// outlive the frame after the one it was filled in.
+template <typename T>
+class FrameStlAllocator {
+public:
+    using value_type = T;
+
+    FrameStlAllocator() = default;
+
+    template <typename U>
+    FrameStlAllocator(const FrameStlAllocator<U>&) noexcept {}
+
+    T* allocate(size_t count) {
+        return static_cast<T*>(FrameAllocator::get().allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, size_t) noexcept {}
+
+    template <typename U>
+    bool operator==(const FrameStlAllocator<U>&) const noexcept {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const FrameStlAllocator<U>&) const noexcept {
+        return false;
+    }
+};
+
+template <typename T>
+using FrameVector = std::vector<T, FrameStlAllocator<T>>;
+
+using FrameString = std::basic_string<char, std::char_traits<char>, FrameStlAllocator<char>>;
+
+// printf into frame memory, e.g. uniform names and imgui labels
+const char* frameFormat(const char* format, ...);
\ No newline at end of file
@@ -0,0 +1,222 @@
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+#include "frame_allocator.h"
+#include "frame_statistics.h"
+
+QuantileEstimator::QuantileEstimator(double quantile) : _quantile(quantile) {
+    reset();
+}
+
+void QuantileEstimator::push(double sample) {
+    // the first five samples are the initial marker heights
+    if (_count < 5) {
+        _heights[_count++] = sample;
+        if (_count == 5) {
+            std::sort(_heights, _heights + 5);
+        }
+        return;
+    }
+    ++_count;
+
+    // the cell the sample falls into, the extreme markers follow the extreme samples
+    int cell;
+    if (sample < _heights[0]) {
+        _heights[0] = sample;
+        cell = 0;
+    } else if (sample >= _heights[4]) {
+        _heights[4] = sample;
+        cell = 3;
+    } else {
+        cell = 0;
+        while (sample >= _heights[cell + 1]) {
+            ++cell;
+        }
+    }
+
+    for (int i = cell + 1; i < 5; ++i) {
+        _positions[i] += 1.0;
+    }
+    for (int i = 0; i < 5; ++i) {
+        _desiredPositions[i] += _increments[i];
+    }
+
+    // move the middle markers that drifted a whole position away from where they should be
+    for (int i = 1; i < 4; ++i) {
+        const double offset = _desiredPositions[i] - _positions[i];
+        if ((offset < 1.0 || _positions[i + 1] - _positions[i] <= 1.0)
+            && (offset > -1.0 || _positions[i - 1] - _positions[i] >= -1.0)) {
+            continue;
+        }
+
+        const double d = offset > 0.0 ? 1.0 : -1.0;
+        const double parabolic = _heights[i]
+            + d / (_positions[i + 1] - _positions[i - 1])
+                  * ((_positions[i] - _positions[i - 1] + d) * (_heights[i + 1] - _heights[i])
+                         / (_positions[i + 1] - _positions[i])
+                     + (_positions[i + 1] - _positions[i] - d) * (_heights[i] - _heights[i - 1])
+                           / (_positions[i] - _positions[i - 1]));
+
+        if (_heights[i - 1] < parabolic && parabolic < _heights[i + 1]) {
+            _heights[i] = parabolic;
+        } else {
+            // the parabola overshot a neighbour, fall back to linear
+            const int j = i + static_cast<int>(d);
+            _heights[i] += d * (_heights[j] - _heights[i]) / (_positions[j] - _positions[i]);
+        }
+        _positions[i] += d;
+    }
+}
+
+double QuantileEstimator::get() const {
+    if (_count == 0) {
+        return 0.0;
+    }
+
+    if (_count < 5) {
+        double samples[5];
+        std::copy(_heights, _heights + _count, samples);
+        std::sort(samples, samples + _count);
+        return samples[std::min(static_cast<size_t>(_quantile * _count), _count - 1)];
+    }
+
+    return _heights[2];
+}
+
+void QuantileEstimator::reset() {
+    _count = 0;
+    for (int i = 0; i < 5; ++i) {
+        _heights[i] = 0.0;
+        _positions[i] = i + 1.0;
+    }
+
+    _desiredPositions[0] = 1.0;
+    _desiredPositions[1] = 1.0 + 2.0 * _quantile;
+    _desiredPositions[2] = 1.0 + 4.0 * _quantile;
+    _desiredPositions[3] = 3.0 + 2.0 * _quantile;
+    _desiredPositions[4] = 5.0;
+
+    _increments[0] = 0.0;
+    _increments[1] = _quantile / 2.0;
+    _increments[2] = _quantile;
+    _increments[3] = (1.0 + _quantile) / 2.0;
+    _increments[4] = 1.0;
+}
+
+double FrameTimeSummary::getFramesPerSecond() const {
+    return meanMs > 0.0 ? 1000.0 / meanMs : 0.0;
+}
+
+std::string FrameTimeSummary::toJson() const {
+    std::ostringstream stream;
+    stream << "{\"frames\": " << frameCount << ", \"mean_ms\": " << meanMs << ", \"min_ms\": " << minMs
+           << ", \"max_ms\": " << maxMs << ", \"p50_ms\": " << p50Ms << ", \"p95_ms\": " << p95Ms
+           << ", \"p99_ms\": " << p99Ms << ", \"p99.9_ms\": " << p999Ms
+           << ", \"hitches\": " << hitchCount << ", \"fps\": " << getFramesPerSecond() << "}";
+    return stream.str();
+}
+
+FrameStatistics::FrameStatistics(size_t capacity) : _history(std::max<size_t>(capacity, 1), 0.0f) {}
+
+void FrameStatistics::push(float frameTimeMs) {
+    _history[_next] = frameTimeMs;
+    _next = (_next + 1) % _history.size();
+    _size = std::min(_size + 1, _history.size());
+
+    // judged against the median before this frame, a hitch must not raise its own bar
+    if (_count >= 5 && frameTimeMs > hitchFactor * _p50.get()) {
+        ++_hitchCount;
+    }
+
+    _min = _count == 0 ? frameTimeMs : std::min<double>(_min, frameTimeMs);
+    _max = _count == 0 ? frameTimeMs : std::max<double>(_max, frameTimeMs);
+    _sum += frameTimeMs;
+    ++_count;
+
+    _p50.push(frameTimeMs);
+    _p95.push(frameTimeMs);
+    _p99.push(frameTimeMs);
+    _p999.push(frameTimeMs);
+}
+
+void FrameStatistics::reset() {
+    std::fill(_history.begin(), _history.end(), 0.0f);
+    _next = 0;
+    _size = 0;
+
+    _count = 0;
+    _sum = _min = _max = 0.0;
+    _hitchCount = 0;
+    _p50.reset();
+    _p95.reset();
+    _p99.reset();
+    _p999.reset();
+}
+
+FrameTimeSummary FrameStatistics::getSummary() const {
+    FrameTimeSummary summary;
+    summary.frameCount = _count;
+    summary.meanMs = _count > 0 ? _sum / _count : 0.0;
+    summary.minMs = _min;
+    summary.maxMs = _max;
+    summary.p50Ms = _p50.get();
+    summary.p95Ms = _p95.get();
+    summary.p99Ms = _p99.get();
+    summary.p999Ms = _p999.get();
+    summary.hitchCount = _hitchCount;
+    return summary;
+}
+
+FrameTimeSummary FrameStatistics::getWindowSummary() const {
+    FrameTimeSummary summary;
+    summary.frameCount = _size;
+    if (_size == 0) {
+        return summary;
+    }
+
+    // a partial ring holds its samples in [0, size)
+    FrameVector<float> samples(_history.begin(), _history.begin() + _size);
+    std::sort(samples.begin(), samples.end());
+
+    double sum = 0.0;
+    for (const float sample : samples) {
+        sum += sample;
+    }
+
+    const auto percentile = [&samples](double p) {
+        const size_t rank = static_cast<size_t>(std::ceil(p * samples.size()));
+        return static_cast<double>(samples[std::min(std::max<size_t>(rank, 1), samples.size()) - 1]);
+    };
+
+    summary.meanMs = sum / samples.size();
+    summary.minMs = samples.front();
+    summary.maxMs = samples.back();
+    summary.p50Ms = percentile(0.5);
+    summary.p95Ms = percentile(0.95);
+    summary.p99Ms = percentile(0.99);
+    summary.p999Ms = percentile(0.999);
+    for (const float sample : samples) {
+        if (sample > hitchFactor * summary.p50Ms) {
+            ++summary.hitchCount;
+        }
+    }
+
+    return summary;
+}
+
+const float* FrameStatistics::getHistory() const {
+    return _history.data();
+}
+
+int FrameStatistics::getHistorySize() const {
+    return static_cast<int>(_history.size());
+}
+
+int FrameStatistics::getHistoryOffset() const {
+    return static_cast<int>(_next);
+}
+
+float FrameStatistics::getLastFrameTime() const {
+    return _size == 0 ? 0.0f : _history[(_next + _history.size() - 1) % _history.size()];
+}
\ No newline at end of file
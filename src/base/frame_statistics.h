@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// estimates one quantile of a stream with the P-square algorithm: five markers whose heights are
+// moved along a parabola as samples arrive. O(1) time and memory per sample, no sample is kept.
+class QuantileEstimator {
+public:
+    explicit QuantileEstimator(double quantile);
+
+    void push(double sample);
+
+    double get() const;
+
+    void reset();
+
+private:
+    double _quantile;
+    size_t _count = 0;
+    double _heights[5];
+    double _positions[5];
+    double _desiredPositions[5];
+    double _increments[5];
+};
+
+struct FrameTimeSummary {
+    size_t frameCount = 0;
+    double meanMs = 0.0;
+    double minMs = 0.0;
+    double maxMs = 0.0;
+    double p50Ms = 0.0;
+    double p95Ms = 0.0;
+    double p99Ms = 0.0;
+    double p999Ms = 0.0;
+    // frames slower than hitchFactor times the median
+    size_t hitchCount = 0;
+
+    // frames per second from the mean frame time, not the mean of per frame rates
+    double getFramesPerSecond() const;
+
+    std::string toJson() const;
+};
+
+// frame times in milliseconds. the last capacity frames are kept in a ring for graphs and exact
+// percentiles of the recent window, the whole run is summarized with streaming estimators.
+class FrameStatistics {
+public:
+    static constexpr double hitchFactor = 2.0;
+
+    explicit FrameStatistics(size_t capacity);
+
+    void push(float frameTimeMs);
+
+    void reset();
+
+    // since the last reset, the percentiles are estimates
+    FrameTimeSummary getSummary() const;
+
+    // the frames in the ring, the percentiles are exact
+    FrameTimeSummary getWindowSummary() const;
+
+    // the ring for ImGui::PlotLines, getHistoryOffset() is the oldest sample
+    const float* getHistory() const;
+
+    int getHistorySize() const;
+
+    int getHistoryOffset() const;
+
+    float getLastFrameTime() const;
+
+private:
+    std::vector<float> _history;
+    size_t _next = 0;
+    size_t _size = 0;
+
+    size_t _count = 0;
+    double _sum = 0.0;
+    double _min = 0.0;
+    double _max = 0.0;
+    size_t _hitchCount = 0;
+    QuantileEstimator _p50{0.5};
+    QuantileEstimator _p95{0.95};
+    QuantileEstimator _p99{0.99};
+    QuantileEstimator _p999{0.999};
+};
\ No newline at end of file
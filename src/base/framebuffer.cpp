@@ -1,8 +1,12 @@
 #include "framebuffer.h"
+#include "gl_state_cache.h"
+#include "memory_tracker.h"
+#include "render_statistics.h"
 #include <stdexcept>
 
 Framebuffer::Framebuffer() {
     glGenFramebuffers(1, &_handle);
+    RenderStatistics::get().onCreated(GLObjectType::Framebuffer);
 }
 
 Framebuffer::Framebuffer(Framebuffer&& rhs) noexcept {
@@ -12,31 +16,37 @@ Framebuffer::Framebuffer(Framebuffer&& rhs) noexcept {
 
 Framebuffer::~Framebuffer() {
     if (_handle != 0) {
+        GLStateCache::get().onFramebufferDeleted(_handle);
         glDeleteFramebuffers(1, &_handle);
+        RenderStatistics::get().onDeleted(GLObjectType::Framebuffer);
         _handle = 0;
     }
 }
 
 void Framebuffer::bind() {
-    glBindFramebuffer(GL_FRAMEBUFFER, _handle);
+    GLStateCache::get().bindFramebuffer(GL_FRAMEBUFFER, _handle);
 }
 
 void Framebuffer::unbind() {
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    GLStateCache& state = GLStateCache::get();
+    state.bindFramebuffer(GL_FRAMEBUFFER, state.getDefaultFramebuffer());
 }
 
 void Framebuffer::attachTexture(const Texture& texture, GLenum attachment, int level) {
     glFramebufferTexture(GL_FRAMEBUFFER, attachment, texture.getHandle(), level);
+    MemoryTracker::get().setCategory(texture.getMemoryId(), MemoryCategory::RenderTarget);
 }
 
 void Framebuffer::attachTexture2D(
     const Texture& texture, GLenum attachment, GLenum textarget, int level) {
     glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, textarget, texture.getHandle(), level);
+    MemoryTracker::get().setCategory(texture.getMemoryId(), MemoryCategory::RenderTarget);
 }
 
 void Framebuffer::attachTextureLayer(
     const Texture& texture, GLenum attachment, int layer, int level) {
     glFramebufferTextureLayer(GL_FRAMEBUFFER, attachment, texture.getHandle(), level, layer);
+    MemoryTracker::get().setCategory(texture.getMemoryId(), MemoryCategory::RenderTarget);
 }
 
 GLenum Framebuffer::checkStatus(GLenum target) const {
@@ -1,4 +1,6 @@
 #include "fullscreen_quad.h"
+#include "gl_state_cache.h"
+#include "render_statistics.h"
 
 FullscreenQuad::FullscreenQuad() {
     float _vertices[] = {-1.0f, 1.0f,  0.0f, 1.0f, -1.0f, -1.0f, 0.0f, 0.0f,
@@ -7,11 +9,16 @@ FullscreenQuad::FullscreenQuad() {
 
     glGenVertexArrays(1, &_vao);
     glGenBuffers(1, &_vbo);
+    RenderStatistics& statistics = RenderStatistics::get();
+    statistics.onCreated(GLObjectType::VertexArray);
+    statistics.onCreated(GLObjectType::Buffer);
 
-    glBindVertexArray(_vao);
+    GLStateCache::get().bindVertexArray(_vao);
     glBindBuffer(GL_ARRAY_BUFFER, _vbo);
 
     glBufferData(GL_ARRAY_BUFFER, sizeof(_vertices), &_vertices, GL_STATIC_DRAW);
+    statistics.add(RenderCounter::BufferUploadBytes, sizeof(_vertices));
+    _memory = MemoryTracker::get().add(MemoryCategory::Buffer, sizeof(_vertices));
 
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), 0);
@@ -20,28 +27,40 @@ FullscreenQuad::FullscreenQuad() {
         1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), reinterpret_cast<float*>(2 * sizeof(float)));
 
     glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    GLStateCache::get().bindVertexArray(0);
 }
 
-FullscreenQuad::FullscreenQuad(FullscreenQuad&& rhs) noexcept : _vao(rhs._vao), _vbo(rhs._vbo) {
+FullscreenQuad::FullscreenQuad(FullscreenQuad&& rhs) noexcept
+    : _vao(rhs._vao), _vbo(rhs._vbo), _memory(rhs._memory) {
     rhs._vao = 0;
     rhs._vbo = 0;
+    rhs._memory = MemoryTracker::invalidId;
 }
 
 FullscreenQuad::~FullscreenQuad() {
     if (_vao) {
+        GLStateCache::get().onVertexArrayDeleted(_vao);
         glDeleteVertexArrays(1, &_vao);
+        RenderStatistics::get().onDeleted(GLObjectType::VertexArray);
         _vao = 0;
     }
 
     if (_vbo) {
         glDeleteBuffers(1, &_vbo);
+        RenderStatistics::get().onDeleted(GLObjectType::Buffer);
         _vbo = 0;
     }
+
+    MemoryTracker::get().remove(_memory);
 }
 
 void FullscreenQuad::draw() const {
-    glBindVertexArray(_vao);
+    GLStateCache::get().bindVertexArray(_vao);
     glDrawArrays(GL_TRIANGLES, 0, 6);
-    glBindVertexArray(0);
+    RenderStatistics::get().addDraw(2);
+}
+
+void FullscreenQuad::record(CommandBuffer& commands) const {
+    commands.bindVertexArray(_vao);
+    commands.drawArrays(GL_TRIANGLES, 0, 6);
 }
\ No newline at end of file
@@ -2,7 +2,9 @@
 
 #include <glm/glm.hpp>
 
+#include "command_buffer.h"
 #include "gl_utility.h"
+#include "memory_tracker.h"
 #include "texture.h"
 
 class FullscreenQuad {
@@ -17,7 +19,10 @@ public:
 
     void draw() const;
 
+    void record(CommandBuffer& commands) const;
+
 private:
     GLuint _vao;
     GLuint _vbo;
+    MemoryTracker::Id _memory;
 };
\ No newline at end of file
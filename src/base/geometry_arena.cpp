@@ -0,0 +1,415 @@
+#include <algorithm>
+#include <iterator>
+
+#include "geometry_arena.h"
+#include "gl_state_cache.h"
+#include "instance_data.h"
+#include "render_statistics.h"
+
+void RangeAllocator::reset(uint32_t capacity) {
+    _freeRanges.clear();
+    if (capacity > 0) {
+        _freeRanges[0] = capacity;
+    }
+    _capacity = capacity;
+    _usedSize = 0;
+}
+
+uint32_t RangeAllocator::allocate(uint32_t size) {
+    if (size == 0) {
+        return 0;
+    }
+
+    for (auto iter = _freeRanges.begin(); iter != _freeRanges.end(); ++iter) {
+        if (iter->second < size) {
+            continue;
+        }
+
+        const uint32_t offset = iter->first;
+        const uint32_t remaining = iter->second - size;
+        _freeRanges.erase(iter);
+        if (remaining > 0) {
+            _freeRanges[offset + size] = remaining;
+        }
+
+        _usedSize += size;
+        return offset;
+    }
+
+    return invalidOffset;
+}
+
+void RangeAllocator::free(uint32_t offset, uint32_t size) {
+    if (size == 0) {
+        return;
+    }
+
+    _usedSize -= size;
+    auto next = _freeRanges.lower_bound(offset);
+
+    // merge with the free range right after
+    if (next != _freeRanges.end() && offset + size == next->first) {
+        size += next->second;
+        next = _freeRanges.erase(next);
+    }
+
+    // merge with the free range right before
+    if (next != _freeRanges.begin()) {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == offset) {
+            prev->second += size;
+            return;
+        }
+    }
+
+    _freeRanges[offset] = size;
+}
+
+uint32_t RangeAllocator::getCapacity() const {
+    return _capacity;
+}
+
+uint32_t RangeAllocator::getUsedSize() const {
+    return _usedSize;
+}
+
+uint32_t RangeAllocator::getFragmentedSize() const {
+    uint32_t largest = 0;
+    for (const auto& range : _freeRanges) {
+        largest = std::max(largest, range.second);
+    }
+
+    return _capacity - _usedSize - largest;
+}
+
+static constexpr uint32_t initialVertexCapacity = 1u << 16;
+static constexpr uint32_t initialIndexCapacity = 1u << 18;
+
+// scattered free space below these sizes is not worth a copy of the whole arena
+static constexpr uint32_t minCompactVertexCount = 1u << 14;
+static constexpr uint32_t minCompactIndexCount = 1u << 16;
+
+static uint32_t growCapacity(uint32_t capacity, uint32_t required) {
+    while (capacity < required) {
+        capacity *= 2;
+    }
+
+    return capacity;
+}
+
+static bool isFragmented(const RangeAllocator& allocator, uint32_t minSize) {
+    const uint32_t fragmented = allocator.getFragmentedSize();
+    return fragmented > minSize && fragmented > allocator.getUsedSize() / 2;
+}
+
+GeometryArena& GeometryArena::get() {
+    static GeometryArena arena;
+    return arena;
+}
+
+GeometryArena::Handle GeometryArena::allocate(
+    const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices) {
+    if (_vao == 0) {
+        init();
+    }
+
+    const uint32_t vertexCount = static_cast<uint32_t>(vertices.size());
+    const uint32_t indexCount = static_cast<uint32_t>(indices.size());
+
+    uint32_t baseVertex = _vertexAllocator.allocate(vertexCount);
+    uint32_t firstIndex = _indexAllocator.allocate(indexCount);
+    if (baseVertex == RangeAllocator::invalidOffset || firstIndex == RangeAllocator::invalidOffset) {
+        if (baseVertex != RangeAllocator::invalidOffset) {
+            _vertexAllocator.free(baseVertex, vertexCount);
+        }
+
+        if (firstIndex != RangeAllocator::invalidOffset) {
+            _indexAllocator.free(firstIndex, indexCount);
+        }
+
+        // the rebuild packs the live ranges, so the new range fits into the free tail
+        rebuild(
+            growCapacity(
+                _vertexAllocator.getCapacity(), _vertexAllocator.getUsedSize() + vertexCount),
+            growCapacity(
+                _indexAllocator.getCapacity(), _indexAllocator.getUsedSize() + indexCount));
+        baseVertex = _vertexAllocator.allocate(vertexCount);
+        firstIndex = _indexAllocator.allocate(indexCount);
+    }
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, _vbo);
+    glBufferSubData(
+        GL_COPY_WRITE_BUFFER, baseVertex * sizeof(Vertex), vertexCount * sizeof(Vertex),
+        vertices.data());
+    glBindBuffer(GL_COPY_WRITE_BUFFER, _ebo);
+    glBufferSubData(
+        GL_COPY_WRITE_BUFFER, firstIndex * sizeof(uint32_t), indexCount * sizeof(uint32_t),
+        indices.data());
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    RenderStatistics::get().add(
+        RenderCounter::BufferUploadBytes, vertexCount * sizeof(Vertex) + indexCount * sizeof(uint32_t));
+
+    Handle handle;
+    if (_freeHandles.empty()) {
+        handle = static_cast<Handle>(_ranges.size());
+        _ranges.emplace_back();
+        _rangeMemory.push_back(MemoryTracker::invalidId);
+        _alive.push_back(true);
+    } else {
+        handle = _freeHandles.back();
+        _freeHandles.pop_back();
+        _alive[handle] = true;
+    }
+
+    GeometryRange& range = _ranges[handle];
+    range.baseVertex = baseVertex;
+    range.vertexCount = vertexCount;
+    range.firstIndex = firstIndex;
+    range.indexCount = indexCount;
+
+    _rangeMemory[handle] = MemoryTracker::get().add(
+        MemoryCategory::Buffer, vertexCount * sizeof(Vertex) + indexCount * sizeof(uint32_t));
+    updateFreeMemory();
+
+    return handle;
+}
+
+void GeometryArena::free(Handle handle) {
+    if (handle >= _ranges.size() || !_alive[handle]) {
+        return;
+    }
+
+    const GeometryRange& range = _ranges[handle];
+    _vertexAllocator.free(range.baseVertex, range.vertexCount);
+    _indexAllocator.free(range.firstIndex, range.indexCount);
+
+    MemoryTracker::get().remove(_rangeMemory[handle]);
+    _rangeMemory[handle] = MemoryTracker::invalidId;
+    updateFreeMemory();
+
+    _alive[handle] = false;
+    _freeHandles.push_back(handle);
+}
+
+const GeometryRange& GeometryArena::getRange(Handle handle) const {
+    return _ranges[handle];
+}
+
+bool GeometryArena::supportsMultiDrawIndirect() const {
+    return GLAD_GL_VERSION_4_3 != 0;
+}
+
+void GeometryArena::bind() {
+    GLStateCache::get().bindVertexArray(_vao);
+}
+
+void GeometryArena::setInstanceSource(GLuint buffer, size_t offset) {
+    bind();
+
+    if (buffer == _instanceBuffer && offset == _instanceOffset) {
+        return;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    glVertexAttribIPointer(
+        InstanceData::ObjectIndexLocation, 1, GL_UNSIGNED_INT, sizeof(InstanceData),
+        (void*)(offset + offsetof(InstanceData, objectIndex)));
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    if (_instanceBuffer == 0) {
+        glEnableVertexAttribArray(InstanceData::ObjectIndexLocation);
+        glVertexAttribDivisor(InstanceData::ObjectIndexLocation, 1);
+    }
+
+    _instanceBuffer = buffer;
+    _instanceOffset = offset;
+}
+
+void GeometryArena::draw(Handle handle) {
+    const GeometryRange& range = _ranges[handle];
+
+    bind();
+    glDrawElementsBaseVertex(
+        GL_TRIANGLES, static_cast<GLsizei>(range.indexCount), GL_UNSIGNED_INT,
+        (void*)(range.firstIndex * sizeof(uint32_t)), static_cast<GLint>(range.baseVertex));
+    RenderStatistics::get().addDraw(range.indexCount / 3);
+}
+
+void GeometryArena::drawInstanced(Handle handle, GLsizei instanceCount) {
+    const GeometryRange& range = _ranges[handle];
+
+    bind();
+    glDrawElementsInstancedBaseVertex(
+        GL_TRIANGLES, static_cast<GLsizei>(range.indexCount), GL_UNSIGNED_INT,
+        (void*)(range.firstIndex * sizeof(uint32_t)), instanceCount,
+        static_cast<GLint>(range.baseVertex));
+    RenderStatistics::get().addDraw(static_cast<uint64_t>(range.indexCount / 3) * instanceCount);
+}
+
+void GeometryArena::multiDrawIndirect(GLuint commandBuffer, size_t offset, GLsizei drawCount) {
+    bind();
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+    glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (void*)offset, drawCount, 0);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    // the commands live on the gpu, their triangles are added by whoever filled them
+    RenderStatistics::get().add(RenderCounter::DrawCalls);
+}
+
+void GeometryArena::compact() {
+    if (_vao == 0) {
+        return;
+    }
+
+    if (isFragmented(_vertexAllocator, minCompactVertexCount)
+        || isFragmented(_indexAllocator, minCompactIndexCount)) {
+        rebuild(_vertexAllocator.getCapacity(), _indexAllocator.getCapacity());
+    }
+}
+
+void GeometryArena::release() {
+    if (_vao != 0) {
+        glDeleteVertexArrays(1, &_vao);
+        GLStateCache::get().onVertexArrayDeleted(_vao);
+        RenderStatistics::get().onDeleted(GLObjectType::VertexArray);
+        _vao = 0;
+    }
+
+    if (_vbo != 0) {
+        glDeleteBuffers(1, &_vbo);
+        RenderStatistics::get().onDeleted(GLObjectType::Buffer);
+        _vbo = 0;
+    }
+
+    if (_ebo != 0) {
+        glDeleteBuffers(1, &_ebo);
+        RenderStatistics::get().onDeleted(GLObjectType::Buffer);
+        _ebo = 0;
+    }
+
+    MemoryTracker& tracker = MemoryTracker::get();
+    for (MemoryTracker::Id memory : _rangeMemory) {
+        tracker.remove(memory);
+    }
+    tracker.remove(_freeMemory);
+    _freeMemory = MemoryTracker::invalidId;
+
+    _vertexAllocator.reset(0);
+    _indexAllocator.reset(0);
+    _ranges.clear();
+    _rangeMemory.clear();
+    _alive.clear();
+    _freeHandles.clear();
+    _instanceBuffer = 0;
+    _instanceOffset = 0;
+}
+
+uint32_t GeometryArena::getVertexCapacity() const {
+    return _vertexAllocator.getCapacity();
+}
+
+uint32_t GeometryArena::getIndexCapacity() const {
+    return _indexAllocator.getCapacity();
+}
+
+uint32_t GeometryArena::getUsedVertexCount() const {
+    return _vertexAllocator.getUsedSize();
+}
+
+uint32_t GeometryArena::getUsedIndexCount() const {
+    return _indexAllocator.getUsedSize();
+}
+
+void GeometryArena::init() {
+    glGenVertexArrays(1, &_vao);
+    RenderStatistics::get().onCreated(GLObjectType::VertexArray);
+
+    MemoryOwnerScope owner("geometry arena");
+    _freeMemory = MemoryTracker::get().add(MemoryCategory::Buffer, 0);
+
+    rebuild(initialVertexCapacity, initialIndexCapacity);
+}
+
+void GeometryArena::rebuild(uint32_t vertexCapacity, uint32_t indexCapacity) {
+    GLuint vbo = 0, ebo = 0;
+    glGenBuffers(1, &vbo);
+    glGenBuffers(1, &ebo);
+    RenderStatistics::get().onCreated(GLObjectType::Buffer, 2);
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, vbo);
+    glBufferData(GL_COPY_WRITE_BUFFER, vertexCapacity * sizeof(Vertex), nullptr, GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, ebo);
+    glBufferData(
+        GL_COPY_WRITE_BUFFER, indexCapacity * sizeof(uint32_t), nullptr, GL_STATIC_DRAW);
+
+    // a fresh allocator hands out the live ranges back to back
+    _vertexAllocator.reset(vertexCapacity);
+    _indexAllocator.reset(indexCapacity);
+    for (Handle handle = 0; handle < _ranges.size(); ++handle) {
+        if (!_alive[handle]) {
+            continue;
+        }
+
+        GeometryRange& range = _ranges[handle];
+        const uint32_t baseVertex = _vertexAllocator.allocate(range.vertexCount);
+        const uint32_t firstIndex = _indexAllocator.allocate(range.indexCount);
+
+        glBindBuffer(GL_COPY_READ_BUFFER, _vbo);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, vbo);
+        glCopyBufferSubData(
+            GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, range.baseVertex * sizeof(Vertex),
+            baseVertex * sizeof(Vertex), range.vertexCount * sizeof(Vertex));
+
+        glBindBuffer(GL_COPY_READ_BUFFER, _ebo);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, ebo);
+        glCopyBufferSubData(
+            GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, range.firstIndex * sizeof(uint32_t),
+            firstIndex * sizeof(uint32_t), range.indexCount * sizeof(uint32_t));
+
+        range.baseVertex = baseVertex;
+        range.firstIndex = firstIndex;
+    }
+
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    if (_vbo != 0) {
+        glDeleteBuffers(1, &_vbo);
+        RenderStatistics::get().onDeleted(GLObjectType::Buffer);
+    }
+
+    if (_ebo != 0) {
+        glDeleteBuffers(1, &_ebo);
+        RenderStatistics::get().onDeleted(GLObjectType::Buffer);
+    }
+
+    _vbo = vbo;
+    _ebo = ebo;
+
+    setupVertexBuffers();
+    updateFreeMemory();
+}
+
+void GeometryArena::setupVertexBuffers() {
+    GLStateCache::get().bindVertexArray(_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+    glVertexAttribPointer(
+        0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(
+        1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(
+        2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoord));
+    glEnableVertexAttribArray(2);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _ebo);
+
+    GLStateCache::get().bindVertexArray(0);
+}
+
+void GeometryArena::updateFreeMemory() {
+    const size_t freeVertices = _vertexAllocator.getCapacity() - _vertexAllocator.getUsedSize();
+    const size_t freeIndices = _indexAllocator.getCapacity() - _indexAllocator.getUsedSize();
+    MemoryTracker::get().resize(_freeMemory, freeVertices * sizeof(Vertex) + freeIndices * sizeof(uint32_t));
+}
\ No newline at end of file
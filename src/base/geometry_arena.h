@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "gl_utility.h"
+#include "memory_tracker.h"
+#include "vertex.h"
+
+// first-fit suballocator over [0, capacity), adjacent free ranges are merged on free
+class RangeAllocator {
+public:
+    static constexpr uint32_t invalidOffset = ~0u;
+
+    void reset(uint32_t capacity);
+
+    uint32_t allocate(uint32_t size);
+
+    void free(uint32_t offset, uint32_t size);
+
+    uint32_t getCapacity() const;
+
+    uint32_t getUsedSize() const;
+
+    // free space outside the largest free range, 0 when all free space is contiguous
+    uint32_t getFragmentedSize() const;
+
+private:
+    // offset -> size
+    std::map<uint32_t, uint32_t> _freeRanges;
+    uint32_t _capacity = 0;
+    uint32_t _usedSize = 0;
+};
+
+struct GeometryRange {
+    uint32_t baseVertex = 0;
+    uint32_t vertexCount = 0;
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+};
+
+// layout fixed by glMultiDrawElementsIndirect
+struct DrawElementsIndirectCommand {
+    uint32_t count;
+    uint32_t instanceCount;
+    uint32_t firstIndex;
+    int32_t baseVertex;
+    uint32_t baseInstance;
+};
+
+// one vertex buffer, one index buffer and one vao for the geometry of every mesh.
+// meshes own ranges through handles, the ranges may move when the arena grows or compacts,
+// so they must be looked up again after compact(). the memory tracker sees every range as a
+// buffer of whoever allocated it and the free space as the arena's own.
+class GeometryArena {
+public:
+    using Handle = uint32_t;
+
+    static constexpr Handle invalidHandle = ~0u;
+
+    static GeometryArena& get();
+
+    GeometryArena(const GeometryArena&) = delete;
+
+    GeometryArena& operator=(const GeometryArena&) = delete;
+
+    Handle allocate(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices);
+
+    void free(Handle handle);
+
+    const GeometryRange& getRange(Handle handle) const;
+
+    // gl 4.3 is required for glMultiDrawElementsIndirect and base instances
+    bool supportsMultiDrawIndirect() const;
+
+    void bind();
+
+    // point the per-instance attribute at the InstanceData records starting at offset
+    void setInstanceSource(GLuint buffer, size_t offset);
+
+    void draw(Handle handle);
+
+    void drawInstanced(Handle handle, GLsizei instanceCount);
+
+    // commands are read from commandBuffer at offset, instances are fetched by base instance
+    // so the instance source must start at the first record
+    void multiDrawIndirect(GLuint commandBuffer, size_t offset, GLsizei drawCount);
+
+    // move the live ranges together when too much free space is scattered between them
+    void compact();
+
+    // delete the gl objects, must be called while the context is still alive
+    void release();
+
+    uint32_t getVertexCapacity() const;
+
+    uint32_t getIndexCapacity() const;
+
+    uint32_t getUsedVertexCount() const;
+
+    uint32_t getUsedIndexCount() const;
+
+private:
+    GLuint _vao = 0;
+    GLuint _vbo = 0;
+    GLuint _ebo = 0;
+
+    RangeAllocator _vertexAllocator;
+    RangeAllocator _indexAllocator;
+
+    std::vector<GeometryRange> _ranges;
+    std::vector<MemoryTracker::Id> _rangeMemory;
+    std::vector<bool> _alive;
+    std::vector<Handle> _freeHandles;
+
+    // instance attribute source currently recorded in _vao
+    GLuint _instanceBuffer = 0;
+    size_t _instanceOffset = 0;
+
+    MemoryTracker::Id _freeMemory = MemoryTracker::invalidId;
+
+    GeometryArena() = default;
+
+    void init();
+
+    // copy the live ranges packed into new buffers of the given capacities
+    void rebuild(uint32_t vertexCapacity, uint32_t indexCapacity);
+
+    void setupVertexBuffers();
+
+    void updateFreeMemory();
+};
\ No newline at end of file
@@ -0,0 +1,260 @@
+#include "gl_state_cache.h"
+#include "render_statistics.h"
+
+GLStateCache& GLStateCache::get() {
+    static GLStateCache cache;
+    return cache;
+}
+
+GLStateCache::GLStateCache() {
+    invalidate();
+}
+
+void GLStateCache::beginFrame() {
+    _lastFrameStats = _frameStats;
+    _frameStats = GLStateStats{};
+}
+
+void GLStateCache::invalidate() {
+    _program = unknown;
+    _vao = unknown;
+    _drawFramebuffer = unknown;
+    _readFramebuffer = unknown;
+    _activeUnit = -1;
+    for (auto& unit : _units) {
+        unit.textures.fill(unknown);
+        unit.sampler = unknown;
+    }
+
+    _depthTest = -1;
+    _depthMask = -1;
+    _depthFunc = 0;
+    _blend = -1;
+    _blendSrc = 0;
+    _blendDst = 0;
+}
+
+void GLStateCache::useProgram(GLuint program) {
+    if (filter(_program == program)) {
+        return;
+    }
+
+    glUseProgram(program);
+    _program = program;
+    RenderStatistics::get().add(RenderCounter::ProgramChanges);
+}
+
+void GLStateCache::bindVertexArray(GLuint vao) {
+    if (filter(_vao == vao)) {
+        return;
+    }
+
+    glBindVertexArray(vao);
+    _vao = vao;
+    RenderStatistics::get().add(RenderCounter::VertexArrayChanges);
+}
+
+void GLStateCache::bindFramebuffer(GLenum target, GLuint framebuffer) {
+    switch (target) {
+    case GL_FRAMEBUFFER:
+        if (filter(_drawFramebuffer == framebuffer && _readFramebuffer == framebuffer)) {
+            return;
+        }
+        _drawFramebuffer = framebuffer;
+        _readFramebuffer = framebuffer;
+        break;
+    case GL_DRAW_FRAMEBUFFER:
+        if (filter(_drawFramebuffer == framebuffer)) {
+            return;
+        }
+        _drawFramebuffer = framebuffer;
+        break;
+    case GL_READ_FRAMEBUFFER:
+        if (filter(_readFramebuffer == framebuffer)) {
+            return;
+        }
+        _readFramebuffer = framebuffer;
+        break;
+    default: filter(false); break;
+    }
+
+    glBindFramebuffer(target, framebuffer);
+    RenderStatistics::get().add(RenderCounter::FramebufferChanges);
+}
+
+void GLStateCache::setDefaultFramebuffer(GLuint framebuffer) {
+    _defaultFramebuffer = framebuffer;
+}
+
+GLuint GLStateCache::getDefaultFramebuffer() const {
+    return _defaultFramebuffer;
+}
+
+void GLStateCache::activeTexture(int unit) {
+    if (filter(_activeUnit == unit)) {
+        return;
+    }
+
+    glActiveTexture(GL_TEXTURE0 + unit);
+    _activeUnit = unit;
+}
+
+void GLStateCache::bindTexture(GLenum target, GLuint texture) {
+    const int index = getTargetIndex(target);
+    if (_activeUnit < 0 || _activeUnit >= maxTextureUnits || index < 0) {
+        filter(false);
+        glBindTexture(target, texture);
+        RenderStatistics::get().add(RenderCounter::TextureChanges);
+        return;
+    }
+
+    GLuint& cached = _units[_activeUnit].textures[index];
+    if (filter(cached == texture)) {
+        return;
+    }
+
+    glBindTexture(target, texture);
+    cached = texture;
+    RenderStatistics::get().add(RenderCounter::TextureChanges);
+}
+
+void GLStateCache::bindTexture(int unit, GLenum target, GLuint texture) {
+    // selected even when the binding is in place, unit-less texture calls after a bind(unit)
+    // act on the active unit
+    activeTexture(unit);
+    bindTexture(target, texture);
+}
+
+void GLStateCache::bindSampler(int unit, GLuint sampler) {
+    if (unit < 0 || unit >= maxTextureUnits) {
+        filter(false);
+        glBindSampler(unit, sampler);
+        return;
+    }
+
+    if (filter(_units[unit].sampler == sampler)) {
+        return;
+    }
+
+    glBindSampler(unit, sampler);
+    _units[unit].sampler = sampler;
+}
+
+void GLStateCache::setDepthTest(bool enable) {
+    setCapability(GL_DEPTH_TEST, _depthTest, enable);
+}
+
+void GLStateCache::setDepthMask(bool enable) {
+    if (filter(_depthMask == static_cast<int8_t>(enable))) {
+        return;
+    }
+
+    glDepthMask(enable ? GL_TRUE : GL_FALSE);
+    _depthMask = static_cast<int8_t>(enable);
+}
+
+void GLStateCache::setDepthFunc(GLenum func) {
+    if (filter(_depthFunc == func)) {
+        return;
+    }
+
+    glDepthFunc(func);
+    _depthFunc = func;
+}
+
+void GLStateCache::setBlend(bool enable) {
+    setCapability(GL_BLEND, _blend, enable);
+}
+
+void GLStateCache::setBlendFunc(GLenum srcFactor, GLenum dstFactor) {
+    if (filter(_blendSrc == srcFactor && _blendDst == dstFactor)) {
+        return;
+    }
+
+    glBlendFunc(srcFactor, dstFactor);
+    _blendSrc = srcFactor;
+    _blendDst = dstFactor;
+}
+
+void GLStateCache::onProgramDeleted(GLuint program) {
+    // a deleted program stays current until it is replaced, so don't trust the name anymore
+    if (_program == program) {
+        _program = unknown;
+    }
+}
+
+void GLStateCache::onVertexArrayDeleted(GLuint vao) {
+    if (_vao == vao) {
+        _vao = 0;
+    }
+}
+
+void GLStateCache::onFramebufferDeleted(GLuint framebuffer) {
+    if (_drawFramebuffer == framebuffer) {
+        _drawFramebuffer = 0;
+    }
+
+    if (_readFramebuffer == framebuffer) {
+        _readFramebuffer = 0;
+    }
+}
+
+void GLStateCache::onTextureDeleted(GLuint texture) {
+    for (auto& unit : _units) {
+        for (auto& bound : unit.textures) {
+            if (bound == texture) {
+                bound = 0;
+            }
+        }
+    }
+}
+
+void GLStateCache::onSamplerDeleted(GLuint sampler) {
+    for (auto& unit : _units) {
+        if (unit.sampler == sampler) {
+            unit.sampler = 0;
+        }
+    }
+}
+
+const GLStateStats& GLStateCache::getFrameStats() const {
+    return _frameStats;
+}
+
+const GLStateStats& GLStateCache::getLastFrameStats() const {
+    return _lastFrameStats;
+}
+
+int GLStateCache::getTargetIndex(GLenum target) {
+    switch (target) {
+    case GL_TEXTURE_2D: return Texture2DTarget;
+    case GL_TEXTURE_2D_ARRAY: return Texture2DArrayTarget;
+    case GL_TEXTURE_CUBE_MAP: return TextureCubemapTarget;
+    case GL_TEXTURE_BUFFER: return TextureBufferTarget;
+    }
+
+    return -1;
+}
+
+bool GLStateCache::filter(bool redundant) {
+    if (redundant) {
+        ++_frameStats.skipped;
+    } else {
+        ++_frameStats.issued;
+    }
+
+    return redundant;
+}
+
+void GLStateCache::setCapability(GLenum cap, int8_t& cached, bool enable) {
+    if (filter(cached == static_cast<int8_t>(enable))) {
+        return;
+    }
+
+    if (enable) {
+        glEnable(cap);
+    } else {
+        glDisable(cap);
+    }
+    cached = static_cast<int8_t>(enable);
+}
\ No newline at end of file
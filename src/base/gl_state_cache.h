@@ -0,0 +1,118 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "gl_utility.h"
+
+struct GLStateStats {
+    uint32_t issued = 0;
+    uint32_t skipped = 0;
+};
+
+// shadow copy of the GL state touched by the wrappers, redundant changes are filtered out
+// before they reach the driver. code that changes these states with raw gl calls must either
+// restore them or call invalidate() afterwards.
+class GLStateCache {
+public:
+    static constexpr int maxTextureUnits = 32;
+
+    static GLStateCache& get();
+
+    GLStateCache(const GLStateCache&) = delete;
+
+    GLStateCache& operator=(const GLStateCache&) = delete;
+
+    void beginFrame();
+
+    void invalidate();
+
+    void useProgram(GLuint program);
+
+    void bindVertexArray(GLuint vao);
+
+    void bindFramebuffer(GLenum target, GLuint framebuffer);
+
+    // the framebuffer that stands in for the window, 0 unless rendering offscreen
+    void setDefaultFramebuffer(GLuint framebuffer);
+
+    GLuint getDefaultFramebuffer() const;
+
+    void activeTexture(int unit);
+
+    // bind to the currently active texture unit
+    void bindTexture(GLenum target, GLuint texture);
+
+    // leaves unit active, like glActiveTexture then glBindTexture
+    void bindTexture(int unit, GLenum target, GLuint texture);
+
+    void bindSampler(int unit, GLuint sampler);
+
+    void setDepthTest(bool enable);
+
+    void setDepthMask(bool enable);
+
+    void setDepthFunc(GLenum func);
+
+    void setBlend(bool enable);
+
+    void setBlendFunc(GLenum srcFactor, GLenum dstFactor);
+
+    void onProgramDeleted(GLuint program);
+
+    void onVertexArrayDeleted(GLuint vao);
+
+    void onFramebufferDeleted(GLuint framebuffer);
+
+    void onTextureDeleted(GLuint texture);
+
+    void onSamplerDeleted(GLuint sampler);
+
+    // counters of the frame in progress
+    const GLStateStats& getFrameStats() const;
+
+    // counters of the last completed frame
+    const GLStateStats& getLastFrameStats() const;
+
+private:
+    static constexpr GLuint unknown = ~0u;
+
+    enum TextureTarget {
+        Texture2DTarget = 0,
+        Texture2DArrayTarget,
+        TextureCubemapTarget,
+        TextureBufferTarget,
+        TextureTargetCount
+    };
+
+    struct TextureUnit {
+        std::array<GLuint, TextureTargetCount> textures;
+        GLuint sampler;
+    };
+
+    GLuint _program = unknown;
+    GLuint _vao = unknown;
+    GLuint _drawFramebuffer = unknown;
+    GLuint _readFramebuffer = unknown;
+    GLuint _defaultFramebuffer = 0;
+    int _activeUnit = -1;
+    std::array<TextureUnit, maxTextureUnits> _units;
+
+    int8_t _depthTest = -1;
+    int8_t _depthMask = -1;
+    GLenum _depthFunc = 0;
+    int8_t _blend = -1;
+    GLenum _blendSrc = 0;
+    GLenum _blendDst = 0;
+
+    GLStateStats _frameStats;
+    GLStateStats _lastFrameStats;
+
+    GLStateCache();
+
+    static int getTargetIndex(GLenum target);
+
+    bool filter(bool redundant);
+
+    void setCapability(GLenum cap, int8_t& cached, bool enable);
+};
\ No newline at end of file
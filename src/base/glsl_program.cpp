@@ -7,22 +7,27 @@
 #include <glm/ext.hpp>
 
 #include "glsl_program.h"
+#include "gl_state_cache.h"
+#include "render_statistics.h"
 
 GLSLProgram::GLSLProgram() {
     _handle = glCreateProgram();
     if (_handle == 0) {
         throw std::runtime_error("create glsl program failure");
     }
+    RenderStatistics::get().onCreated(GLObjectType::Program);
 }
 
 GLSLProgram::GLSLProgram(GLSLProgram&& rhs) noexcept
     : _handle(rhs._handle), _vertexShaders(std::move(rhs._vertexShaders)),
       _geometryShaders(std::move(rhs._geometryShaders)),
-      _fragmentShaders(std::move(rhs._fragmentShaders)) {
+      _fragmentShaders(std::move(rhs._fragmentShaders)),
+      _computeShaders(std::move(rhs._computeShaders)) {
     rhs._handle = 0;
     rhs._vertexShaders.clear();
     rhs._geometryShaders.clear();
     rhs._fragmentShaders.clear();
+    rhs._computeShaders.clear();
 }
 
 GLSLProgram::~GLSLProgram() {
@@ -38,8 +43,14 @@ GLSLProgram::~GLSLProgram() {
         glDeleteShader(fragmentShader);
     }
 
+    for (const auto computeShader : _computeShaders) {
+        glDeleteShader(computeShader);
+    }
+
     if (_handle) {
+        GLStateCache::get().onProgramDeleted(_handle);
         glDeleteProgram(_handle);
+        RenderStatistics::get().onDeleted(GLObjectType::Program);
         _handle = 0;
     }
 }
@@ -62,6 +73,12 @@ void GLSLProgram::attachFragmentShader(const std::string& code) {
     _fragmentShaders.push_back(fragmentShader);
 }
 
+void GLSLProgram::attachComputeShader(const std::string& code) {
+    GLuint computeShader = createShader(code, GL_COMPUTE_SHADER);
+    glAttachShader(_handle, computeShader);
+    _computeShaders.push_back(computeShader);
+}
+
 void GLSLProgram::attachVertexShaderFromFile(const std::string& filePath) {
     const std::string& code = readFile(filePath);
     try {
@@ -92,6 +109,16 @@ void GLSLProgram::attachFragmentShaderFromFile(const std::string& filePath) {
     }
 }
 
+void GLSLProgram::attachComputeShaderFromFile(const std::string& filePath) {
+    const std::string& code = readFile(filePath);
+    try {
+        attachComputeShader(code);
+    } catch (const std::runtime_error&) {
+        std::cerr << "Compile " << filePath << " error" << std::endl;
+        throw;
+    }
+}
+
 void GLSLProgram::setTransformFeedbackVaryings(
     const std::vector<const char*>& varyings, GLenum bufferMode) {
     glTransformFeedbackVaryings(
@@ -111,11 +138,15 @@ void GLSLProgram::link() {
 }
 
 void GLSLProgram::use() {
-    glUseProgram(_handle);
+    GLStateCache::get().useProgram(_handle);
 }
 
 void GLSLProgram::unuse() {
-    glUseProgram(0);
+    GLStateCache::get().useProgram(0);
+}
+
+GLuint GLSLProgram::getHandle() const {
+    return _handle;
 }
 
 int GLSLProgram::getUniformBlockSize(const std::string& name) const {
@@ -153,94 +184,113 @@ int GLSLProgram::getUniformBlockVariableOffset(const std::string& name) const {
     return offset;
 }
 
-void GLSLProgram::setUniformBool(const std::string& name, bool value) const {
-    GLint location = glGetUniformLocation(_handle, name.c_str());
+GLint GLSLProgram::getUniformLocation(const char* name) const {
+    GLint location = glGetUniformLocation(_handle, name);
+    if (location == -1) {
+        std::cerr << "find uniform " << name << " location failure" << std::endl;
+    }
+
+    return location;
+}
+
+void GLSLProgram::setUniformBool(const char* name, bool value) const {
+    GLint location = glGetUniformLocation(_handle, name);
     if (location == -1) {
-        std::cerr << "find uniform " + name + " location failure" << std::endl;
+        std::cerr << "find uniform " << name << " location failure" << std::endl;
     }
 
     glUniform1i(location, static_cast<int>(value));
+    RenderStatistics::get().add(RenderCounter::UniformCalls);
 }
 
-void GLSLProgram::setUniformInt(const std::string& name, int value) const {
-    GLint location = glGetUniformLocation(_handle, name.c_str());
+void GLSLProgram::setUniformInt(const char* name, int value) const {
+    GLint location = glGetUniformLocation(_handle, name);
     if (location == -1) {
-        std::cerr << "find uniform " + name + " location failure" << std::endl;
+        std::cerr << "find uniform " << name << " location failure" << std::endl;
     }
 
     glUniform1i(location, value);
+    RenderStatistics::get().add(RenderCounter::UniformCalls);
 }
 
-void GLSLProgram::setUniformUint(const std::string& name, uint32_t value) const {
-    GLint location = glGetUniformLocation(_handle, name.c_str());
+void GLSLProgram::setUniformUint(const char* name, uint32_t value) const {
+    GLint location = glGetUniformLocation(_handle, name);
     if (location == -1) {
-        std::cerr << "find uniform " + name + " location failure" << std::endl;
+        std::cerr << "find uniform " << name << " location failure" << std::endl;
     }
 
     glUniform1ui(location, value);
+    RenderStatistics::get().add(RenderCounter::UniformCalls);
 }
 
-void GLSLProgram::setUniformFloat(const std::string& name, float value) const {
-    GLint location = glGetUniformLocation(_handle, name.c_str());
+void GLSLProgram::setUniformFloat(const char* name, float value) const {
+    GLint location = glGetUniformLocation(_handle, name);
     if (location == -1) {
-        std::cerr << "find uniform " + name + " location failure" << std::endl;
+        std::cerr << "find uniform " << name << " location failure" << std::endl;
     }
 
     glUniform1f(location, value);
+    RenderStatistics::get().add(RenderCounter::UniformCalls);
 }
 
-void GLSLProgram::setUniformVec2(const std::string& name, const glm::vec2& v2) const {
-    GLint location = glGetUniformLocation(_handle, name.c_str());
+void GLSLProgram::setUniformVec2(const char* name, const glm::vec2& v2) const {
+    GLint location = glGetUniformLocation(_handle, name);
     if (location == -1) {
-        std::cerr << "find uniform " + name + " location failure" << std::endl;
+        std::cerr << "find uniform " << name << " location failure" << std::endl;
     }
 
     glUniform2fv(location, 1, glm::value_ptr(v2));
+    RenderStatistics::get().add(RenderCounter::UniformCalls);
 }
 
-void GLSLProgram::setUniformVec3(const std::string& name, const glm::vec3& v3) const {
-    GLint location = glGetUniformLocation(_handle, name.c_str());
+void GLSLProgram::setUniformVec3(const char* name, const glm::vec3& v3) const {
+    GLint location = glGetUniformLocation(_handle, name);
     if (location == -1) {
-        std::cerr << "find uniform " + name + " location failure" << std::endl;
+        std::cerr << "find uniform " << name << " location failure" << std::endl;
     }
 
     glUniform3fv(location, 1, glm::value_ptr(v3));
+    RenderStatistics::get().add(RenderCounter::UniformCalls);
 }
 
-void GLSLProgram::setUniformVec4(const std::string& name, const glm::vec4& v4) const {
-    GLint location = glGetUniformLocation(_handle, name.c_str());
+void GLSLProgram::setUniformVec4(const char* name, const glm::vec4& v4) const {
+    GLint location = glGetUniformLocation(_handle, name);
     if (location == -1) {
-        std::cerr << "find uniform " + name + " location failure" << std::endl;
+        std::cerr << "find uniform " << name << " location failure" << std::endl;
     }
 
     glUniform4fv(location, 1, glm::value_ptr(v4));
+    RenderStatistics::get().add(RenderCounter::UniformCalls);
 }
 
-void GLSLProgram::setUniformMat2(const std::string& name, const glm::mat2& mat2) const {
-    GLint location = glGetUniformLocation(_handle, name.c_str());
+void GLSLProgram::setUniformMat2(const char* name, const glm::mat2& mat2) const {
+    GLint location = glGetUniformLocation(_handle, name);
     if (location == -1) {
-        std::cerr << "find uniform " + name + " location failure" << std::endl;
+        std::cerr << "find uniform " << name << " location failure" << std::endl;
     }
 
     glUniformMatrix2fv(location, 1, GL_FALSE, glm::value_ptr(mat2));
+    RenderStatistics::get().add(RenderCounter::UniformCalls);
 }
 
-void GLSLProgram::setUniformMat3(const std::string& name, const glm::mat3& mat3) const {
-    GLint location = glGetUniformLocation(_handle, name.c_str());
+void GLSLProgram::setUniformMat3(const char* name, const glm::mat3& mat3) const {
+    GLint location = glGetUniformLocation(_handle, name);
     if (location == -1) {
-        std::cerr << "find uniform " + name + " location failure" << std::endl;
+        std::cerr << "find uniform " << name << " location failure" << std::endl;
     }
 
     glUniformMatrix3fv(location, 1, GL_FALSE, glm::value_ptr(mat3));
+    RenderStatistics::get().add(RenderCounter::UniformCalls);
 }
 
-void GLSLProgram::setUniformMat4(const std::string& name, const glm::mat4& mat4) const {
-    GLint location = glGetUniformLocation(_handle, name.c_str());
+void GLSLProgram::setUniformMat4(const char* name, const glm::mat4& mat4) const {
+    GLint location = glGetUniformLocation(_handle, name);
     if (location == -1) {
-        std::cerr << "find uniform " + name + " location failure" << std::endl;
+        std::cerr << "find uniform " << name << " location failure" << std::endl;
     }
 
     glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(mat4));
+    RenderStatistics::get().add(RenderCounter::UniformCalls);
 }
 
 void GLSLProgram::setUniformBlockBinding(const std::string& name, uint32_t binding) const {
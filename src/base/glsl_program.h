@@ -21,12 +21,16 @@ public:
 
     void attachFragmentShader(const std::string& code);
 
+    void attachComputeShader(const std::string& code);
+
     void attachVertexShaderFromFile(const std::string& filePath);
 
     void attachGeometryShaderFromFile(const std::string& filePath);
 
     void attachFragmentShaderFromFile(const std::string& filePath);
 
+    void attachComputeShaderFromFile(const std::string& filePath);
+
     void setTransformFeedbackVaryings(const std::vector<const char*>& varyings, GLenum bufferMode);
 
     void link();
@@ -35,31 +39,36 @@ public:
 
     void unuse();
 
+    GLuint getHandle() const;
+
+    // -1 with an error message when the uniform is missing
+    GLint getUniformLocation(const char* name) const;
+
     int getUniformBlockSize(const std::string& name) const;
 
     int getUniformBlockIndex(const std::string& name) const;
 
     int getUniformBlockVariableOffset(const std::string& name) const;
 
-    void setUniformBool(const std::string& name, bool value) const;
+    void setUniformBool(const char* name, bool value) const;
 
-    void setUniformInt(const std::string& name, int value) const;
+    void setUniformInt(const char* name, int value) const;
 
-    void setUniformUint(const std::string& name, uint32_t value) const;
+    void setUniformUint(const char* name, uint32_t value) const;
 
-    void setUniformFloat(const std::string& name, float value) const;
+    void setUniformFloat(const char* name, float value) const;
 
-    void setUniformVec2(const std::string& name, const glm::vec2& v2) const;
+    void setUniformVec2(const char* name, const glm::vec2& v2) const;
 
-    void setUniformVec3(const std::string& name, const glm::vec3& v3) const;
+    void setUniformVec3(const char* name, const glm::vec3& v3) const;
 
-    void setUniformVec4(const std::string& name, const glm::vec4& v4) const;
+    void setUniformVec4(const char* name, const glm::vec4& v4) const;
 
-    void setUniformMat2(const std::string& name, const glm::mat2& mat2) const;
+    void setUniformMat2(const char* name, const glm::mat2& mat2) const;
 
-    void setUniformMat3(const std::string& name, const glm::mat3& mat3) const;
+    void setUniformMat3(const char* name, const glm::mat3& mat3) const;
 
-    void setUniformMat4(const std::string& name, const glm::mat4& mat4) const;
+    void setUniformMat4(const char* name, const glm::mat4& mat4) const;
 
     void setUniformBlockBinding(const std::string& name, uint32_t binding) const;
 
@@ -72,6 +81,8 @@ private:
 
     std::vector<GLuint> _fragmentShaders;
 
+    std::vector<GLuint> _computeShaders;
+
     static std::string readFile(const std::string& filePath);
 
     static GLuint createShader(const std::string& code, GLenum shaderType);
@@ -0,0 +1,178 @@
+#include <algorithm>
+
+#include "frame_allocator.h"
+#include "gl_state_cache.h"
+#include "gpu_culler.h"
+#include "instance_data.h"
+#include "memory_tracker.h"
+#include "render_statistics.h"
+
+static constexpr GLuint cullGroupSize = 64;
+static constexpr GLuint hiZGroupSize = 8;
+
+glm::vec4 CullObject::getBoundingSphere(const BoundingBox& bbox, const glm::mat4& modelMatrix) {
+    const glm::vec3 center = glm::vec3(modelMatrix * glm::vec4((bbox.min + bbox.max) * 0.5f, 1.0f));
+
+    // the largest axis scale bounds the stretched sphere
+    const float scale = std::max(
+        {glm::length(glm::vec3(modelMatrix[0])), glm::length(glm::vec3(modelMatrix[1])),
+         glm::length(glm::vec3(modelMatrix[2]))});
+    const float radius = glm::length((bbox.max - bbox.min) * 0.5f) * scale;
+
+    return glm::vec4(center, radius);
+}
+
+GPUCuller::GPUCuller(const std::string& cullShaderPath, const std::string& hiZShaderPath) {
+    _cullShader.reset(new GLSLProgram);
+    _cullShader->attachComputeShaderFromFile(cullShaderPath);
+    _cullShader->link();
+
+    _hiZShader.reset(new GLSLProgram);
+    _hiZShader->attachComputeShaderFromFile(hiZShaderPath);
+    _hiZShader->link();
+
+    glGenBuffers(1, &_culledInstanceBuffer);
+    RenderStatistics::get().onCreated(GLObjectType::Buffer);
+    _culledInstanceMemory = MemoryTracker::get().add(MemoryCategory::Buffer, 0);
+}
+
+GPUCuller::~GPUCuller() {
+    if (_culledInstanceBuffer != 0) {
+        glDeleteBuffers(1, &_culledInstanceBuffer);
+        RenderStatistics::get().onDeleted(GLObjectType::Buffer);
+        _culledInstanceBuffer = 0;
+    }
+
+    MemoryTracker::get().remove(_culledInstanceMemory);
+}
+
+bool GPUCuller::isSupported() {
+    return GLAD_GL_VERSION_4_3 != 0;
+}
+
+void GPUCuller::cull(
+    const std::vector<CullObject>& objects, GLuint instanceBuffer, GLuint commandBuffer,
+    const Frustum& frustum, bool useHiZ) {
+    if (objects.empty()) {
+        return;
+    }
+
+    _objectBuffer.upload(objects.data(), objects.size() * sizeof(CullObject));
+    reserveCulledInstances(objects.size() * sizeof(InstanceData));
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, _objectBuffer.getHandle());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, instanceBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, _culledInstanceBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, commandBuffer);
+
+    _cullShader->use();
+    _cullShader->setUniformUint("objectCount", static_cast<uint32_t>(objects.size()));
+    for (int i = 0; i < 6; ++i) {
+        const Plane& plane = frustum.planes[i];
+        _cullShader->setUniformVec4(
+            frameFormat("frustumPlanes[%d]", i),
+            glm::vec4(plane.normal, plane.signedDistance));
+    }
+
+    const bool hiZ = useHiZ && _hiZValid;
+    _cullShader->setUniformBool("useHiZ", hiZ);
+    if (hiZ) {
+        _hiZ->bind(0);
+        _cullShader->setUniformInt("hiZ", 0);
+        _cullShader->setUniformInt("hiZLevels", _hiZLevels);
+        _cullShader->setUniformVec2("hiZSize", glm::vec2(_hiZWidth, _hiZHeight));
+        _cullShader->setUniformMat4("hiZView", _hiZView);
+        _cullShader->setUniformMat4("hiZProjection", _hiZProjection);
+    }
+
+    const GLuint groups = (static_cast<GLuint>(objects.size()) + cullGroupSize - 1) / cullGroupSize;
+    glDispatchCompute(groups, 1, 1);
+
+    // the commands are consumed by indirect draws and the instances as vertex attributes
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+
+    for (GLuint binding = 0; binding < 4; ++binding) {
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, 0);
+    }
+}
+
+void GPUCuller::buildHiZ(
+    const Texture2D& depthMap, int width, int height, const glm::mat4& view,
+    const glm::mat4& projection) {
+    if (_hiZ == nullptr || width != _hiZWidth || height != _hiZHeight) {
+        createHiZ(width, height);
+    }
+
+    _hiZShader->use();
+
+    int levelWidth = width, levelHeight = height;
+    for (int level = 0; level < _hiZLevels; ++level) {
+        if (level == 0) {
+            depthMap.bind(0);
+            _hiZShader->setUniformBool("copyDepth", true);
+            _hiZShader->setUniformInt("depthMap", 0);
+        } else {
+            glBindImageTexture(0, _hiZ->getHandle(), level - 1, GL_FALSE, 0, GL_READ_ONLY, GL_R32F);
+            _hiZShader->setUniformBool("copyDepth", false);
+        }
+        glBindImageTexture(1, _hiZ->getHandle(), level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+
+        glDispatchCompute(
+            (levelWidth + hiZGroupSize - 1) / hiZGroupSize,
+            (levelHeight + hiZGroupSize - 1) / hiZGroupSize, 1);
+        glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+
+        levelWidth = std::max(levelWidth / 2, 1);
+        levelHeight = std::max(levelHeight / 2, 1);
+    }
+
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+
+    _hiZView = view;
+    _hiZProjection = projection;
+    _hiZValid = true;
+}
+
+void GPUCuller::invalidateHiZ() {
+    _hiZValid = false;
+}
+
+GLuint GPUCuller::getCulledInstanceBuffer() const {
+    return _culledInstanceBuffer;
+}
+
+void GPUCuller::reserveCulledInstances(size_t size) {
+    if (size <= _culledInstanceCapacity) {
+        return;
+    }
+
+    _culledInstanceCapacity = std::max(size, _culledInstanceCapacity * 2);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _culledInstanceBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, _culledInstanceCapacity, nullptr, GL_DYNAMIC_COPY);
+    MemoryTracker::get().resize(_culledInstanceMemory, _culledInstanceCapacity);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+void GPUCuller::createHiZ(int width, int height) {
+    _hiZWidth = width;
+    _hiZHeight = height;
+    _hiZLevels = 1;
+    for (int size = std::max(width, height); size > 1; size /= 2) {
+        ++_hiZLevels;
+    }
+
+    // immutable storage, glBindImageTexture needs every level to be complete
+    MemoryOwnerScope owner("gpu culler");
+    _hiZ.reset(new Texture2D);
+    _hiZ->bind();
+    glTexStorage2D(GL_TEXTURE_2D, _hiZLevels, GL_R32F, width, height);
+    // the mip chain adds a third
+    _hiZ->setMemorySize(MemoryTracker::getTexelSize(GL_R32F) * width * height * 4 / 3);
+    _hiZ->setParamterInt(GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+    _hiZ->setParamterInt(GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    _hiZ->setParamterInt(GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    _hiZ->setParamterInt(GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    _hiZ->unbind();
+
+    _hiZValid = false;
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "bounding_box.h"
+#include "frustum.h"
+#include "glsl_program.h"
+#include "stream_buffer.h"
+#include "texture2d.h"
+
+// per-object input of shader/gpu_cull.comp
+struct CullObject {
+    // world space bounding sphere, xyz is the center and w the radius
+    glm::vec4 sphere;
+    // index of the indirect command drawing the object
+    uint32_t command;
+    uint32_t padding[3];
+
+    static glm::vec4 getBoundingSphere(const BoundingBox& bbox, const glm::mat4& modelMatrix);
+};
+
+static_assert(sizeof(CullObject) == 32, "CullObject must match the std430 layout");
+
+// frustum and hi-z occlusion culling on the gpu, requires gl 4.3 compute shaders.
+// the results are written into indirect commands, so nothing is read back to the cpu.
+class GPUCuller {
+public:
+    GPUCuller(const std::string& cullShaderPath, const std::string& hiZShaderPath);
+
+    GPUCuller(const GPUCuller&) = delete;
+
+    ~GPUCuller();
+
+    static bool isSupported();
+
+    // objects[i] belongs to the i-th InstanceData record in instanceBuffer. each command must
+    // reserve records for all its objects starting at baseInstance and have a zero instanceCount,
+    // the visible records are packed into getCulledInstanceBuffer() and counted in the commands.
+    void cull(
+        const std::vector<CullObject>& objects, GLuint instanceBuffer, GLuint commandBuffer,
+        const Frustum& frustum, bool useHiZ);
+
+    // build the depth pyramid used by the next cull() from the depth of the finished frame
+    void buildHiZ(
+        const Texture2D& depthMap, int width, int height, const glm::mat4& view,
+        const glm::mat4& projection);
+
+    void invalidateHiZ();
+
+    GLuint getCulledInstanceBuffer() const;
+
+private:
+    std::unique_ptr<GLSLProgram> _cullShader;
+    std::unique_ptr<GLSLProgram> _hiZShader;
+
+    StreamBuffer _objectBuffer{GL_SHADER_STORAGE_BUFFER};
+
+    GLuint _culledInstanceBuffer = 0;
+    size_t _culledInstanceCapacity = 0;
+    MemoryTracker::Id _culledInstanceMemory = MemoryTracker::invalidId;
+
+    std::unique_ptr<Texture2D> _hiZ;
+    int _hiZWidth = 0;
+    int _hiZHeight = 0;
+    int _hiZLevels = 0;
+    bool _hiZValid = false;
+    glm::mat4 _hiZView = glm::mat4(1.0f);
+    glm::mat4 _hiZProjection = glm::mat4(1.0f);
+
+    void reserveCulledInstances(size_t size);
+
+    void createHiZ(int width, int height);
+};
\ No newline at end of file
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstdint>
+
+// per-instance vertex attribute of the geometry pass, see shader/geometry.vert.
+// everything else about the object is looked up in the ObjectDataBuffer.
+struct InstanceData {
+    uint32_t objectIndex;
+
+    enum AttributeLocation { ObjectIndexLocation = 3 };
+};
+
+static_assert(sizeof(InstanceData) == 4, "InstanceData must be tightly packed");
\ No newline at end of file
@@ -0,0 +1,185 @@
+#include "job_system.h"
+#include "trace_recorder.h"
+
+// index of the worker running on this thread, -1 on any other thread
+static thread_local int workerIndex = -1;
+
+bool JobCounter::isDone() const {
+    return _pending.load() == 0;
+}
+
+JobSystem& JobSystem::get() {
+    static JobSystem jobSystem;
+    return jobSystem;
+}
+
+JobSystem::JobSystem() {
+    _queues.emplace_back(new Queue);
+}
+
+JobSystem::~JobSystem() {
+    stop();
+}
+
+void JobSystem::start(int workerCount) {
+    if (!_workers.empty()) {
+        return;
+    }
+
+    if (workerCount <= 0) {
+        workerCount = static_cast<int>(std::max(std::thread::hardware_concurrency(), 2u)) - 1;
+    }
+
+    // the shared queue stays last
+    for (int i = 0; i < workerCount; ++i) {
+        _queues.emplace(_queues.end() - 1, new Queue);
+    }
+
+    _quit = false;
+    for (int i = 0; i < workerCount; ++i) {
+        _workers.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+}
+
+void JobSystem::stop() {
+    if (_workers.empty()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _quit = true;
+    }
+    _wakeCondition.notify_all();
+
+    for (auto& worker : _workers) {
+        worker.join();
+    }
+    _workers.clear();
+    _queues.erase(_queues.begin(), _queues.end() - 1);
+}
+
+int JobSystem::getWorkerCount() const {
+    return static_cast<int>(_workers.size());
+}
+
+void JobSystem::submit(Job job, JobCounter* counter, JobCounter* after) {
+    if (counter != nullptr) {
+        ++counter->_pending;
+        job = [this, job = std::move(job), counter]() {
+            job();
+            finish(counter);
+        };
+    }
+
+    if (after != nullptr) {
+        std::lock_guard<std::mutex> lock(after->_mutex);
+        if (after->_pending.load() > 0) {
+            after->_continuations.push_back(std::move(job));
+            return;
+        }
+    }
+
+    push(std::move(job));
+}
+
+void JobSystem::wait(JobCounter& counter) {
+    while (!counter.isDone()) {
+        if (!tryRunJob()) {
+            std::this_thread::yield();
+        }
+    }
+
+    // the last job may still hold the lock it decremented the counter under
+    std::lock_guard<std::mutex> lock(counter._mutex);
+}
+
+JobSystem::Queue& JobSystem::getQueue() {
+    return workerIndex >= 0 ? *_queues[workerIndex] : *_queues.back();
+}
+
+void JobSystem::push(Job job) {
+    ++_queuedJobs;
+    {
+        Queue& queue = getQueue();
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(std::move(job));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+    }
+    _wakeCondition.notify_one();
+}
+
+bool JobSystem::tryRunJob() {
+    Job job;
+
+    // newest own job first, it is the most likely to be in cache
+    Queue& own = getQueue();
+    {
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.jobs.empty()) {
+            job = std::move(own.jobs.back());
+            own.jobs.pop_back();
+        }
+    }
+
+    // then the oldest job of another queue
+    const size_t queueCount = _queues.size();
+    const size_t first = workerIndex >= 0 ? workerIndex + 1 : 0;
+    for (size_t i = 0; !job && i < queueCount; ++i) {
+        Queue& victim = *_queues[(first + i) % queueCount];
+        if (&victim == &own) {
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.jobs.empty()) {
+            job = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+        }
+    }
+
+    if (!job) {
+        return false;
+    }
+
+    --_queuedJobs;
+    {
+        TraceScope scope("job");
+        job();
+    }
+    return true;
+}
+
+void JobSystem::finish(JobCounter* counter) {
+    std::vector<Job> continuations;
+    {
+        std::lock_guard<std::mutex> lock(counter->_mutex);
+        if (--counter->_pending == 0) {
+            continuations.swap(counter->_continuations);
+        }
+    }
+
+    for (auto& job : continuations) {
+        push(std::move(job));
+    }
+}
+
+void JobSystem::workerLoop(int index) {
+    workerIndex = index;
+    TraceRecorder::get().setThreadName("worker " + std::to_string(index));
+
+    for (;;) {
+        if (tryRunJob()) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        _wakeCondition.wait(lock, [this] { return _quit || _queuedJobs.load() > 0; });
+        if (_quit && _queuedJobs.load() == 0) {
+            return;
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using Job = std::function<void()>;
+
+// counts the unfinished jobs submitted with it. jobs submitted to run after a counter
+// are held back until it reaches zero, which is enough to express a task graph without fibers.
+class JobCounter {
+public:
+    JobCounter() = default;
+
+    JobCounter(const JobCounter&) = delete;
+
+    bool isDone() const;
+
+private:
+    friend class JobSystem;
+
+    std::atomic<int> _pending{0};
+    std::mutex _mutex;
+    std::vector<Job> _continuations;
+};
+
+// worker threads with one deque each. a thread pushes and pops at the back of its own deque
+// and steals from the front of the others when it runs dry. threads that are not workers
+// share one more deque and run jobs while they wait, so the system works with zero workers.
+class JobSystem {
+public:
+    static JobSystem& get();
+
+    JobSystem(const JobSystem&) = delete;
+
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    ~JobSystem();
+
+    // workerCount 0 picks one worker per hardware thread besides the calling one
+    void start(int workerCount = 0);
+
+    // waits for the workers to finish the queued jobs
+    void stop();
+
+    int getWorkerCount() const;
+
+    // counter may be null, after may be null or a counter the job waits for
+    void submit(Job job, JobCounter* counter = nullptr, JobCounter* after = nullptr);
+
+    // run jobs on the calling thread until the counter reaches zero
+    void wait(JobCounter& counter);
+
+    // body(begin, end) over chunks of at most grainSize items, the calling thread takes part
+    template <typename Body>
+    void parallelFor(size_t count, size_t grainSize, const Body& body) {
+        if (count == 0) {
+            return;
+        }
+        grainSize = std::max<size_t>(grainSize, 1);
+
+        JobCounter counter;
+        for (size_t begin = grainSize; begin < count; begin += grainSize) {
+            const size_t end = std::min(begin + grainSize, count);
+            submit([&body, begin, end]() { body(begin, end); }, &counter);
+        }
+        body(0, std::min(grainSize, count));
+        wait(counter);
+    }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    std::vector<std::thread> _workers;
+    // one per worker, the last one is shared by the other threads
+    std::vector<std::unique_ptr<Queue>> _queues;
+
+    std::atomic<int> _queuedJobs{0};
+    std::mutex _sleepMutex;
+    std::condition_variable _wakeCondition;
+    bool _quit = false;
+
+    JobSystem();
+
+    void push(Job job);
+
+    Queue& getQueue();
+
+    bool tryRunJob();
+
+    void finish(JobCounter* counter);
+
+    void workerLoop(int index);
+};
\ No newline at end of file
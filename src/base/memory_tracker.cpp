@@ -0,0 +1,246 @@
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <ostream>
+
+#include "memory_tracker.h"
+
+static const char* categoryNames[MemoryTracker::categoryCount] = {
+    "texture", "render target", "buffer", "renderbuffer", "mesh data"};
+
+static thread_local std::vector<std::string> ownerStack;
+
+static const std::string untaggedOwner = "untagged";
+
+static double toMegabytes(size_t bytes) {
+    return bytes / (1024.0 * 1024.0);
+}
+
+size_t MemoryTracker::OwnerUsage::getGpuBytes() const {
+    size_t total = 0;
+    for (size_t i = 0; i < categoryCount; ++i) {
+        if (isGpu(static_cast<MemoryCategory>(i))) {
+            total += bytes[i];
+        }
+    }
+
+    return total;
+}
+
+size_t MemoryTracker::OwnerUsage::getCpuBytes() const {
+    size_t total = 0;
+    for (size_t i = 0; i < categoryCount; ++i) {
+        if (!isGpu(static_cast<MemoryCategory>(i))) {
+            total += bytes[i];
+        }
+    }
+
+    return total;
+}
+
+MemoryTracker& MemoryTracker::get() {
+    static MemoryTracker tracker;
+    return tracker;
+}
+
+MemoryTracker::Id MemoryTracker::add(MemoryCategory category, size_t bytes) {
+    const std::string& owner = ownerStack.empty() ? untaggedOwner : ownerStack.back();
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    const Id id = _nextId++;
+    _allocations.emplace(id, Allocation{category, owner, bytes});
+    _totals[static_cast<size_t>(category)] += bytes;
+    updatePeaks();
+
+    return id;
+}
+
+void MemoryTracker::resize(Id id, size_t bytes) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto iter = _allocations.find(id);
+    if (iter == _allocations.end()) {
+        return;
+    }
+
+    size_t& total = _totals[static_cast<size_t>(iter->second.category)];
+    total = total - iter->second.bytes + bytes;
+    iter->second.bytes = bytes;
+    updatePeaks();
+}
+
+void MemoryTracker::setCategory(Id id, MemoryCategory category) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto iter = _allocations.find(id);
+    if (iter == _allocations.end() || iter->second.category == category) {
+        return;
+    }
+
+    _totals[static_cast<size_t>(iter->second.category)] -= iter->second.bytes;
+    _totals[static_cast<size_t>(category)] += iter->second.bytes;
+    iter->second.category = category;
+    updatePeaks();
+}
+
+void MemoryTracker::remove(Id id) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto iter = _allocations.find(id);
+    if (iter == _allocations.end()) {
+        return;
+    }
+
+    _totals[static_cast<size_t>(iter->second.category)] -= iter->second.bytes;
+    _allocations.erase(iter);
+}
+
+size_t MemoryTracker::getTotal(MemoryCategory category) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _totals[static_cast<size_t>(category)];
+}
+
+size_t MemoryTracker::getGpuTotal() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    size_t total = 0;
+    for (size_t i = 0; i < categoryCount; ++i) {
+        if (isGpu(static_cast<MemoryCategory>(i))) {
+            total += _totals[i];
+        }
+    }
+
+    return total;
+}
+
+size_t MemoryTracker::getCpuTotal() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    size_t total = 0;
+    for (size_t i = 0; i < categoryCount; ++i) {
+        if (!isGpu(static_cast<MemoryCategory>(i))) {
+            total += _totals[i];
+        }
+    }
+
+    return total;
+}
+
+size_t MemoryTracker::getGpuPeak() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _gpuPeak;
+}
+
+size_t MemoryTracker::getCpuPeak() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _cpuPeak;
+}
+
+std::vector<MemoryTracker::OwnerUsage> MemoryTracker::getUsageByOwner() const {
+    std::map<std::string, OwnerUsage> owners;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (const auto& allocation : _allocations) {
+            OwnerUsage& usage = owners[allocation.second.owner];
+            usage.bytes[static_cast<size_t>(allocation.second.category)] += allocation.second.bytes;
+            ++usage.allocationCount;
+        }
+    }
+
+    std::vector<OwnerUsage> usages;
+    usages.reserve(owners.size());
+    for (auto& owner : owners) {
+        owner.second.owner = owner.first;
+        usages.push_back(std::move(owner.second));
+    }
+
+    // the map already ordered equal sizes by name
+    std::stable_sort(usages.begin(), usages.end(), [](const OwnerUsage& lhs, const OwnerUsage& rhs) {
+        return lhs.getGpuBytes() + lhs.getCpuBytes() > rhs.getGpuBytes() + rhs.getCpuBytes();
+    });
+
+    return usages;
+}
+
+void MemoryTracker::dump(std::ostream& stream) const {
+    const std::vector<OwnerUsage> usages = getUsageByOwner();
+
+    stream << std::fixed << std::setprecision(2) << "memory: gpu " << toMegabytes(getGpuTotal())
+           << " MB (peak " << toMegabytes(getGpuPeak()) << " MB), cpu " << toMegabytes(getCpuTotal())
+           << " MB (peak " << toMegabytes(getCpuPeak()) << " MB)\n";
+    for (size_t i = 0; i < categoryCount; ++i) {
+        stream << "  " << std::left << std::setw(16) << categoryNames[i] << std::right << std::setw(10)
+               << toMegabytes(getTotal(static_cast<MemoryCategory>(i))) << " MB\n";
+    }
+
+    stream << std::left << std::setw(48) << "owner" << std::right << std::setw(12) << "gpu MB"
+           << std::setw(12) << "cpu MB" << std::setw(8) << "count" << "\n";
+    for (const OwnerUsage& usage : usages) {
+        stream << std::left << std::setw(48) << usage.owner << std::right << std::setw(12)
+               << toMegabytes(usage.getGpuBytes()) << std::setw(12) << toMegabytes(usage.getCpuBytes())
+               << std::setw(8) << usage.allocationCount << "\n";
+    }
+
+    stream.flush();
+}
+
+bool MemoryTracker::isGpu(MemoryCategory category) {
+    return category != MemoryCategory::MeshData;
+}
+
+const char* MemoryTracker::getName(MemoryCategory category) {
+    return categoryNames[static_cast<size_t>(category)];
+}
+
+size_t MemoryTracker::getTexelSize(GLint internalFormat) {
+    switch (internalFormat) {
+    case GL_RED:
+    case GL_R8:
+    case GL_R8UI:
+    case GL_R8I: return 1;
+    case GL_RG:
+    case GL_RG8:
+    case GL_R16F:
+    case GL_R16UI:
+    case GL_R16I:
+    case GL_DEPTH_COMPONENT16: return 2;
+    case GL_RGB:
+    case GL_RGB8:
+    case GL_SRGB8: return 3;
+    case GL_RGBA:
+    case GL_RGBA8:
+    case GL_SRGB8_ALPHA8:
+    case GL_RGB10_A2:
+    case GL_R11F_G11F_B10F:
+    case GL_RG16F:
+    case GL_R32F:
+    case GL_R32UI:
+    case GL_R32I:
+    // the unsized depth formats get 24 bits, padded to a word
+    case GL_DEPTH_COMPONENT:
+    case GL_DEPTH_COMPONENT24:
+    case GL_DEPTH_COMPONENT32F:
+    case GL_DEPTH_STENCIL:
+    case GL_DEPTH24_STENCIL8: return 4;
+    case GL_RGB16F: return 6;
+    case GL_RGBA16F:
+    case GL_RG32F:
+    case GL_DEPTH32F_STENCIL8: return 8;
+    case GL_RGB32F: return 12;
+    case GL_RGBA32F: return 16;
+    default: return 0;
+    }
+}
+
+void MemoryTracker::updatePeaks() {
+    size_t gpu = 0, cpu = 0;
+    for (size_t i = 0; i < categoryCount; ++i) {
+        (isGpu(static_cast<MemoryCategory>(i)) ? gpu : cpu) += _totals[i];
+    }
+
+    _gpuPeak = std::max(_gpuPeak, gpu);
+    _cpuPeak = std::max(_cpuPeak, cpu);
+}
+
+MemoryOwnerScope::MemoryOwnerScope(std::string owner) {
+    ownerStack.push_back(std::move(owner));
+}
+
+MemoryOwnerScope::~MemoryOwnerScope() {
+    ownerStack.pop_back();
+}
\ No newline at end of file
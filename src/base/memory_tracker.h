@@ -0,0 +1,114 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "gl_utility.h"
+
+enum class MemoryCategory {
+    Texture,
+    // textures attached to a framebuffer
+    RenderTarget,
+    Buffer,
+    Renderbuffer,
+    // cpu copies of mesh geometry, the only cpu category
+    MeshData,
+    Count
+};
+
+// bytes of the gpu resources and cpu mesh copies alive, each attributed to the owner named by the
+// innermost MemoryOwnerScope of the thread that created it. the sizes are the ones requested from
+// gl, drivers may pad or compress them.
+class MemoryTracker {
+public:
+    using Id = uint64_t;
+
+    static constexpr Id invalidId = 0;
+    static constexpr size_t categoryCount = static_cast<size_t>(MemoryCategory::Count);
+
+    struct OwnerUsage {
+        std::string owner;
+        std::array<size_t, categoryCount> bytes{};
+        size_t allocationCount = 0;
+
+        size_t getGpuBytes() const;
+
+        size_t getCpuBytes() const;
+    };
+
+    static MemoryTracker& get();
+
+    MemoryTracker(const MemoryTracker&) = delete;
+
+    MemoryTracker& operator=(const MemoryTracker&) = delete;
+
+    Id add(MemoryCategory category, size_t bytes);
+
+    // resize, setCategory and remove ignore invalidId
+    void resize(Id id, size_t bytes);
+
+    void setCategory(Id id, MemoryCategory category);
+
+    void remove(Id id);
+
+    size_t getTotal(MemoryCategory category) const;
+
+    size_t getGpuTotal() const;
+
+    size_t getCpuTotal() const;
+
+    size_t getGpuPeak() const;
+
+    size_t getCpuPeak() const;
+
+    // largest first
+    std::vector<OwnerUsage> getUsageByOwner() const;
+
+    // totals per category then one line per owner
+    void dump(std::ostream& stream) const;
+
+    static bool isGpu(MemoryCategory category);
+
+    static const char* getName(MemoryCategory category);
+
+    // bytes per texel of a sized or unsized internal format, 0 for an unknown one
+    static size_t getTexelSize(GLint internalFormat);
+
+private:
+    struct Allocation {
+        MemoryCategory category;
+        std::string owner;
+        size_t bytes;
+    };
+
+    mutable std::mutex _mutex;
+    std::unordered_map<Id, Allocation> _allocations;
+    Id _nextId = 1;
+
+    std::array<size_t, categoryCount> _totals{};
+    size_t _gpuPeak = 0;
+    size_t _cpuPeak = 0;
+
+    MemoryTracker() = default;
+
+    // the caller holds _mutex
+    void updatePeaks();
+};
+
+// names the owner of the memory tracked on this thread while alive, the innermost scope wins
+class MemoryOwnerScope {
+public:
+    explicit MemoryOwnerScope(std::string owner);
+
+    MemoryOwnerScope(const MemoryOwnerScope&) = delete;
+
+    MemoryOwnerScope& operator=(const MemoryOwnerScope&) = delete;
+
+    ~MemoryOwnerScope();
+};
\ No newline at end of file
@@ -0,0 +1,188 @@
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "gl_state_cache.h"
+#include "render_statistics.h"
+#include "mesh.h"
+
+static uint32_t nextMeshId = 1;
+
+Mesh::Mesh(MeshData data) : _data(std::move(data)), _id(nextMeshId++) {
+    // the cpu copy is kept for picking, export and the inspector
+    _dataMemory = MemoryTracker::get().add(
+        MemoryCategory::MeshData,
+        _data.vertices.capacity() * sizeof(Vertex) + _data.indices.capacity() * sizeof(uint32_t));
+
+    initGLResources();
+
+    initBoxGLResources();
+
+    GLenum error = glGetError();
+    if (error != GL_NO_ERROR) {
+        cleanup();
+        throw std::runtime_error("OpenGL Error: " + std::to_string(error));
+    }
+}
+
+Mesh::Mesh(Mesh&& rhs) noexcept
+    : _data(std::move(rhs._data)), _id(rhs._id), _geometry(rhs._geometry),
+      _boxVao(rhs._boxVao), _boxVbo(rhs._boxVbo), _boxEbo(rhs._boxEbo),
+      _dataMemory(rhs._dataMemory), _boxMemory(rhs._boxMemory) {
+    rhs._geometry = GeometryArena::invalidHandle;
+    rhs._boxVao = 0;
+    rhs._boxVbo = 0;
+    rhs._boxEbo = 0;
+    rhs._dataMemory = MemoryTracker::invalidId;
+    rhs._boxMemory = MemoryTracker::invalidId;
+}
+
+Mesh::~Mesh() {
+    cleanup();
+}
+
+const MeshData& Mesh::getData() const {
+    return _data;
+}
+
+uint32_t Mesh::getId() const {
+    return _id;
+}
+
+GeometryArena::Handle Mesh::getGeometry() const {
+    return _geometry;
+}
+
+GLuint Mesh::getBoundingBoxVao() const {
+    return _boxVao;
+}
+
+size_t Mesh::getVertexCount() const {
+    return _data.vertices.size();
+}
+
+size_t Mesh::getFaceCount() const {
+    return _data.indices.size() / 3;
+}
+
+const BoundingBox& Mesh::getBoundingBox() const {
+    return _data.boundingBox;
+}
+
+void Mesh::draw() const {
+    GeometryArena::get().draw(_geometry);
+}
+
+void Mesh::drawBoundingBox() const {
+    GLStateCache::get().bindVertexArray(_boxVao);
+    glDrawElements(GL_LINES, 24, GL_UNSIGNED_INT, 0);
+    RenderStatistics::get().addDraw(0);
+}
+
+void Mesh::initGLResources() {
+    _geometry = GeometryArena::get().allocate(_data.vertices, _data.indices);
+}
+
+void Mesh::initBoxGLResources() {
+    std::vector<glm::vec3> boxVertices = {
+        glm::vec3(_data.boundingBox.min.x, _data.boundingBox.min.y, _data.boundingBox.min.z),
+        glm::vec3(_data.boundingBox.max.x, _data.boundingBox.min.y, _data.boundingBox.min.z),
+        glm::vec3(_data.boundingBox.min.x, _data.boundingBox.max.y, _data.boundingBox.min.z),
+        glm::vec3(_data.boundingBox.max.x, _data.boundingBox.max.y, _data.boundingBox.min.z),
+        glm::vec3(_data.boundingBox.min.x, _data.boundingBox.min.y, _data.boundingBox.max.z),
+        glm::vec3(_data.boundingBox.max.x, _data.boundingBox.min.y, _data.boundingBox.max.z),
+        glm::vec3(_data.boundingBox.min.x, _data.boundingBox.max.y, _data.boundingBox.max.z),
+        glm::vec3(_data.boundingBox.max.x, _data.boundingBox.max.y, _data.boundingBox.max.z),
+    };
+
+    std::vector<uint32_t> boxIndices = {0, 1, 0, 2, 0, 4, 3, 1, 3, 2, 3, 7,
+                                        5, 4, 5, 1, 5, 7, 6, 4, 6, 7, 6, 2};
+
+    glGenVertexArrays(1, &_boxVao);
+    glGenBuffers(1, &_boxVbo);
+    glGenBuffers(1, &_boxEbo);
+    RenderStatistics& statistics = RenderStatistics::get();
+    statistics.onCreated(GLObjectType::VertexArray);
+    statistics.onCreated(GLObjectType::Buffer, 2);
+
+    GLStateCache::get().bindVertexArray(_boxVao);
+    glBindBuffer(GL_ARRAY_BUFFER, _boxVbo);
+    glBufferData(
+        GL_ARRAY_BUFFER, boxVertices.size() * sizeof(glm::vec3), boxVertices.data(),
+        GL_STATIC_DRAW);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _boxEbo);
+    glBufferData(
+        GL_ELEMENT_ARRAY_BUFFER, boxIndices.size() * sizeof(uint32_t), boxIndices.data(),
+        GL_STATIC_DRAW);
+    statistics.add(
+        RenderCounter::BufferUploadBytes,
+        boxVertices.size() * sizeof(glm::vec3) + boxIndices.size() * sizeof(uint32_t));
+    _boxMemory = MemoryTracker::get().add(
+        MemoryCategory::Buffer,
+        boxVertices.size() * sizeof(glm::vec3) + boxIndices.size() * sizeof(uint32_t));
+
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), 0);
+    glEnableVertexAttribArray(0);
+
+    GLStateCache::get().bindVertexArray(0);
+}
+
+void Mesh::cleanup() {
+    if (_boxEbo) {
+        glDeleteBuffers(1, &_boxEbo);
+        RenderStatistics::get().onDeleted(GLObjectType::Buffer);
+        _boxEbo = 0;
+    }
+
+    if (_boxVbo) {
+        glDeleteBuffers(1, &_boxVbo);
+        RenderStatistics::get().onDeleted(GLObjectType::Buffer);
+        _boxVbo = 0;
+    }
+
+    if (_boxVao) {
+        GLStateCache::get().onVertexArrayDeleted(_boxVao);
+        glDeleteVertexArrays(1, &_boxVao);
+        RenderStatistics::get().onDeleted(GLObjectType::VertexArray);
+        _boxVao = 0;
+    }
+
+    if (_geometry != GeometryArena::invalidHandle) {
+        GeometryArena::get().free(_geometry);
+        _geometry = GeometryArena::invalidHandle;
+    }
+
+    MemoryTracker& tracker = MemoryTracker::get();
+    tracker.remove(_dataMemory);
+    tracker.remove(_boxMemory);
+    _dataMemory = MemoryTracker::invalidId;
+    _boxMemory = MemoryTracker::invalidId;
+}
+
+static std::unordered_map<std::string, std::weak_ptr<Mesh>>& getSharedMeshes() {
+    static std::unordered_map<std::string, std::weak_ptr<Mesh>> meshes;
+    return meshes;
+}
+
+std::shared_ptr<Mesh> MeshLibrary::find(const std::string& key) {
+    auto& meshes = getSharedMeshes();
+    auto iter = meshes.find(key);
+    if (iter == meshes.end()) {
+        return nullptr;
+    }
+
+    std::shared_ptr<Mesh> mesh = iter->second.lock();
+    if (mesh == nullptr) {
+        meshes.erase(iter);
+    }
+
+    return mesh;
+}
+
+std::shared_ptr<Mesh> MeshLibrary::add(const std::string& key, MeshData data) {
+    MemoryOwnerScope owner("mesh " + key);
+    std::shared_ptr<Mesh> mesh = std::make_shared<Mesh>(std::move(data));
+    getSharedMeshes()[key] = mesh;
+    return mesh;
+}
\ No newline at end of file
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "geometry_arena.h"
+#include "gl_utility.h"
+#include "memory_tracker.h"
+#include "mesh_data.h"
+
+class Mesh {
+public:
+    Mesh(MeshData data);
+
+    Mesh(const Mesh&) = delete;
+
+    Mesh(Mesh&& rhs) noexcept;
+
+    ~Mesh();
+
+    const MeshData& getData() const;
+
+    // small process-unique id, used to group draws of the same geometry
+    uint32_t getId() const;
+
+    // range of the mesh in the shared geometry arena
+    GeometryArena::Handle getGeometry() const;
+
+    GLuint getBoundingBoxVao() const;
+
+    size_t getVertexCount() const;
+
+    size_t getFaceCount() const;
+
+    const BoundingBox& getBoundingBox() const;
+
+    void draw() const;
+
+    void drawBoundingBox() const;
+
+private:
+    MeshData _data;
+    uint32_t _id = 0;
+
+    GeometryArena::Handle _geometry = GeometryArena::invalidHandle;
+
+    // opengl objects
+    GLuint _boxVao = 0;
+    GLuint _boxVbo = 0;
+    GLuint _boxEbo = 0;
+
+    MemoryTracker::Id _dataMemory = MemoryTracker::invalidId;
+    MemoryTracker::Id _boxMemory = MemoryTracker::invalidId;
+
+    void initGLResources();
+
+    void initBoxGLResources();
+
+    void cleanup();
+};
+
+// geometry shared between models, keyed by source file path or primitive parameters.
+// the library only keeps weak references, a mesh dies with its last model.
+// the memory of a mesh added here is attributed to "mesh <key>".
+class MeshLibrary {
+public:
+    static std::shared_ptr<Mesh> find(const std::string& key);
+
+    static std::shared_ptr<Mesh> add(const std::string& key, MeshData data);
+};
\ No newline at end of file
@@ -0,0 +1,222 @@
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <unordered_map>
+
+#include "mesh_data.h"
+#include "trace_recorder.h"
+
+struct Face {
+    int vi[3];  // 
+    int ti[3];  // 
+    int ni[3];  // 
+};
+
+MeshData::MeshData(std::vector<Vertex> vertices, std::vector<uint32_t> indices)
+    : vertices(std::move(vertices)), indices(std::move(indices)) {
+    computeBoundingBox();
+}
+
+MeshData MeshData::loadObj(const std::string& filepath) {
+    TraceScope scope("load obj");
+
+    std::ifstream in;
+    in.open(filepath, std::ifstream::in);
+    if (!in.is_open()) {
+        std::cerr << "Can't open " + filepath << "\n";
+        return {};
+    }
+
+    std::string line;
+    std::vector<glm::vec3> verts, norms;
+    std::vector<glm::vec2> texCoords;
+    std::vector<Face> faces;
+    while (!in.eof()) {
+        std::getline(in, line);
+        std::istringstream iss(line.c_str());
+
+        std::string prefix;
+        iss >> prefix;
+        if (prefix == "v") {
+            glm::vec3 v{};
+            iss >> v.x >> v.y >> v.z;
+            verts.push_back(v);
+        } else if (prefix == "vt") {
+            glm::vec2 t{};
+            iss >> t.x >> t.y;
+            texCoords.push_back(t);
+        } else if (prefix == "vn") {
+            glm::vec3 n{};
+            iss >> n.x >> n.y >> n.z;
+            norms.push_back(n);
+        } else if (prefix == "f") {
+            int vis[4]{}, tis[4]{}, nis[4]{};
+             
+            std::string vertexStr;
+            int i = 0;
+            while (iss >> vertexStr && i < 4) {  // 4
+                // ʹʽ
+                size_t firstSlash = vertexStr.find('/');
+                size_t secondSlash = vertexStr.find('/', firstSlash + 1);
+
+                if (firstSlash == std::string::npos) {
+                    // v
+                    vis[i] = std::stoi(vertexStr) - 1;
+                    tis[i] = -1;
+                    nis[i] = -1;
+                } else if (secondSlash == std::string::npos) {
+                    // v/t
+                    vis[i] = std::stoi(vertexStr.substr(0, firstSlash)) - 1;
+                    tis[i] = std::stoi(vertexStr.substr(firstSlash + 1)) - 1;
+                    nis[i] = -1;
+                } else if (firstSlash + 1 == secondSlash) {
+                    // v//n
+                    vis[i] = std::stoi(vertexStr.substr(0, firstSlash)) - 1;
+                    tis[i] = -1;
+                    nis[i] = std::stoi(vertexStr.substr(secondSlash + 1)) - 1;
+                } else {
+                    // v/t/n
+                    vis[i] = std::stoi(vertexStr.substr(0, firstSlash)) - 1;
+                    tis[i] = std::stoi(vertexStr.substr(firstSlash + 1, secondSlash - firstSlash - 1)) - 1;
+                    nis[i] = std::stoi(vertexStr.substr(secondSlash + 1)) - 1;
+                }
+                i++;
+            }
+
+            // ĸ㣬ָΪ
+            if (i == 4) {
+                // һ v1, v2, v3
+                Face f1 = { { vis[0], vis[1], vis[2] }, { tis[0], tis[1], tis[2] }, { nis[0], nis[1], nis[2] } };
+                faces.push_back(f1);
+
+                // ڶ v1, v3, v4
+                Face f2 = { { vis[0], vis[2], vis[3] }, { tis[0], tis[2], tis[3] }, { nis[0], nis[2], nis[3] } };
+                faces.push_back(f2);
+            } else {
+                Face f = { { vis[0], vis[1], vis[2] }, { tis[0], tis[1], tis[2] }, { nis[0], nis[1], nis[2] } };
+                faces.push_back(f);
+            }
+        }
+    }
+
+    std::vector<Vertex> corners;
+    corners.reserve(faces.size() * 3);
+    for (const auto& f : faces) {
+        for (int i = 0; i < 3; i++) {
+            Vertex vertex{};
+            vertex.position = verts[f.vi[i]];
+            if (f.ni[i] >= 0)
+                vertex.normal = norms[f.ni[i]];
+            if (f.ti[i] >= 0)
+                vertex.texCoord = texCoords[f.ti[i]];
+            corners.push_back(vertex);
+        }
+    }
+
+    in.close();
+
+    return fromTriangles(corners);
+}
+
+MeshData MeshData::fromTriangles(const std::vector<Vertex>& corners) {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    std::unordered_map<Vertex, uint32_t> uniqueVertices;
+
+    for (const Vertex& vertex : corners) {
+        if (uniqueVertices.count(vertex) == 0) {
+            uniqueVertices[vertex] = static_cast<uint32_t>(vertices.size());
+            vertices.push_back(vertex);
+        }
+
+        indices.push_back(uniqueVertices[vertex]);
+    }
+
+    return MeshData(std::move(vertices), std::move(indices));
+}
+
+void MeshData::exportObj(const std::string& filepath) const {
+    std::ofstream out(filepath);
+    if (!out.is_open()) {
+        std::cerr << "Can't open file: " << filepath << std::endl;
+        return;
+    }
+
+    std::unordered_map<glm::vec3, uint32_t> uniqueNormals;
+    std::vector<glm::vec3> normals;
+    std::unordered_map<glm::vec2, uint32_t> uniqueTexCoords;
+    std::vector<glm::vec2> texCoords;
+
+    // д붥
+    for (const auto& vertex : vertices) {
+        out << "v " << vertex.position.x << " " << vertex.position.y << " " << vertex.position.z << "\n";
+        // ȥظuv
+        if (uniqueNormals.count(vertex.normal) == 0 && vertex.normal != glm::zero<glm::vec3>()) {
+            uniqueNormals[vertex.normal] = normals.size() + 1;  // .obj  1 ʼ
+            normals.push_back(vertex.normal);
+        }
+        if (uniqueTexCoords.count(vertex.texCoord) == 0 && vertex.texCoord != glm::zero<glm::vec2>()) {
+            uniqueTexCoords[vertex.texCoord] = texCoords.size() + 1;  // .obj  1 ʼ
+            texCoords.push_back(vertex.texCoord);
+        }
+    }
+
+    for (const auto& normal : normals) {
+        out << "vn " << normal.x << " " << normal.y << " " << normal.z << "\n";
+    }
+
+    for (const auto& texCoord : texCoords) {
+        out << "vt " << texCoord.x << " " << texCoord.y << "\n";
+    }
+
+    // д
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        out << "f ";
+        for (int j = 0; j < 3; ++j) {
+            size_t idx = indices[i + j] + 1;  // .obj  1 ʼ
+            const Vertex& vertex = vertices[indices[i + j]];
+
+            int texIdx = uniqueTexCoords.count(vertex.texCoord) ? uniqueTexCoords[vertex.texCoord] : 0;
+            int normIdx = uniqueNormals.count(vertex.normal) ? uniqueNormals[vertex.normal] : 0;
+
+            if (texIdx == 0 && normIdx == 0) {
+                out << idx << " ";
+            }
+            else if (texIdx == 0) {
+                out << idx << "//" << normIdx << " ";
+            }
+            else if (normIdx == 0) {
+                out << idx << "/" << texIdx << " ";
+            }
+            else {
+                out << idx << "/" << texIdx << "/" << normIdx << " ";
+            }
+        }
+        out << "\n";
+    }
+
+    out.close();
+}
+
+void MeshData::computeBoundingBox() {
+    float minX = std::numeric_limits<float>::max();
+    float minY = std::numeric_limits<float>::max();
+    float minZ = std::numeric_limits<float>::max();
+    float maxX = -std::numeric_limits<float>::max();
+    float maxY = -std::numeric_limits<float>::max();
+    float maxZ = -std::numeric_limits<float>::max();
+
+    for (const auto& v : vertices) {
+        minX = std::min(v.position.x, minX);
+        minY = std::min(v.position.y, minY);
+        minZ = std::min(v.position.z, minZ);
+        maxX = std::max(v.position.x, maxX);
+        maxY = std::max(v.position.y, maxY);
+        maxZ = std::max(v.position.z, maxZ);
+    }
+
+    boundingBox.min = glm::vec3(minX, minY, minZ);
+    boundingBox.max = glm::vec3(maxX, maxY, maxZ);
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "bounding_box.h"
+#include "vertex.h"
+
+// cpu side geometry, doesn't touch the gl context
+struct MeshData {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    BoundingBox boundingBox;
+
+    MeshData() = default;
+
+    MeshData(std::vector<Vertex> vertices, std::vector<uint32_t> indices);
+
+    static MeshData loadObj(const std::string& filepath);
+
+    // three corners per triangle, equal corners are welded into one indexed vertex
+    static MeshData fromTriangles(const std::vector<Vertex>& corners);
+
+    void exportObj(const std::string& filepath) const;
+
+    void computeBoundingBox();
+};
\ No newline at end of file
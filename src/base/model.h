@@ -1,10 +1,12 @@
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "bounding_box.h"
 #include "gl_utility.h"
+#include "mesh.h"
 #include "object.h"
 #include "vertex.h"
 #include "texture2d.h"
@@ -22,20 +24,23 @@ class Model : public Object {
 public:
     Material material;
 
+    // models loaded from the same file share one mesh
     Model(const std::string& name, const std::string& filepath);
 
     Model(const std::string& name, const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices);
 
+    Model(const std::string& name, std::shared_ptr<Mesh> mesh);
+
     Model(Model&& rhs) noexcept;
 
-    virtual ~Model();
+    Model& operator=(Model&& rhs) noexcept;
+
+    virtual ~Model() = default;
 
     void renderInspector() override;
 
     void exportObj(const std::string& filepath) const;
 
-    GLuint getVao() const;
-
     GLuint getBoundingBoxVao() const;
 
     size_t getVertexCount() const;
@@ -46,44 +51,24 @@ public:
 
     BoundingBox getTransformedBoundingBox() const;
 
+    const Mesh& getMesh() const;
+
+    std::shared_ptr<const Mesh> getSharedMesh() const;
+
     virtual void draw() const;
 
     virtual void drawBoundingBox() const;
 
     const std::vector<uint32_t>& getIndices() const {
-        return _indices;
+        return _mesh->getData().indices;
     }
     const std::vector<Vertex>& getVertices() const {
-        return _vertices;
+        return _mesh->getData().vertices;
     }
     const Vertex& getVertex(int i) const {
-        return _vertices[i];
+        return _mesh->getData().vertices[i];
     }
 
 protected:
-    // vertices of the table represented in model's own coordinate
-    std::vector<Vertex> _vertices;
-    std::vector<uint32_t> _indices;
-
-    // bounding box
-    BoundingBox _boundingBox;
-
-    // opengl objects
-    GLuint _vao = 0;
-    GLuint _vbo = 0;
-    GLuint _ebo = 0;
-
-    GLuint _boxVao = 0;
-    GLuint _boxVbo = 0;
-    GLuint _boxEbo = 0;
-
-    void loadObj(const std::string& filepath);
-
-    void computeBoundingBox();
-
-    void initGLResources();
-
-    void initBoxGLResources();
-
-    void cleanup();
+    std::shared_ptr<Mesh> _mesh;
 };
\ No newline at end of file
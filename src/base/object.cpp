@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include <imgui.h>
 
 #include "object.h"
@@ -6,16 +8,148 @@ Object::Object(const std::string & name) : name(name) {
 
 }
 
+Object::Object(Object&& rhs) noexcept
+	: name(std::move(rhs.name)), transform(rhs.transform), handle(rhs.handle) {
+	takeOver(rhs);
+}
+
+Object& Object::operator=(Object&& rhs) noexcept {
+	if (this != &rhs) {
+		detach();
+		name = std::move(rhs.name);
+		transform = rhs.transform;
+		handle = rhs.handle;
+		takeOver(rhs);
+	}
+
+	return *this;
+}
+
+Object::~Object() {
+	detach();
+}
+
 void Object::renderInspector() {
 	ImGui::Text("%s", name.c_str());
 	
-	ImGui::DragFloat3("Position", &transform.position[0], 0.1f);
+	bool changed = ImGui::DragFloat3("Position", &transform.position[0], 0.1f);
 	
 	// ༭rotation
 	glm::vec3 eulerAngles = glm::degrees(glm::eulerAngles(transform.rotation));
 	if (ImGui::DragFloat3("Rotation", &eulerAngles[0], 1.0f)) {
+		changed = true;
 		transform.rotation = glm::quat(glm::radians(eulerAngles));  // ޸ĵŷתΪԪ
 	}
 
-	ImGui::DragFloat3("Scale", &transform.scale[0], 0.01f, 0.0f, 10.0f);
+	changed |= ImGui::DragFloat3("Scale", &transform.scale[0], 0.01f, 0.0f, 10.0f);
+
+	if (changed) {
+		markTransformDirty();
+	}
+}
+
+void Object::attachToSceneGraph(SceneGraph& sceneGraph) {
+	_sceneGraph = &sceneGraph;
+	_node = sceneGraph.create();
+	markTransformDirty();
+}
+
+void Object::setParent(Object* parent) {
+	if (parent == _parent) {
+		return;
+	}
+
+	const glm::mat4 world = computeWorldMatrix();
+
+	if (_parent != nullptr) {
+		_parent->_children.erase(std::find(_parent->_children.begin(), _parent->_children.end(), this));
+	}
+	_parent = parent;
+	if (_parent != nullptr) {
+		_parent->_children.push_back(this);
+	}
+
+	if (_sceneGraph != nullptr) {
+		_sceneGraph->setParent(_node, _parent != nullptr ? _parent->_node : SceneGraph::invalidNode);
+	}
+
+	transform.setFromTRS(_parent != nullptr ? glm::inverse(_parent->computeWorldMatrix()) * world : world);
+	markTransformDirty();
+}
+
+Object* Object::getParent() const {
+	return _parent;
+}
+
+const std::vector<Object*>& Object::getChildren() const {
+	return _children;
+}
+
+bool Object::isAncestorOf(const Object* object) const {
+	for (const Object* current = object->_parent; current != nullptr; current = current->_parent) {
+		if (current == this) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void Object::markTransformDirty() {
+	if (_sceneGraph != nullptr) {
+		_sceneGraph->setLocalTransform(_node, transform);
+	}
+}
+
+glm::mat4 Object::getWorldMatrix() const {
+	if (_sceneGraph == nullptr) {
+		return transform.getLocalMatrix();
+	}
+
+	return _sceneGraph->getWorldMatrix(_node);
+}
+
+glm::vec3 Object::getWorldPosition() const {
+	return glm::vec3(getWorldMatrix()[3]);
+}
+
+glm::vec3 Object::getWorldFront() const {
+	return glm::normalize(glm::mat3(getWorldMatrix()) * Transform::getDefaultFront());
+}
+
+void Object::detach() {
+	while (!_children.empty()) {
+		_children.back()->setParent(_parent);
+	}
+	setParent(nullptr);
+
+	if (_sceneGraph != nullptr) {
+		_sceneGraph->destroy(_node);
+		_sceneGraph = nullptr;
+		_node = SceneGraph::invalidNode;
+	}
+}
+
+void Object::takeOver(Object& rhs) {
+	_sceneGraph = rhs._sceneGraph;
+	_node = rhs._node;
+	_parent = rhs._parent;
+	_children = std::move(rhs._children);
+
+	if (_parent != nullptr) {
+		std::replace(_parent->_children.begin(), _parent->_children.end(), &rhs, this);
+	}
+	for (Object* child : _children) {
+		child->_parent = this;
+	}
+
+	rhs._sceneGraph = nullptr;
+	rhs._node = SceneGraph::invalidNode;
+	rhs._parent = nullptr;
+	rhs._children.clear();
+}
+
+glm::mat4 Object::computeWorldMatrix() const {
+	const glm::mat4 local = transform.getLocalMatrix();
+	return _parent != nullptr ? _parent->computeWorldMatrix() * local : local;
 }
\ No newline at end of file
@@ -1,14 +1,64 @@
 #pragma once
 
 #include <string>
+#include <vector>
+
+#include "scene_graph.h"
+#include "slot_map.h"
 #include "transform.h"
 
 class Object {
 public:
 	std::string name;
+	// local to the parent, call markTransformDirty() after writing it
 	Transform transform;
+	// handle of the object in the storage that owns it, objects are moved around in there
+	SlotHandle handle;
 	
 	Object(const std::string& name);
 
+	// the parent and the children are pointed at the new address
+	Object(Object&& rhs) noexcept;
+
+	Object& operator=(Object&& rhs) noexcept;
+
+	// the children are moved to the parent of this object
+	virtual ~Object();
+
 	virtual void renderInspector();
+
+	void attachToSceneGraph(SceneGraph& sceneGraph);
+
+	// the world transform is kept, nullptr makes the object a root
+	void setParent(Object* parent);
+
+	Object* getParent() const;
+
+	const std::vector<Object*>& getChildren() const;
+
+	bool isAncestorOf(const Object* object) const;
+
+	void markTransformDirty();
+
+	// cached in the scene graph, the local matrix when the object is not attached
+	glm::mat4 getWorldMatrix() const;
+
+	glm::vec3 getWorldPosition() const;
+
+	glm::vec3 getWorldFront() const;
+
+protected:
+	SceneGraph* _sceneGraph = nullptr;
+	SceneGraph::Node _node = SceneGraph::invalidNode;
+
+	Object* _parent = nullptr;
+	std::vector<Object*> _children;
+
+	// move the children to the parent and leave the scene graph
+	void detach();
+
+	void takeOver(Object& rhs);
+
+	// walks up the parents, for edits between two scene graph updates
+	glm::mat4 computeWorldMatrix() const;
 };
\ No newline at end of file
@@ -0,0 +1,200 @@
+#include <algorithm>
+
+#include "gl_state_cache.h"
+#include "object_data_buffer.h"
+#include "render_statistics.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OBJECT_DATA_SSE2
+#endif
+
+// the inverse transpose of a 3x3 matrix with columns a, b, c has the columns
+// b x c, c x a, a x b divided by the determinant a . (b x c)
+static void computeMatrices(const glm::mat4& model, ObjectData& data) {
+    const glm::vec3 a = glm::vec3(model[0]), b = glm::vec3(model[1]), c = glm::vec3(model[2]);
+    const glm::vec3 bc = glm::cross(b, c), ca = glm::cross(c, a), ab = glm::cross(a, b);
+    const float invDet = 1.0f / glm::dot(a, bc);
+
+    data.model = model;
+    data.normalMatrix[0] = glm::vec4(bc * invDet, 0.0f);
+    data.normalMatrix[1] = glm::vec4(ca * invDet, 0.0f);
+    data.normalMatrix[2] = glm::vec4(ab * invDet, 0.0f);
+}
+
+#ifdef OBJECT_DATA_SSE2
+// four matrices at a time, one per lane
+static void computeMatrices4(const glm::mat4* const models[4], ObjectData* const data[4]) {
+    // m[column][row] holds the element of the four matrices
+    __m128 m[3][3];
+    for (int column = 0; column < 3; ++column) {
+        for (int row = 0; row < 3; ++row) {
+            m[column][row] = _mm_setr_ps(
+                (*models[0])[column][row], (*models[1])[column][row], (*models[2])[column][row],
+                (*models[3])[column][row]);
+        }
+    }
+
+    const auto cross = [](const __m128* u, const __m128* v, __m128* result) {
+        result[0] = _mm_sub_ps(_mm_mul_ps(u[1], v[2]), _mm_mul_ps(u[2], v[1]));
+        result[1] = _mm_sub_ps(_mm_mul_ps(u[2], v[0]), _mm_mul_ps(u[0], v[2]));
+        result[2] = _mm_sub_ps(_mm_mul_ps(u[0], v[1]), _mm_mul_ps(u[1], v[0]));
+    };
+
+    __m128 cofactor[3][3];
+    cross(m[1], m[2], cofactor[0]);
+    cross(m[2], m[0], cofactor[1]);
+    cross(m[0], m[1], cofactor[2]);
+
+    const __m128 det = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(m[0][0], cofactor[0][0]), _mm_mul_ps(m[0][1], cofactor[0][1])),
+        _mm_mul_ps(m[0][2], cofactor[0][2]));
+    const __m128 invDet = _mm_div_ps(_mm_set1_ps(1.0f), det);
+
+    for (int column = 0; column < 3; ++column) {
+        for (int row = 0; row < 3; ++row) {
+            alignas(16) float normal[4];
+            _mm_store_ps(normal, _mm_mul_ps(cofactor[column][row], invDet));
+            for (int lane = 0; lane < 4; ++lane) {
+                data[lane]->normalMatrix[column][row] = normal[lane];
+            }
+        }
+    }
+
+    for (int lane = 0; lane < 4; ++lane) {
+        data[lane]->model = *models[lane];
+        data[lane]->normalMatrix[0][3] = data[lane]->normalMatrix[1][3] =
+            data[lane]->normalMatrix[2][3] = 0.0f;
+    }
+}
+#endif
+
+ObjectDataBuffer::ObjectDataBuffer() {
+    glGenBuffers(1, &_buffer);
+    glGenTextures(1, &_texture);
+    RenderStatistics::get().onCreated(GLObjectType::Buffer);
+    RenderStatistics::get().onCreated(GLObjectType::Texture);
+    _memory = MemoryTracker::get().add(MemoryCategory::Buffer, 0);
+}
+
+ObjectDataBuffer::~ObjectDataBuffer() {
+    if (_texture != 0) {
+        GLStateCache::get().onTextureDeleted(_texture);
+        glDeleteTextures(1, &_texture);
+        RenderStatistics::get().onDeleted(GLObjectType::Texture);
+        _texture = 0;
+    }
+
+    if (_buffer != 0) {
+        glDeleteBuffers(1, &_buffer);
+        RenderStatistics::get().onDeleted(GLObjectType::Buffer);
+        _buffer = 0;
+    }
+
+    MemoryTracker::get().remove(_memory);
+}
+
+void ObjectDataBuffer::resize(size_t count) {
+    _sources.resize(count);
+    _valid.resize(count, false);
+    _data.resize(count);
+}
+
+size_t ObjectDataBuffer::size() const {
+    return _data.size();
+}
+
+void ObjectDataBuffer::update(uint32_t slot, const glm::mat4& model, const Material& material) {
+    Source& source = _sources[slot];
+    if (_valid[slot] && source.model == model && source.ka == material.ka
+        && source.kd == material.kd && source.ks == material.ks && source.ns == material.ns) {
+        return;
+    }
+
+    source.model = model;
+    source.ka = material.ka;
+    source.kd = material.kd;
+    source.ks = material.ks;
+    source.ns = material.ns;
+    _valid[slot] = true;
+    _dirtySlots.push_back(slot);
+}
+
+void ObjectDataBuffer::prepare() {
+    _updatedCount = _dirtySlots.size();
+
+    size_t i = 0;
+#ifdef OBJECT_DATA_SSE2
+    for (; i + 4 <= _dirtySlots.size(); i += 4) {
+        const glm::mat4* models[4];
+        ObjectData* data[4];
+        for (int lane = 0; lane < 4; ++lane) {
+            models[lane] = &_sources[_dirtySlots[i + lane]].model;
+            data[lane] = &_data[_dirtySlots[i + lane]];
+        }
+        computeMatrices4(models, data);
+    }
+#endif
+    for (; i < _dirtySlots.size(); ++i) {
+        computeMatrices(_sources[_dirtySlots[i]].model, _data[_dirtySlots[i]]);
+    }
+
+    for (const uint32_t slot : _dirtySlots) {
+        const Source& source = _sources[slot];
+        ObjectData& data = _data[slot];
+        data.kaNs = glm::vec4(source.ka, source.ns);
+        data.kd = glm::vec4(source.kd, 0.0f);
+        data.ks = glm::vec4(source.ks, 0.0f);
+
+        _uploadFirst = std::min(_uploadFirst, slot);
+        _uploadLast = std::max(_uploadLast, slot);
+    }
+    _dirtySlots.clear();
+}
+
+void ObjectDataBuffer::upload() {
+    const bool grow = _capacity < _data.size();
+    if (!grow && (_uploadFirst > _uploadLast || _data.empty())) {
+        _uploadFirst = ~0u;
+        _uploadLast = 0;
+        return;
+    }
+
+    glBindBuffer(GL_TEXTURE_BUFFER, _buffer);
+    if (grow) {
+        _capacity = std::max(_data.size(), _capacity * 2);
+        glBufferData(GL_TEXTURE_BUFFER, _capacity * sizeof(ObjectData), nullptr, GL_DYNAMIC_DRAW);
+        MemoryTracker::get().resize(_memory, _capacity * sizeof(ObjectData));
+        glBufferSubData(GL_TEXTURE_BUFFER, 0, _data.size() * sizeof(ObjectData), _data.data());
+        RenderStatistics::get().add(RenderCounter::BufferUploadBytes, _data.size() * sizeof(ObjectData));
+
+        GLStateCache::get().bindTexture(GL_TEXTURE_BUFFER, _texture);
+        glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, _buffer);
+    } else {
+        // slots past the end were removed since the range was recorded
+        const uint32_t last = std::min(_uploadLast, static_cast<uint32_t>(_data.size()) - 1);
+        if (_uploadFirst <= last) {
+            glBufferSubData(
+                GL_TEXTURE_BUFFER, _uploadFirst * sizeof(ObjectData),
+                (last - _uploadFirst + 1) * sizeof(ObjectData), &_data[_uploadFirst]);
+            RenderStatistics::get().add(
+                RenderCounter::BufferUploadBytes, (last - _uploadFirst + 1) * sizeof(ObjectData));
+        }
+    }
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    _uploadFirst = ~0u;
+    _uploadLast = 0;
+}
+
+const glm::mat4& ObjectDataBuffer::getModelMatrix(uint32_t slot) const {
+    return _data[slot].model;
+}
+
+void ObjectDataBuffer::bind(int slot) const {
+    GLStateCache::get().bindTexture(slot, GL_TEXTURE_BUFFER, _texture);
+}
+
+size_t ObjectDataBuffer::getUpdatedCount() const {
+    return _updatedCount;
+}
\ No newline at end of file
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "gl_utility.h"
+#include "memory_tracker.h"
+#include "model.h"
+
+// per-object record of the geometry pass, read in shader/geometry.vert as 10 rgba32f texels
+struct ObjectData {
+    glm::mat4 model;
+    // inverse transpose of the upper 3x3 part of model, w unused
+    glm::vec4 normalMatrix[3];
+    // ka in xyz, ns in w
+    glm::vec4 kaNs;
+    glm::vec4 kd;
+    glm::vec4 ks;
+
+    static constexpr int texelCount = 10;
+};
+
+static_assert(
+    sizeof(ObjectData) == ObjectData::texelCount * sizeof(glm::vec4),
+    "ObjectData must be tightly packed");
+
+// gpu copy of the per-object data, exposed to shaders as a texture buffer.
+// a slot is only recomputed and uploaded when its world matrix or material factors change.
+class ObjectDataBuffer {
+public:
+    ObjectDataBuffer();
+
+    ObjectDataBuffer(const ObjectDataBuffer&) = delete;
+
+    ~ObjectDataBuffer();
+
+    void resize(size_t count);
+
+    size_t size() const;
+
+    void update(uint32_t slot, const glm::mat4& model, const Material& material);
+
+    // compute the changed slots in one batch, touches no gl state so it can run on a worker
+    void prepare();
+
+    // send the slots changed by the prepare() calls since the last upload
+    void upload();
+
+    // valid after prepare()
+    const glm::mat4& getModelMatrix(uint32_t slot) const;
+
+    void bind(int slot) const;
+
+    // number of slots recomputed by the last prepare()
+    size_t getUpdatedCount() const;
+
+private:
+    struct Source {
+        glm::mat4 model;
+        glm::vec3 ka;
+        glm::vec3 kd;
+        glm::vec3 ks;
+        float ns;
+    };
+
+    std::vector<Source> _sources;
+    std::vector<bool> _valid;
+    std::vector<ObjectData> _data;
+    std::vector<uint32_t> _dirtySlots;
+    size_t _updatedCount = 0;
+
+    // slot range waiting for upload(), empty when first > last
+    uint32_t _uploadFirst = ~0u;
+    uint32_t _uploadLast = 0;
+
+    GLuint _buffer = 0;
+    GLuint _texture = 0;
+    size_t _capacity = 0;
+    MemoryTracker::Id _memory = MemoryTracker::invalidId;
+};
\ No newline at end of file
@@ -0,0 +1,343 @@
+#include <algorithm>
+#include <cmath>
+
+#include "job_system.h"
+#include "occlusion_rasterizer.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OCCLUSION_RASTERIZER_SSE2
+#endif
+
+// linear function of the pixel position, f(x, y) = a * x + b * y + c
+struct LinearFunction {
+    float a, b, c;
+};
+
+// positive on the left of a -> b, so inside of counter clockwise triangles
+static LinearFunction makeEdgeFunction(const glm::vec3& a, const glm::vec3& b) {
+    LinearFunction edge;
+    edge.a = a.y - b.y;
+    edge.b = b.x - a.x;
+    edge.c = -(edge.a * a.x + edge.b * a.y);
+    return edge;
+}
+
+OcclusionRasterizer::OcclusionRasterizer(int width, int height)
+    // rows are a multiple of 4 pixels so the simd loop never needs a scalar tail
+    : _width((std::max(width, 1) + 3) & ~3), _height(std::max(height, 1)) {
+    _tilesX = (_width + tileSize - 1) / tileSize;
+    _tilesY = (_height + tileSize - 1) / tileSize;
+    _bins.resize(_tilesX * _tilesY);
+
+    int levelWidth = _width, levelHeight = _height;
+    for (;;) {
+        _levels.push_back({levelWidth, levelHeight, std::vector<float>(levelWidth * levelHeight, 1.0f)});
+        if (levelWidth == 1 && levelHeight == 1) {
+            break;
+        }
+        levelWidth = std::max(levelWidth / 2, 1);
+        levelHeight = std::max(levelHeight / 2, 1);
+    }
+}
+
+void OcclusionRasterizer::beginFrame(const glm::mat4& viewProjection) {
+    _viewProjection = viewProjection;
+    _triangles.clear();
+    for (auto& bin : _bins) {
+        bin.clear();
+    }
+
+    std::fill(_levels[0].depth.begin(), _levels[0].depth.end(), 1.0f);
+}
+
+void OcclusionRasterizer::addOccluder(
+    const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices,
+    const glm::mat4& modelMatrix) {
+    const glm::mat4 transform = _viewProjection * modelMatrix;
+
+    _clipVertices.resize(vertices.size());
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        _clipVertices[i] = transform * glm::vec4(vertices[i].position, 1.0f);
+    }
+
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        const glm::vec4& a = _clipVertices[indices[i]];
+        const glm::vec4& b = _clipVertices[indices[i + 1]];
+        const glm::vec4& c = _clipVertices[indices[i + 2]];
+
+        // trivially outside one of the side planes
+        if ((a.x > a.w && b.x > b.w && c.x > c.w) || (a.x < -a.w && b.x < -b.w && c.x < -c.w)
+            || (a.y > a.w && b.y > b.w && c.y > c.w)
+            || (a.y < -a.w && b.y < -b.w && c.y < -c.w)) {
+            continue;
+        }
+
+        const int inside = (a.z >= -a.w) + (b.z >= -b.w) + (c.z >= -c.w);
+        if (inside == 3) {
+            addTriangle(a, b, c);
+        } else if (inside > 0) {
+            addClippedTriangle(a, b, c);
+        }
+    }
+}
+
+void OcclusionRasterizer::rasterize() {
+    if (!_triangles.empty()) {
+        // every tile only writes its own pixels
+        JobSystem::get().parallelFor(_tilesX * _tilesY, 1, [this](size_t begin, size_t end) {
+            for (size_t tile = begin; tile < end; ++tile) {
+                rasterizeTile(static_cast<int>(tile));
+            }
+        });
+    }
+
+    buildPyramid();
+}
+
+bool OcclusionRasterizer::isVisible(const BoundingBox& worldBox) const {
+    glm::vec2 minPos = glm::vec2(std::numeric_limits<float>::max());
+    glm::vec2 maxPos = -minPos;
+    float minDepth = 1.0f;
+
+    for (int i = 0; i < 8; ++i) {
+        const glm::vec3 corner = glm::vec3(
+            (i & 1) ? worldBox.max.x : worldBox.min.x, (i & 2) ? worldBox.max.y : worldBox.min.y,
+            (i & 4) ? worldBox.max.z : worldBox.min.z);
+        const glm::vec4 clip = _viewProjection * glm::vec4(corner, 1.0f);
+
+        // the box crosses the near plane, nothing in front of it can be trusted
+        if (clip.w <= 0.0f || clip.z < -clip.w) {
+            return true;
+        }
+
+        const glm::vec3 ndc = glm::vec3(clip) / clip.w;
+        const glm::vec2 pos = (glm::vec2(ndc) * 0.5f + 0.5f) * glm::vec2(_width, _height);
+        minPos = glm::min(minPos, pos);
+        maxPos = glm::max(maxPos, pos);
+        minDepth = std::min(minDepth, ndc.z * 0.5f + 0.5f);
+    }
+
+    // off screen boxes are left to the frustum test
+    if (maxPos.x < 0.0f || maxPos.y < 0.0f || minPos.x >= _width || minPos.y >= _height) {
+        return true;
+    }
+
+    const int x0 = std::max(static_cast<int>(minPos.x), 0);
+    const int y0 = std::max(static_cast<int>(minPos.y), 0);
+    const int x1 = std::min(static_cast<int>(maxPos.x), _width - 1);
+    const int y1 = std::min(static_cast<int>(maxPos.y), _height - 1);
+
+    // the coarsest level where the rectangle spans at most 2x2 texels
+    int level = 0;
+    while (level + 1 < static_cast<int>(_levels.size())
+           && ((x1 >> level) - (x0 >> level) > 1 || (y1 >> level) - (y0 >> level) > 1)) {
+        ++level;
+    }
+
+    const Level& hiZ = _levels[level];
+    const int tx0 = std::min(x0 >> level, hiZ.width - 1);
+    const int ty0 = std::min(y0 >> level, hiZ.height - 1);
+    const int tx1 = std::min(x1 >> level, hiZ.width - 1);
+    const int ty1 = std::min(y1 >> level, hiZ.height - 1);
+
+    float maxDepth = 0.0f;
+    for (int y = ty0; y <= ty1; ++y) {
+        for (int x = tx0; x <= tx1; ++x) {
+            maxDepth = std::max(maxDepth, hiZ.depth[y * hiZ.width + x]);
+        }
+    }
+
+    return minDepth <= maxDepth;
+}
+
+int OcclusionRasterizer::getWidth() const {
+    return _width;
+}
+
+int OcclusionRasterizer::getHeight() const {
+    return _height;
+}
+
+size_t OcclusionRasterizer::getTriangleCount() const {
+    return _triangles.size();
+}
+
+const std::vector<float>& OcclusionRasterizer::getDepthBuffer() const {
+    return _levels[0].depth;
+}
+
+void OcclusionRasterizer::addTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c) {
+    Triangle triangle;
+    const glm::vec4* clip[3] = {&a, &b, &c};
+    for (int i = 0; i < 3; ++i) {
+        const glm::vec3 ndc = glm::vec3(*clip[i]) / clip[i]->w;
+        triangle.v[i] = glm::vec3(
+            (ndc.x * 0.5f + 0.5f) * _width, (ndc.y * 0.5f + 0.5f) * _height, ndc.z * 0.5f + 0.5f);
+    }
+
+    // the rasterizer expects counter clockwise corners, occluders are drawn from both sides
+    const glm::vec3& v0 = triangle.v[0];
+    const glm::vec3& v1 = triangle.v[1];
+    const glm::vec3& v2 = triangle.v[2];
+    const float area = (v1.x - v0.x) * (v2.y - v0.y) - (v1.y - v0.y) * (v2.x - v0.x);
+    if (std::abs(area) < 1e-6f) {
+        return;
+    }
+
+    if (area < 0.0f) {
+        std::swap(triangle.v[1], triangle.v[2]);
+    }
+
+    const float minX = std::min({v0.x, v1.x, v2.x});
+    const float maxX = std::max({v0.x, v1.x, v2.x});
+    const float minY = std::min({v0.y, v1.y, v2.y});
+    const float maxY = std::max({v0.y, v1.y, v2.y});
+    if (maxX < 0.0f || maxY < 0.0f || minX >= _width || minY >= _height) {
+        return;
+    }
+
+    const int tileX0 = std::max(static_cast<int>(minX), 0) / tileSize;
+    const int tileY0 = std::max(static_cast<int>(minY), 0) / tileSize;
+    const int tileX1 = std::min(static_cast<int>(maxX), _width - 1) / tileSize;
+    const int tileY1 = std::min(static_cast<int>(maxY), _height - 1) / tileSize;
+
+    const uint32_t index = static_cast<uint32_t>(_triangles.size());
+    _triangles.push_back(triangle);
+    for (int ty = tileY0; ty <= tileY1; ++ty) {
+        for (int tx = tileX0; tx <= tileX1; ++tx) {
+            _bins[ty * _tilesX + tx].push_back(index);
+        }
+    }
+}
+
+void OcclusionRasterizer::addClippedTriangle(
+    const glm::vec4& a, const glm::vec4& b, const glm::vec4& c) {
+    // sutherland-hodgman against the near plane z = -w, a triangle becomes at most a quad
+    const glm::vec4 input[3] = {a, b, c};
+    glm::vec4 output[4];
+    int count = 0;
+
+    for (int i = 0; i < 3; ++i) {
+        const glm::vec4& current = input[i];
+        const glm::vec4& next = input[(i + 1) % 3];
+        const float currentDistance = current.z + current.w;
+        const float nextDistance = next.z + next.w;
+
+        if (currentDistance >= 0.0f) {
+            output[count++] = current;
+        }
+
+        if ((currentDistance >= 0.0f) != (nextDistance >= 0.0f)) {
+            const float t = currentDistance / (currentDistance - nextDistance);
+            output[count++] = current + (next - current) * t;
+        }
+    }
+
+    for (int i = 1; i + 1 < count; ++i) {
+        addTriangle(output[0], output[i], output[i + 1]);
+    }
+}
+
+void OcclusionRasterizer::rasterizeTile(int tile) {
+    const std::vector<uint32_t>& bin = _bins[tile];
+    if (bin.empty()) {
+        return;
+    }
+
+    const int tileX = (tile % _tilesX) * tileSize;
+    const int tileY = (tile / _tilesX) * tileSize;
+    const int tileX1 = std::min(tileX + tileSize, _width);
+    const int tileY1 = std::min(tileY + tileSize, _height);
+    float* depthBuffer = _levels[0].depth.data();
+
+    for (const uint32_t index : bin) {
+        const Triangle& triangle = _triangles[index];
+        const glm::vec3& v0 = triangle.v[0];
+        const glm::vec3& v1 = triangle.v[1];
+        const glm::vec3& v2 = triangle.v[2];
+
+        const LinearFunction e0 = makeEdgeFunction(v1, v2);
+        const LinearFunction e1 = makeEdgeFunction(v2, v0);
+        const LinearFunction e2 = makeEdgeFunction(v0, v1);
+
+        // the barycentric weights sum up to the doubled area
+        const float invArea = 1.0f / (e0.a * v0.x + e0.b * v0.y + e0.c);
+        LinearFunction z;
+        z.a = (e0.a * v0.z + e1.a * v1.z + e2.a * v2.z) * invArea;
+        z.b = (e0.b * v0.z + e1.b * v1.z + e2.b * v2.z) * invArea;
+        z.c = (e0.c * v0.z + e1.c * v1.z + e2.c * v2.z) * invArea;
+
+        const int x0 = std::max(static_cast<int>(std::min({v0.x, v1.x, v2.x})), tileX) & ~3;
+        const int y0 = std::max(static_cast<int>(std::min({v0.y, v1.y, v2.y})), tileY);
+        const int x1 = std::min(static_cast<int>(std::max({v0.x, v1.x, v2.x})) + 1, tileX1);
+        const int y1 = std::min(static_cast<int>(std::max({v0.y, v1.y, v2.y})) + 1, tileY1);
+
+        for (int y = y0; y < y1; ++y) {
+            const float py = y + 0.5f;
+            const float row0 = e0.b * py + e0.c;
+            const float row1 = e1.b * py + e1.c;
+            const float row2 = e2.b * py + e2.c;
+            const float rowZ = z.b * py + z.c;
+            float* depthRow = depthBuffer + y * _width;
+
+#ifdef OCCLUSION_RASTERIZER_SSE2
+            const __m128 laneOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+            const __m128 zero = _mm_setzero_ps();
+            for (int x = x0; x < x1; x += 4) {
+                const __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), laneOffsets);
+                const __m128 w0 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(e0.a), px), _mm_set1_ps(row0));
+                const __m128 w1 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(e1.a), px), _mm_set1_ps(row1));
+                const __m128 w2 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(e2.a), px), _mm_set1_ps(row2));
+
+                // strictly inside only, shared edges may leave holes but never grow occluders
+                const __m128 inside = _mm_and_ps(
+                    _mm_and_ps(_mm_cmpgt_ps(w0, zero), _mm_cmpgt_ps(w1, zero)),
+                    _mm_cmpgt_ps(w2, zero));
+                if (_mm_movemask_ps(inside) == 0) {
+                    continue;
+                }
+
+                const __m128 depth = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(z.a), px), _mm_set1_ps(rowZ));
+                const __m128 current = _mm_loadu_ps(depthRow + x);
+                const __m128 nearest = _mm_min_ps(current, depth);
+                _mm_storeu_ps(
+                    depthRow + x,
+                    _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, current)));
+            }
+#else
+            for (int x = x0; x < x1; ++x) {
+                const float px = x + 0.5f;
+                if (e0.a * px + row0 > 0.0f && e1.a * px + row1 > 0.0f && e2.a * px + row2 > 0.0f) {
+                    depthRow[x] = std::min(depthRow[x], z.a * px + rowZ);
+                }
+            }
+#endif
+        }
+    }
+}
+
+void OcclusionRasterizer::buildPyramid() {
+    for (size_t i = 1; i < _levels.size(); ++i) {
+        const Level& src = _levels[i - 1];
+        Level& dst = _levels[i];
+
+        for (int y = 0; y < dst.height; ++y) {
+            // odd sizes fold the last row and column into the last texel
+            const int sy0 = y * 2;
+            const int sy1 = y == dst.height - 1 ? src.height - 1 : std::min(sy0 + 1, src.height - 1);
+            for (int x = 0; x < dst.width; ++x) {
+                const int sx0 = x * 2;
+                const int sx1 = x == dst.width - 1 ? src.width - 1 : std::min(sx0 + 1, src.width - 1);
+
+                float depth = 0.0f;
+                for (int sy = sy0; sy <= sy1; ++sy) {
+                    for (int sx = sx0; sx <= sx1; ++sx) {
+                        depth = std::max(depth, src.depth[sy * src.width + sx]);
+                    }
+                }
+                dst.depth[y * dst.width + x] = depth;
+            }
+        }
+    }
+}
\ No newline at end of file
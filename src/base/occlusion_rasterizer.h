@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "bounding_box.h"
+#include "vertex.h"
+
+// low resolution software depth buffer for occlusion culling on the cpu.
+// occluder triangles are binned into screen tiles and the tiles are rasterized as jobs,
+// then a max-depth pyramid answers conservative visibility queries for world space boxes.
+// the results only depend on the submitted geometry, not on the thread count.
+class OcclusionRasterizer {
+public:
+    static constexpr int tileSize = 32;
+
+    OcclusionRasterizer(int width, int height);
+
+    OcclusionRasterizer(const OcclusionRasterizer&) = delete;
+
+    void beginFrame(const glm::mat4& viewProjection);
+
+    void addOccluder(
+        const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices,
+        const glm::mat4& modelMatrix);
+
+    // rasterize the occluders added since beginFrame() and build the depth pyramid
+    void rasterize();
+
+    // false only when the box is certainly hidden behind the occluders
+    bool isVisible(const BoundingBox& worldBox) const;
+
+    int getWidth() const;
+
+    int getHeight() const;
+
+    size_t getTriangleCount() const;
+
+    // level 0 of the depth pyramid, normalized depth in [0, 1], row 0 at the bottom
+    const std::vector<float>& getDepthBuffer() const;
+
+private:
+    struct Triangle {
+        // screen space x, y and normalized depth of the three corners
+        glm::vec3 v[3];
+    };
+
+    struct Level {
+        int width;
+        int height;
+        std::vector<float> depth;
+    };
+
+    int _width;
+    int _height;
+    int _tilesX;
+    int _tilesY;
+
+    glm::mat4 _viewProjection = glm::mat4(1.0f);
+
+    std::vector<Triangle> _triangles;
+    std::vector<std::vector<uint32_t>> _bins;
+    std::vector<Level> _levels;
+
+    std::vector<glm::vec4> _clipVertices;
+
+    void addTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c);
+
+    void addClippedTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c);
+
+    void rasterizeTile(int tile);
+
+    void buildPyramid();
+};
\ No newline at end of file
@@ -0,0 +1,204 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "frame_allocator.h"
+#include "profiler.h"
+#include "render_statistics.h"
+
+static float getLast(const std::vector<float>& history, size_t next, size_t count) {
+    return count == 0 ? 0.0f : history[(next + history.size() - 1) % history.size()];
+}
+
+float Profiler::Pass::getLastCpuTime() const {
+    return getLast(cpuHistory, cpuNext, cpuCount);
+}
+
+float Profiler::Pass::getLastGpuTime() const {
+    return getLast(gpuHistory, gpuNext, gpuCount);
+}
+
+double Profiler::Pass::getMeanCpuTime() const {
+    return cpuTotalCount == 0 ? 0.0 : cpuTotal / cpuTotalCount;
+}
+
+double Profiler::Pass::getMeanGpuTime() const {
+    return gpuTotalCount == 0 ? 0.0 : gpuTotal / gpuTotalCount;
+}
+
+Profiler& Profiler::get() {
+    static Profiler profiler;
+    return profiler;
+}
+
+void Profiler::setEnabled(bool enabled) {
+    _enabled = enabled;
+}
+
+bool Profiler::isEnabled() const {
+    return _enabled;
+}
+
+void Profiler::beginFrame() {
+    // a gpu running behind must not stall the cpu, so a result is only read once available.
+    // both sets are polled oldest first, a set that was busy last frame is collected as soon as
+    // it is done
+    for (Pass& pass : _passes) {
+        for (uint64_t i = 0; i < 2; ++i) {
+            const int set = static_cast<int>((_frame + i) & 1);
+            if (!pass.queryPending[set]) {
+                continue;
+            }
+
+            GLuint available = GL_FALSE;
+            glGetQueryObjectuiv(pass.queries[set], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (available == GL_FALSE) {
+                continue;
+            }
+
+            GLuint64 elapsed = 0;
+            glGetQueryObjectui64v(pass.queries[set], GL_QUERY_RESULT, &elapsed);
+            pass.queryPending[set] = false;
+            if (pass.queryFrame[set] < _resetFrame) {
+                continue;
+            }
+
+            const float time = static_cast<float>(elapsed * 1e-6);
+            push(pass.gpuHistory, pass.gpuNext, pass.gpuCount, time);
+            pass.gpuTotal += time;
+            ++pass.gpuTotalCount;
+        }
+    }
+}
+
+void Profiler::endFrame() {
+    for (Pass& pass : _passes) {
+        if (pass.ranThisFrame) {
+            push(pass.cpuHistory, pass.cpuNext, pass.cpuCount, pass.cpuFrameTime);
+            pass.cpuTotal += pass.cpuFrameTime;
+            ++pass.cpuTotalCount;
+            pass.cpuFrameTime = 0.0f;
+            pass.ranThisFrame = false;
+        }
+    }
+
+    ++_frame;
+}
+
+int Profiler::begin(const char* name, bool gpu) {
+    const int index = findPass(name, gpu);
+    Pass& pass = _passes[index];
+    TraceRecorder::get().begin(pass.traceName);
+    if (!_enabled) {
+        return index;
+    }
+
+    pass.ranThisFrame = true;
+    pass.open = true;
+
+    // one query per pass and frame, a repeated pass is timed on the cpu only
+    const int set = static_cast<int>(_frame & 1);
+    if (pass.gpu && _gpuPass < 0 && !pass.queryPending[set]) {
+        if (pass.queries[set] == 0) {
+            glGenQueries(2, pass.queries);
+            RenderStatistics::get().onCreated(GLObjectType::Query, 2);
+        }
+        glBeginQuery(GL_TIME_ELAPSED, pass.queries[set]);
+        pass.queryPending[set] = true;
+        pass.queryFrame[set] = _frame;
+        _gpuPass = index;
+    }
+
+    pass.cpuBegin = std::chrono::high_resolution_clock::now();
+
+    return index;
+}
+
+void Profiler::end(int index) {
+    Pass& pass = _passes[index];
+    TraceRecorder::get().end(pass.traceName);
+    if (!pass.open) {
+        return;
+    }
+
+    pass.open = false;
+    pass.cpuFrameTime += std::chrono::duration<float, std::milli>(
+        std::chrono::high_resolution_clock::now() - pass.cpuBegin).count();
+
+    if (_gpuPass == index) {
+        glEndQuery(GL_TIME_ELAPSED);
+        _gpuPass = -1;
+    }
+}
+
+const std::vector<Profiler::Pass>& Profiler::getPasses() const {
+    return _passes;
+}
+
+float Profiler::getPercentile(const std::vector<float>& history, size_t count, float p) {
+    if (count == 0) {
+        return 0.0f;
+    }
+
+    // the ring is filled from the front, a partial one holds its samples in [0, count)
+    FrameVector<float> samples(history.begin(), history.begin() + count);
+    const size_t rank = std::min(
+        static_cast<size_t>(std::ceil(p / 100.0f * count)), count) - (p > 0.0f ? 1 : 0);
+    std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+
+    return samples[rank];
+}
+
+void Profiler::reset() {
+    for (Pass& pass : _passes) {
+        clear(pass);
+    }
+    _resetFrame = _frame;
+}
+
+void Profiler::release() {
+    if (_gpuPass >= 0) {
+        glEndQuery(GL_TIME_ELAPSED);
+        _gpuPass = -1;
+    }
+
+    for (Pass& pass : _passes) {
+        if (pass.queries[0] != 0) {
+            glDeleteQueries(2, pass.queries);
+            RenderStatistics::get().onDeleted(GLObjectType::Query, 2);
+        }
+        pass.queries[0] = pass.queries[1] = 0;
+        pass.queryPending[0] = pass.queryPending[1] = false;
+    }
+}
+
+int Profiler::findPass(const char* name, bool gpu) {
+    // a handful of passes, a linear search is cheaper than hashing the name
+    for (size_t i = 0; i < _passes.size(); ++i) {
+        if (std::strcmp(_passes[i].name.c_str(), name) == 0) {
+            return static_cast<int>(i);
+        }
+    }
+
+    _passes.emplace_back();
+    _passes.back().name = name;
+    _passes.back().traceName = name;
+    _passes.back().gpu = gpu;
+
+    return static_cast<int>(_passes.size() - 1);
+}
+
+void Profiler::clear(Pass& pass) {
+    std::fill(pass.cpuHistory.begin(), pass.cpuHistory.end(), 0.0f);
+    std::fill(pass.gpuHistory.begin(), pass.gpuHistory.end(), 0.0f);
+    pass.cpuNext = pass.gpuNext = 0;
+    pass.cpuCount = pass.gpuCount = 0;
+    pass.cpuTotal = pass.gpuTotal = 0.0;
+    pass.cpuTotalCount = pass.gpuTotalCount = 0;
+}
+
+void Profiler::push(std::vector<float>& history, size_t& next, size_t& count, float value) {
+    history[next] = value;
+    next = (next + 1) % history.size();
+    count = std::min(count + 1, history.size());
+}
\ No newline at end of file
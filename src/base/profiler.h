@@ -0,0 +1,120 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "gl_utility.h"
+#include "trace_recorder.h"
+
+// named passes timed on the cpu and, through GL_TIME_ELAPSED queries, on the gpu.
+// each pass owns two queries used on alternate frames. a result is read at the start of a
+// frame once the gpu has it, usually two frames after it was issued, and never waited for:
+// while the query of a frame is still pending the pass is timed on the cpu only. elapsed time
+// queries cannot nest, a pass begun while another gpu pass is open is timed on the cpu only.
+// gl thread only.
+// every pass is also a begin and end event of the trace recorder.
+class Profiler {
+public:
+    // samples kept per pass
+    static constexpr size_t historySize = 240;
+
+    struct Pass {
+        std::string name;
+        // the name passed to begin(), the trace recorder keeps the pointer
+        const char* traceName = nullptr;
+        // ring of the last historySize samples in milliseconds, next is the oldest one
+        std::vector<float> cpuHistory = std::vector<float>(historySize, 0.0f);
+        std::vector<float> gpuHistory = std::vector<float>(historySize, 0.0f);
+        size_t cpuNext = 0;
+        size_t gpuNext = 0;
+        size_t cpuCount = 0;
+        size_t gpuCount = 0;
+
+        // every sample since the last reset
+        double cpuTotal = 0.0;
+        double gpuTotal = 0.0;
+        size_t cpuTotalCount = 0;
+        size_t gpuTotalCount = 0;
+
+        // accumulated over the current frame, a pass may run several times
+        float cpuFrameTime = 0.0f;
+        bool ranThisFrame = false;
+        bool open = false;
+        std::chrono::time_point<std::chrono::high_resolution_clock> cpuBegin;
+
+        bool gpu = false;
+        GLuint queries[2] = {0, 0};
+        bool queryPending[2] = {false, false};
+        uint64_t queryFrame[2] = {0, 0};
+
+        float getLastCpuTime() const;
+        float getLastGpuTime() const;
+        double getMeanCpuTime() const;
+        double getMeanGpuTime() const;
+    };
+
+    static Profiler& get();
+
+    Profiler(const Profiler&) = delete;
+
+    Profiler& operator=(const Profiler&) = delete;
+
+    void setEnabled(bool enabled);
+
+    bool isEnabled() const;
+
+    // collects the gpu results of the previous frame
+    void beginFrame();
+
+    // pushes the cpu times of the frame to the history
+    void endFrame();
+
+    // the index identifies the pass in end(). passes are also traced while the profiler is disabled
+    int begin(const char* name, bool gpu);
+
+    void end(int pass);
+
+    const std::vector<Pass>& getPasses() const;
+
+    // forget the samples so far, gpu results of earlier frames still in flight are dropped
+    void reset();
+
+    // the p-th percentile of the recorded samples, p in [0, 100]
+    static float getPercentile(const std::vector<float>& history, size_t count, float p);
+
+    // delete the queries, must be called while the context is alive
+    void release();
+
+private:
+    std::vector<Pass> _passes;
+    bool _enabled = true;
+    uint64_t _frame = 0;
+    uint64_t _resetFrame = 0;
+    // the pass whose elapsed time query is open
+    int _gpuPass = -1;
+
+    Profiler() = default;
+
+    int findPass(const char* name, bool gpu);
+
+    static void push(std::vector<float>& history, size_t& next, size_t& count, float value);
+
+    static void clear(Pass& pass);
+};
+
+// times the enclosing block as a pass of the profiler
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name, bool gpu = true) : _pass(Profiler::get().begin(name, gpu)) {}
+
+    ProfileScope(const ProfileScope&) = delete;
+
+    ~ProfileScope() {
+        Profiler::get().end(_pass);
+    }
+
+private:
+    const int _pass;
+};
\ No newline at end of file
@@ -0,0 +1,105 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "qoi_writer.h"
+
+// https://qoiformat.org/qoi-specification.pdf
+enum QoiTag : uint8_t {
+    QoiIndex = 0x00,
+    QoiDiff = 0x40,
+    QoiLuma = 0x80,
+    QoiRun = 0xc0,
+    QoiRGB = 0xfe,
+    QoiRGBA = 0xff
+};
+
+static void writeBigEndian(std::vector<uint8_t>& bytes, uint32_t value) {
+    bytes.push_back(static_cast<uint8_t>(value >> 24));
+    bytes.push_back(static_cast<uint8_t>(value >> 16));
+    bytes.push_back(static_cast<uint8_t>(value >> 8));
+    bytes.push_back(static_cast<uint8_t>(value));
+}
+
+bool writeQoi(const std::string& filepath, int width, int height, const unsigned char* pixels, int strideBytes) {
+    std::vector<uint8_t> bytes;
+    bytes.reserve(14 + static_cast<size_t>(width) * height * 5 + 8);
+
+    bytes.insert(bytes.end(), {'q', 'o', 'i', 'f'});
+    writeBigEndian(bytes, static_cast<uint32_t>(width));
+    writeBigEndian(bytes, static_cast<uint32_t>(height));
+    // 4 channels, srgb with linear alpha
+    bytes.push_back(4);
+    bytes.push_back(0);
+
+    uint8_t seen[64][4] = {};
+    uint8_t previous[4] = {0, 0, 0, 255};
+    int run = 0;
+
+    for (int y = 0; y < height; ++y) {
+        const unsigned char* row = pixels + static_cast<ptrdiff_t>(y) * strideBytes;
+        for (int x = 0; x < width; ++x) {
+            const uint8_t* pixel = row + x * 4;
+            const bool same = pixel[0] == previous[0] && pixel[1] == previous[1]
+                              && pixel[2] == previous[2] && pixel[3] == previous[3];
+            if (same) {
+                if (++run == 62) {
+                    bytes.push_back(QoiRun | (run - 1));
+                    run = 0;
+                }
+                continue;
+            }
+
+            if (run > 0) {
+                bytes.push_back(QoiRun | (run - 1));
+                run = 0;
+            }
+
+            const int hash = (pixel[0] * 3 + pixel[1] * 5 + pixel[2] * 7 + pixel[3] * 11) % 64;
+            if (seen[hash][0] == pixel[0] && seen[hash][1] == pixel[1] && seen[hash][2] == pixel[2]
+                && seen[hash][3] == pixel[3]) {
+                bytes.push_back(QoiIndex | hash);
+            } else {
+                for (int i = 0; i < 4; ++i) {
+                    seen[hash][i] = pixel[i];
+                }
+
+                if (pixel[3] == previous[3]) {
+                    const int8_t dr = static_cast<int8_t>(pixel[0] - previous[0]);
+                    const int8_t dg = static_cast<int8_t>(pixel[1] - previous[1]);
+                    const int8_t db = static_cast<int8_t>(pixel[2] - previous[2]);
+                    const int8_t drg = static_cast<int8_t>(dr - dg);
+                    const int8_t dbg = static_cast<int8_t>(db - dg);
+
+                    if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1) {
+                        bytes.push_back(QoiDiff | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2));
+                    } else if (drg >= -8 && drg <= 7 && dg >= -32 && dg <= 31 && dbg >= -8 && dbg <= 7) {
+                        bytes.push_back(QoiLuma | (dg + 32));
+                        bytes.push_back(static_cast<uint8_t>((drg + 8) << 4 | (dbg + 8)));
+                    } else {
+                        bytes.insert(bytes.end(), {QoiRGB, pixel[0], pixel[1], pixel[2]});
+                    }
+                } else {
+                    bytes.insert(bytes.end(), {QoiRGBA, pixel[0], pixel[1], pixel[2], pixel[3]});
+                }
+            }
+
+            for (int i = 0; i < 4; ++i) {
+                previous[i] = pixel[i];
+            }
+        }
+    }
+
+    if (run > 0) {
+        bytes.push_back(QoiRun | (run - 1));
+    }
+    bytes.insert(bytes.end(), {0, 0, 0, 0, 0, 0, 0, 1});
+
+    FILE* file = std::fopen(filepath.c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    const bool written = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    return std::fclose(file) == 0 && written;
+}
\ No newline at end of file
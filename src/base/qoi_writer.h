@@ -0,0 +1,7 @@
+#pragma once
+
+#include <string>
+
+// write rgba8 pixels in the qoi format, which encodes several times faster than png at a
+// similar size for rendered images. strideBytes may be negative to walk the rows backwards.
+bool writeQoi(const std::string& filepath, int width, int height, const unsigned char* pixels, int strideBytes);
\ No newline at end of file
@@ -0,0 +1,328 @@
+#include <algorithm>
+#include <cfloat>
+#include <iostream>
+#include <vector>
+
+#include <stb_image_write.h>
+
+#include "gl_state_cache.h"
+#include "qoi_writer.h"
+#include "readback_service.h"
+#include "render_statistics.h"
+#include "trace_recorder.h"
+
+static size_t getPixelSize(ReadbackFormat format) {
+    switch (format) {
+    case ReadbackFormat::Color: return 4 * sizeof(unsigned char);
+    case ReadbackFormat::Depth: return sizeof(float);
+    case ReadbackFormat::FloatColor: return 3 * sizeof(float);
+    }
+
+    return 0;
+}
+
+static bool hasExtension(const std::string& filepath, const std::string& extension) {
+    return filepath.size() >= extension.size()
+           && filepath.compare(filepath.size() - extension.size(), extension.size(), extension) == 0;
+}
+
+ReadbackService& ReadbackService::get() {
+    static ReadbackService service;
+    return service;
+}
+
+ReadbackService::ReadbackService() {
+    setCapacity(4);
+}
+
+void ReadbackService::setCapacity(size_t capacity) {
+    finish();
+
+    capacity = std::max<size_t>(capacity, 1);
+    for (size_t i = capacity; i < _slots.size(); ++i) {
+        if (_slots[i]->buffer != 0) {
+            glDeleteBuffers(1, &_slots[i]->buffer);
+            RenderStatistics::get().onDeleted(GLObjectType::Buffer);
+            MemoryTracker::get().remove(_slots[i]->memory);
+        }
+    }
+    _slots.resize(capacity);
+    for (auto& slot : _slots) {
+        if (slot == nullptr) {
+            slot.reset(new Slot);
+        }
+    }
+    _nextSlot = 0;
+}
+
+size_t ReadbackService::getCapacity() const {
+    return _slots.size();
+}
+
+void ReadbackService::readFramebuffer(
+    GLuint framebuffer, ReadbackFormat format, int width, int height, const std::string& filepath) {
+    Slot& slot = acquire(static_cast<size_t>(width) * height * getPixelSize(format));
+    slot.format = format;
+    slot.width = width;
+    slot.height = height;
+    slot.filepath = filepath;
+
+    // the pack buffer is bound, so the pixels go to offset 0 of it
+    GLStateCache::get().bindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+    switch (format) {
+    case ReadbackFormat::Color:
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        break;
+    case ReadbackFormat::Depth:
+        glReadPixels(0, 0, width, height, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+        break;
+    case ReadbackFormat::FloatColor:
+        glReadPixels(0, 0, width, height, GL_RGB, GL_FLOAT, nullptr);
+        break;
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.state = SlotState::Transferring;
+}
+
+void ReadbackService::readTexture(
+    GLuint texture, ReadbackFormat format, int width, int height, const std::string& filepath) {
+    Slot& slot = acquire(static_cast<size_t>(width) * height * getPixelSize(format));
+    slot.format = format;
+    slot.width = width;
+    slot.height = height;
+    slot.filepath = filepath;
+
+    GLStateCache::get().bindTexture(GL_TEXTURE_2D, texture);
+    switch (format) {
+    case ReadbackFormat::Color:
+        glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        break;
+    case ReadbackFormat::Depth:
+        glGetTexImage(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+        break;
+    case ReadbackFormat::FloatColor:
+        glGetTexImage(GL_TEXTURE_2D, 0, GL_RGB, GL_FLOAT, nullptr);
+        break;
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.state = SlotState::Transferring;
+}
+
+void ReadbackService::update() {
+    for (auto& slot : _slots) {
+        advance(*slot, false);
+    }
+}
+
+void ReadbackService::finish() {
+    for (auto& slot : _slots) {
+        advance(*slot, true);
+    }
+}
+
+void ReadbackService::release() {
+    finish();
+
+    for (auto& slot : _slots) {
+        if (slot->buffer != 0) {
+            glDeleteBuffers(1, &slot->buffer);
+            RenderStatistics::get().onDeleted(GLObjectType::Buffer);
+            MemoryTracker::get().remove(slot->memory);
+            slot->buffer = 0;
+            slot->capacity = 0;
+            slot->memory = MemoryTracker::invalidId;
+        }
+    }
+}
+
+size_t ReadbackService::getPendingCount() const {
+    return std::count_if(_slots.begin(), _slots.end(), [](const std::unique_ptr<Slot>& slot) {
+        return slot->state != SlotState::Free;
+    });
+}
+
+size_t ReadbackService::getWrittenCount() const {
+    return _writtenCount;
+}
+
+size_t ReadbackService::getFailedCount() const {
+    return _failedCount;
+}
+
+size_t ReadbackService::getPeakBytes() const {
+    return _peakBytes;
+}
+
+void ReadbackService::resetPeakBytes() {
+    _peakBytes = _busyBytes;
+}
+
+ReadbackService::Slot& ReadbackService::acquire(size_t size) {
+    for (;;) {
+        for (size_t i = 0; i < _slots.size(); ++i) {
+            const size_t index = (_nextSlot + i) % _slots.size();
+            Slot& slot = *_slots[index];
+            if (slot.state != SlotState::Free) {
+                continue;
+            }
+
+            if (slot.buffer == 0) {
+                glGenBuffers(1, &slot.buffer);
+                RenderStatistics::get().onCreated(GLObjectType::Buffer);
+                MemoryOwnerScope owner("readback");
+                slot.memory = MemoryTracker::get().add(MemoryCategory::Buffer, 0);
+            }
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+            if (slot.capacity < size) {
+                glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);
+                slot.capacity = size;
+                MemoryTracker::get().resize(slot.memory, size);
+            }
+
+            _busyBytes += slot.capacity;
+            _peakBytes = std::max(_peakBytes, _busyBytes);
+
+            _nextSlot = (index + 1) % _slots.size();
+            return slot;
+        }
+
+        // round robin makes the next slot the oldest one
+        advance(*_slots[_nextSlot], true);
+    }
+}
+
+void ReadbackService::free(Slot& slot) {
+    _busyBytes -= slot.capacity;
+    slot.state = SlotState::Free;
+}
+
+void ReadbackService::advance(Slot& slot, bool blocking) {
+    if (slot.state == SlotState::Transferring) {
+        GLenum result;
+        do {
+            result = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, blocking ? 1000000000 : 0);
+        } while (blocking && result == GL_TIMEOUT_EXPIRED);
+
+        if (result == GL_TIMEOUT_EXPIRED) {
+            return;
+        }
+
+        // on GL_WAIT_FAILED mapping still waits for the transfer
+        glDeleteSync(slot.fence);
+        slot.fence = nullptr;
+        startEncoding(slot);
+    }
+
+    if (slot.state == SlotState::Encoding) {
+        if (blocking) {
+            JobSystem::get().wait(slot.encoded);
+        } else if (!slot.encoded.isDone()) {
+            return;
+        }
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        slot.pixels = nullptr;
+        free(slot);
+    }
+}
+
+void ReadbackService::startEncoding(Slot& slot) {
+    const size_t size = static_cast<size_t>(slot.width) * slot.height * getPixelSize(slot.format);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    slot.pixels = static_cast<const unsigned char*>(
+        glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT));
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    if (slot.pixels == nullptr) {
+        std::cerr << "map readback of " + slot.filepath + " failure" << std::endl;
+        ++_failedCount;
+        free(slot);
+        return;
+    }
+
+    slot.state = SlotState::Encoding;
+    JobSystem::get().submit(
+        [this, &slot]() {
+            TraceScope scope("encode image");
+            if (encode(slot)) {
+                ++_writtenCount;
+            } else {
+                std::cerr << "write image " + slot.filepath + " failure" << std::endl;
+                ++_failedCount;
+            }
+        },
+        &slot.encoded);
+}
+
+bool ReadbackService::encode(const Slot& slot) {
+    const int width = slot.width;
+    const int height = slot.height;
+    const size_t pixelCount = static_cast<size_t>(width) * height;
+
+    // gl rows go bottom up, so every format is written starting from the last row
+    switch (slot.format) {
+    case ReadbackFormat::Color: {
+        // a negative stride walks the rows backwards, the mapped pixels are used as they are
+        const int rowSize = width * 4;
+        const unsigned char* lastRow = slot.pixels + static_cast<size_t>(height - 1) * rowSize;
+        if (hasExtension(slot.filepath, ".qoi")) {
+            return writeQoi(slot.filepath, width, height, lastRow, -rowSize);
+        }
+        return stbi_write_png(slot.filepath.c_str(), width, height, 4, lastRow, -rowSize) != 0;
+    }
+    case ReadbackFormat::Depth: {
+        const float* depth = reinterpret_cast<const float*>(slot.pixels);
+        float minDepth = FLT_MAX;
+        float maxDepth = -FLT_MAX;
+        for (size_t i = 0; i < pixelCount; ++i) {
+            minDepth = std::min(minDepth, depth[i]);
+            maxDepth = std::max(maxDepth, depth[i]);
+        }
+        const float scale = maxDepth > minDepth ? 255.0f / (maxDepth - minDepth) : 0.0f;
+
+        std::vector<unsigned char> image(pixelCount);
+        for (int y = 0; y < height; ++y) {
+            const float* row = depth + static_cast<size_t>(height - 1 - y) * width;
+            for (int x = 0; x < width; ++x) {
+                // a constant depth comes out mid grey
+                image[y * width + x] = scale > 0.0f
+                                           ? static_cast<unsigned char>((row[x] - minDepth) * scale)
+                                           : 128;
+            }
+        }
+        return stbi_write_png(slot.filepath.c_str(), width, height, 1, image.data(), width) != 0;
+    }
+    case ReadbackFormat::FloatColor: {
+        const float* color = reinterpret_cast<const float*>(slot.pixels);
+        const size_t rowLength = static_cast<size_t>(width) * 3;
+        if (hasExtension(slot.filepath, ".hdr")) {
+            std::vector<float> image(pixelCount * 3);
+            for (int y = 0; y < height; ++y) {
+                const float* row = color + (height - 1 - y) * rowLength;
+                std::copy(row, row + rowLength, image.begin() + y * rowLength);
+            }
+            return stbi_write_hdr(slot.filepath.c_str(), width, height, 3, image.data()) != 0;
+        }
+
+        std::vector<unsigned char> image(pixelCount * 3);
+        for (int y = 0; y < height; ++y) {
+            const float* row = color + (height - 1 - y) * rowLength;
+            for (size_t i = 0; i < rowLength; ++i) {
+                image[y * rowLength + i] =
+                    static_cast<unsigned char>(std::clamp(row[i], 0.0f, 1.0f) * 255.0f + 0.5f);
+            }
+        }
+        return stbi_write_png(
+                   slot.filepath.c_str(), width, height, 3, image.data(), static_cast<int>(rowLength))
+               != 0;
+    }
+    }
+
+    return false;
+}
\ No newline at end of file
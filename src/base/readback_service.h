@@ -0,0 +1,116 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gl_utility.h"
+#include "job_system.h"
+#include "memory_tracker.h"
+
+enum class ReadbackFormat {
+    // rgba8, written as qoi for a .qoi file and as png otherwise
+    Color,
+    // float depth normalized between its minimum and maximum, written as an 8 bit png
+    Depth,
+    // rgb float, written as radiance hdr for a .hdr file and clamped to an 8 bit png otherwise
+    FloatColor
+};
+
+// copies framebuffers and textures into a ring of pixel pack buffers without waiting for the gpu.
+// update() polls the fences, maps the finished transfers and encodes them on the job system,
+// the buffer stays mapped until its file is written, so the pixels are never copied on the
+// gl thread. a request that finds the whole ring busy waits for the oldest transfer,
+// which bounds the memory held by a long capture and slows the renderer down to the encoders.
+class ReadbackService {
+public:
+    static ReadbackService& get();
+
+    ReadbackService(const ReadbackService&) = delete;
+
+    ReadbackService& operator=(const ReadbackService&) = delete;
+
+    // number of transfers in flight, waits for the pending ones
+    void setCapacity(size_t capacity);
+
+    size_t getCapacity() const;
+
+    // color attachment 0 for a Color request, the depth attachment for a Depth request
+    void readFramebuffer(
+        GLuint framebuffer, ReadbackFormat format, int width, int height, const std::string& filepath);
+
+    // level 0 of a 2d texture
+    void readTexture(
+        GLuint texture, ReadbackFormat format, int width, int height, const std::string& filepath);
+
+    // call once per frame on the gl thread
+    void update();
+
+    // wait until every request is written
+    void finish();
+
+    // delete the gl objects, must be called while the context and the job system are alive
+    void release();
+
+    size_t getPendingCount() const;
+
+    size_t getWrittenCount() const;
+
+    size_t getFailedCount() const;
+
+    // largest number of bytes held by the transfers in flight at once
+    size_t getPeakBytes() const;
+
+    void resetPeakBytes();
+
+private:
+    enum class SlotState {
+        Free,
+        // the gpu is writing the buffer, the fence tells when it is done
+        Transferring,
+        // mapped and read by an encoding job
+        Encoding
+    };
+
+    struct Slot {
+        GLuint buffer = 0;
+        size_t capacity = 0;
+        MemoryTracker::Id memory = MemoryTracker::invalidId;
+        GLsync fence = nullptr;
+        SlotState state = SlotState::Free;
+
+        ReadbackFormat format = ReadbackFormat::Color;
+        int width = 0;
+        int height = 0;
+        std::string filepath;
+
+        const unsigned char* pixels = nullptr;
+        JobCounter encoded;
+    };
+
+    // slots are not movable, jobs hold on to them
+    std::vector<std::unique_ptr<Slot>> _slots;
+    // the slot the next request tries first, requests are served round robin
+    size_t _nextSlot = 0;
+
+    size_t _busyBytes = 0;
+    size_t _peakBytes = 0;
+
+    std::atomic<size_t> _writtenCount{0};
+    std::atomic<size_t> _failedCount{0};
+
+    ReadbackService();
+
+    // a free slot whose buffer holds at least size bytes, bound to GL_PIXEL_PACK_BUFFER
+    Slot& acquire(size_t size);
+
+    void free(Slot& slot);
+
+    // move the slot on as far as it can go, waiting for the gpu and the encoder if blocking
+    void advance(Slot& slot, bool blocking);
+
+    void startEncoding(Slot& slot);
+
+    static bool encode(const Slot& slot);
+};
\ No newline at end of file
@@ -0,0 +1,91 @@
+#include "render_statistics.h"
+
+static const char* counterNames[RenderStatistics::counterCount] = {
+    "draw calls",      "triangles submitted", "triangles culled",    "program changes",
+    "texture changes", "framebuffer changes", "vertex array changes", "uniform calls",
+    "buffer upload bytes", "texture upload bytes"};
+
+static const char* objectTypeNames[RenderStatistics::objectTypeCount] = {
+    "buffers", "textures", "vertex arrays", "framebuffers", "renderbuffers", "programs", "samplers", "queries"};
+
+RenderStatistics& RenderStatistics::get() {
+    static RenderStatistics statistics;
+    return statistics;
+}
+
+void RenderStatistics::beginFrame() {
+    for (size_t i = 0; i < counterCount; ++i) {
+        _total[i] += _frame[i];
+    }
+    ++_frameCount;
+
+    _lastFrame = _frame;
+    _frame.fill(0);
+}
+
+uint64_t RenderStatistics::getLastFrame(RenderCounter counter) const {
+    return _lastFrame[static_cast<size_t>(counter)];
+}
+
+double RenderStatistics::getMean(RenderCounter counter) const {
+    if (_frameCount == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(_total[static_cast<size_t>(counter)]) / _frameCount;
+}
+
+int64_t RenderStatistics::getLiveCount(GLObjectType type) const {
+    return _live[static_cast<size_t>(type)];
+}
+
+void RenderStatistics::reset() {
+    _total.fill(0);
+    _frameCount = 0;
+}
+
+const char* RenderStatistics::getName(RenderCounter counter) {
+    return counterNames[static_cast<size_t>(counter)];
+}
+
+const char* RenderStatistics::getName(GLObjectType type) {
+    return objectTypeNames[static_cast<size_t>(type)];
+}
+
+size_t RenderStatistics::getImageSize(int width, int height, int depth, GLenum format, GLenum type) {
+    size_t channels = 0;
+    switch (format) {
+    case GL_RED:
+    case GL_RED_INTEGER:
+    case GL_DEPTH_COMPONENT: channels = 1; break;
+    case GL_RG:
+    case GL_RG_INTEGER:
+    case GL_DEPTH_STENCIL: channels = 2; break;
+    case GL_RGB:
+    case GL_BGR:
+    case GL_RGB_INTEGER: channels = 3; break;
+    case GL_RGBA:
+    case GL_BGRA:
+    case GL_RGBA_INTEGER: channels = 4; break;
+    default: return 0;
+    }
+
+    size_t channelSize = 0;
+    switch (type) {
+    case GL_UNSIGNED_BYTE:
+    case GL_BYTE: channelSize = 1; break;
+    case GL_UNSIGNED_SHORT:
+    case GL_SHORT:
+    case GL_HALF_FLOAT: channelSize = 2; break;
+    case GL_UNSIGNED_INT:
+    case GL_INT:
+    case GL_FLOAT: channelSize = 4; break;
+    // packed depth and stencil, one word per pixel
+    case GL_UNSIGNED_INT_24_8:
+        channels = 1;
+        channelSize = 4;
+        break;
+    default: return 0;
+    }
+
+    return static_cast<size_t>(width) * height * depth * channels * channelSize;
+}
\ No newline at end of file
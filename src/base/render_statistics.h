@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "gl_utility.h"
+
+enum class RenderCounter {
+    DrawCalls,
+    // a multi draw adds the triangles of its commands before gpu culling
+    TrianglesSubmitted,
+    // of the objects rejected by the cpu, the gpu culler's rejects are not read back
+    TrianglesCulled,
+    // changes that reached the driver, the state cache filters the redundant ones
+    ProgramChanges,
+    TextureChanges,
+    FramebufferChanges,
+    VertexArrayChanges,
+    UniformCalls,
+    BufferUploadBytes,
+    TextureUploadBytes,
+    Count
+};
+
+enum class GLObjectType {
+    Buffer,
+    Texture,
+    VertexArray,
+    Framebuffer,
+    Renderbuffer,
+    Program,
+    Sampler,
+    Query,
+    Count
+};
+
+// workload counters of a frame, incremented by the gl wrappers, and the number of live gl
+// objects of each type. gl thread only.
+class RenderStatistics {
+public:
+    static constexpr size_t counterCount = static_cast<size_t>(RenderCounter::Count);
+    static constexpr size_t objectTypeCount = static_cast<size_t>(GLObjectType::Count);
+
+    static RenderStatistics& get();
+
+    RenderStatistics(const RenderStatistics&) = delete;
+
+    RenderStatistics& operator=(const RenderStatistics&) = delete;
+
+    // the counters of the frame so far become the last frame's
+    void beginFrame();
+
+    void add(RenderCounter counter, uint64_t value = 1) {
+        _frame[static_cast<size_t>(counter)] += value;
+    }
+
+    void addDraw(uint64_t triangles) {
+        add(RenderCounter::DrawCalls);
+        add(RenderCounter::TrianglesSubmitted, triangles);
+    }
+
+    void onCreated(GLObjectType type, int count = 1) {
+        _live[static_cast<size_t>(type)] += count;
+    }
+
+    void onDeleted(GLObjectType type, int count = 1) {
+        _live[static_cast<size_t>(type)] -= count;
+    }
+
+    uint64_t getLastFrame(RenderCounter counter) const;
+
+    // over the frames completed since the last reset
+    double getMean(RenderCounter counter) const;
+
+    int64_t getLiveCount(GLObjectType type) const;
+
+    // forget the completed frames, the one in progress is counted when it ends. the live object
+    // counts stay
+    void reset();
+
+    static const char* getName(RenderCounter counter);
+
+    static const char* getName(GLObjectType type);
+
+    // bytes of an image as passed to glTexImage*, 0 for an unknown format or type
+    static size_t getImageSize(int width, int height, int depth, GLenum format, GLenum type);
+
+private:
+    std::array<uint64_t, counterCount> _frame{};
+    std::array<uint64_t, counterCount> _lastFrame{};
+    std::array<uint64_t, counterCount> _total{};
+    size_t _frameCount = 0;
+
+    std::array<int64_t, objectTypeCount> _live{};
+
+    RenderStatistics() = default;
+};
\ No newline at end of file
@@ -1,21 +1,25 @@
 #pragma once
 
+#include "gl_state_cache.h"
 #include "gl_utility.h"
+#include "render_statistics.h"
 
 class Sampler {
 public:
     Sampler() {
         glGenSamplers(1, &_handle);
+        RenderStatistics::get().onCreated(GLObjectType::Sampler);
     }
 
-    Sampler(Sampler&& rhs) noexcept {
-        rhs._handle = _handle;
-        _handle = 0;
+    Sampler(Sampler&& rhs) noexcept : _handle(rhs._handle) {
+        rhs._handle = 0;
     }
 
     ~Sampler() {
         if (_handle != 0) {
+            GLStateCache::get().onSamplerDeleted(_handle);
             glDeleteSamplers(1, &_handle);
+            RenderStatistics::get().onDeleted(GLObjectType::Sampler);
         }
     }
 
@@ -36,11 +40,11 @@ public:
     }
 
     void bind(GLuint texUnit) const {
-        glBindSampler(texUnit, _handle);
+        GLStateCache::get().bindSampler(static_cast<int>(texUnit), _handle);
     }
 
     void unbind(GLuint texUnit) const {
-        glBindSampler(texUnit, 0);
+        GLStateCache::get().bindSampler(static_cast<int>(texUnit), 0);
     }
 
 private:
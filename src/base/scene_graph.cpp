@@ -0,0 +1,233 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "scene_graph.h"
+
+// translate * rotate * scale without the two full matrix products of Transform::getLocalMatrix()
+static glm::mat4 composeMatrix(const Transform& transform) {
+    const glm::mat3 rotation = glm::mat3_cast(transform.rotation);
+    return glm::mat4(
+        glm::vec4(rotation[0] * transform.scale[0], 0.0f),
+        glm::vec4(rotation[1] * transform.scale[1], 0.0f),
+        glm::vec4(rotation[2] * transform.scale[2], 0.0f), glm::vec4(transform.position, 1.0f));
+}
+
+SceneGraph::Node SceneGraph::create() {
+    Node node;
+    if (!_freeNodes.empty()) {
+        node = _freeNodes.back();
+        _freeNodes.pop_back();
+    } else {
+        node = static_cast<Node>(_slots.size());
+        _slots.push_back(invalidSlot);
+        _children.emplace_back();
+    }
+
+    // a root can go anywhere, appending keeps the parent first order
+    _slots[node] = static_cast<uint32_t>(_nodes.size());
+    _nodes.push_back(node);
+    _parentSlots.push_back(invalidSlot);
+    _locals.push_back(Transform());
+    _worlds.push_back(glm::mat4(1.0f));
+    _dirty.push_back(0);
+    ++_nodeCount;
+
+    markChanged(node);
+
+    return node;
+}
+
+void SceneGraph::destroy(Node node) {
+    while (!_children[node].empty()) {
+        setParent(_children[node].back(), invalidNode);
+    }
+    setParent(node, invalidNode);
+
+    const uint32_t slot = _slots[node];
+    _nodes[slot] = invalidNode;
+    _dirty[slot] = 0;
+    _slots[node] = invalidSlot;
+    _freeNodes.push_back(node);
+    --_nodeCount;
+
+    _ordered = false;
+}
+
+void SceneGraph::setParent(Node node, Node parent) {
+    if (parent != invalidNode && (parent == node || isAncestor(node, parent))) {
+        throw std::runtime_error("scene graph node cannot be parented to itself or a descendant");
+    }
+
+    const uint32_t slot = _slots[node];
+    const uint32_t oldParentSlot = _parentSlots[slot];
+    if (oldParentSlot != invalidSlot) {
+        std::vector<Node>& siblings = _children[_nodes[oldParentSlot]];
+        siblings.erase(std::find(siblings.begin(), siblings.end(), node));
+    }
+
+    if (parent == invalidNode) {
+        _parentSlots[slot] = invalidSlot;
+    } else {
+        _parentSlots[slot] = _slots[parent];
+        _children[parent].push_back(node);
+        if (_slots[parent] > slot) {
+            _ordered = false;
+        }
+    }
+
+    markChanged(node);
+}
+
+SceneGraph::Node SceneGraph::getParent(Node node) const {
+    const uint32_t parentSlot = _parentSlots[_slots[node]];
+    return parentSlot == invalidSlot ? invalidNode : _nodes[parentSlot];
+}
+
+const std::vector<SceneGraph::Node>& SceneGraph::getChildren(Node node) const {
+    return _children[node];
+}
+
+bool SceneGraph::isAncestor(Node ancestor, Node node) const {
+    for (Node current = getParent(node); current != invalidNode; current = getParent(current)) {
+        if (current == ancestor) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void SceneGraph::setLocalTransform(Node node, const Transform& transform) {
+    _locals[_slots[node]] = transform;
+    markChanged(node);
+}
+
+const Transform& SceneGraph::getLocalTransform(Node node) const {
+    return _locals[_slots[node]];
+}
+
+const glm::mat4& SceneGraph::getWorldMatrix(Node node) const {
+    return _worlds[_slots[node]];
+}
+
+void SceneGraph::update() {
+    _updatedCount = 0;
+    if (!_ordered) {
+        reorder();
+    }
+
+    if (_changedNodes.empty()) {
+        return;
+    }
+
+    if (_changedNodes.size() * 4 >= _nodeCount) {
+        // most of the scene moved, a dense sweep over the arrays is cheaper than
+        // following the child lists
+        for (uint32_t slot = 0; slot < _nodes.size(); ++slot) {
+            const uint32_t parentSlot = _parentSlots[slot];
+            if (parentSlot != invalidSlot) {
+                _dirty[slot] |= _dirty[parentSlot];
+            }
+        }
+
+        for (uint32_t slot = 0; slot < _nodes.size(); ++slot) {
+            if (_dirty[slot]) {
+                updateWorldMatrix(slot);
+                _dirty[slot] = 0;
+                ++_updatedCount;
+            }
+        }
+    } else {
+        // a destroyed node may still be listed, and listed again once its id is reused
+        _dirtySlots.clear();
+        for (const Node node : _changedNodes) {
+            if (_slots[node] != invalidSlot) {
+                _dirtySlots.push_back(_slots[node]);
+            }
+        }
+        std::sort(_dirtySlots.begin(), _dirtySlots.end());
+        _dirtySlots.erase(std::unique(_dirtySlots.begin(), _dirtySlots.end()), _dirtySlots.end());
+
+        // collect the descendants, every slot is added once since its flag is set on insert
+        for (size_t i = 0; i < _dirtySlots.size(); ++i) {
+            for (const Node child : _children[_nodes[_dirtySlots[i]]]) {
+                const uint32_t childSlot = _slots[child];
+                if (!_dirty[childSlot]) {
+                    _dirty[childSlot] = 1;
+                    _dirtySlots.push_back(childSlot);
+                }
+            }
+        }
+
+        // parents first
+        std::sort(_dirtySlots.begin(), _dirtySlots.end());
+        for (const uint32_t slot : _dirtySlots) {
+            updateWorldMatrix(slot);
+            _dirty[slot] = 0;
+        }
+        _updatedCount = _dirtySlots.size();
+    }
+
+    _changedNodes.clear();
+}
+
+size_t SceneGraph::getNodeCount() const {
+    return _nodeCount;
+}
+
+size_t SceneGraph::getUpdatedCount() const {
+    return _updatedCount;
+}
+
+void SceneGraph::markChanged(Node node) {
+    uint8_t& dirty = _dirty[_slots[node]];
+    if (!dirty) {
+        dirty = 1;
+        _changedNodes.push_back(node);
+    }
+}
+
+void SceneGraph::reorder() {
+    std::vector<Node> order;
+    order.reserve(_nodeCount);
+    for (uint32_t slot = 0; slot < _nodes.size(); ++slot) {
+        if (_nodes[slot] != invalidNode && _parentSlots[slot] == invalidSlot) {
+            order.push_back(_nodes[slot]);
+        }
+    }
+    for (size_t i = 0; i < order.size(); ++i) {
+        const std::vector<Node>& children = _children[order[i]];
+        order.insert(order.end(), children.begin(), children.end());
+    }
+
+    std::vector<uint32_t> parentSlots(order.size());
+    std::vector<Transform> locals(order.size());
+    std::vector<glm::mat4> worlds(order.size());
+    std::vector<uint8_t> dirty(order.size());
+    for (uint32_t slot = 0; slot < order.size(); ++slot) {
+        const uint32_t oldSlot = _slots[order[slot]];
+        locals[slot] = _locals[oldSlot];
+        worlds[slot] = _worlds[oldSlot];
+        dirty[slot] = _dirty[oldSlot];
+    }
+
+    // parents were placed first, so their new slots are known when the children are visited
+    for (uint32_t slot = 0; slot < order.size(); ++slot) {
+        const uint32_t oldParentSlot = _parentSlots[_slots[order[slot]]];
+        parentSlots[slot] = oldParentSlot == invalidSlot ? invalidSlot : _slots[_nodes[oldParentSlot]];
+        _slots[order[slot]] = slot;
+    }
+
+    _nodes = std::move(order);
+    _parentSlots = std::move(parentSlots);
+    _locals = std::move(locals);
+    _worlds = std::move(worlds);
+    _dirty = std::move(dirty);
+    _ordered = true;
+}
+
+void SceneGraph::updateWorldMatrix(uint32_t slot) {
+    const uint32_t parentSlot = _parentSlots[slot];
+    _worlds[slot] = parentSlot == invalidSlot ? composeMatrix(_locals[slot])
+                                              : _worlds[parentSlot] * composeMatrix(_locals[slot]);
+}
\ No newline at end of file
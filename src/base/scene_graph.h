@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "transform.h"
+
+// parent/child hierarchy of local transforms with cached world matrices.
+// nodes are kept in contiguous arrays where every parent precedes its children,
+// so one forward pass over the arrays is enough to propagate world matrices.
+// update() only touches the nodes changed since the last update and their descendants.
+class SceneGraph {
+public:
+    using Node = uint32_t;
+
+    static constexpr Node invalidNode = ~0u;
+
+    // a new root with an identity transform
+    Node create();
+
+    // the children of the node become roots
+    void destroy(Node node);
+
+    // invalidNode makes the node a root
+    void setParent(Node node, Node parent);
+
+    Node getParent(Node node) const;
+
+    const std::vector<Node>& getChildren(Node node) const;
+
+    bool isAncestor(Node ancestor, Node node) const;
+
+    void setLocalTransform(Node node, const Transform& transform);
+
+    const Transform& getLocalTransform(Node node) const;
+
+    // valid after update()
+    const glm::mat4& getWorldMatrix(Node node) const;
+
+    void update();
+
+    size_t getNodeCount() const;
+
+    // number of world matrices recomputed by the last update()
+    size_t getUpdatedCount() const;
+
+private:
+    static constexpr uint32_t invalidSlot = ~0u;
+
+    // indexed by node
+    std::vector<uint32_t> _slots;
+    std::vector<std::vector<Node>> _children;
+    std::vector<Node> _freeNodes;
+
+    // indexed by slot, a parent slot is always smaller than the slots of its children
+    std::vector<Node> _nodes;
+    std::vector<uint32_t> _parentSlots;
+    std::vector<Transform> _locals;
+    std::vector<glm::mat4> _worlds;
+    std::vector<uint8_t> _dirty;
+
+    // nodes whose local transform or parent changed since the last update()
+    std::vector<Node> _changedNodes;
+    std::vector<uint32_t> _dirtySlots;
+
+    // false after destroy() left holes or setParent() broke the parent first order
+    bool _ordered = true;
+
+    size_t _nodeCount = 0;
+    size_t _updatedCount = 0;
+
+    void markChanged(Node node);
+
+    // repack the live nodes breadth first
+    void reorder();
+
+    void updateWorldMatrix(uint32_t slot);
+};
\ No newline at end of file
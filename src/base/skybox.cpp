@@ -1,4 +1,6 @@
 #include "skybox.h"
+#include "gl_state_cache.h"
+#include "render_statistics.h"
 
 SkyBox::SkyBox(const std::vector<std::string>& textureFilenames) {
     GLfloat vertices[] = {-1.0f, 1.0f,  -1.0f, -1.0f, -1.0f, -1.0f, 1.0f,  -1.0f, -1.0f,
@@ -22,15 +24,20 @@ SkyBox::SkyBox(const std::vector<std::string>& textureFilenames) {
     // create vao and vbo
     glGenVertexArrays(1, &_vao);
     glGenBuffers(1, &_vbo);
+    RenderStatistics& statistics = RenderStatistics::get();
+    statistics.onCreated(GLObjectType::VertexArray);
+    statistics.onCreated(GLObjectType::Buffer);
 
-    glBindVertexArray(_vao);
+    GLStateCache::get().bindVertexArray(_vao);
     glBindBuffer(GL_ARRAY_BUFFER, _vbo);
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), &vertices, GL_STATIC_DRAW);
+    statistics.add(RenderCounter::BufferUploadBytes, sizeof(vertices));
+    _memory = MemoryTracker::get().add(MemoryCategory::Buffer, sizeof(vertices));
 
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), 0);
 
-    glBindVertexArray(0);
+    GLStateCache::get().bindVertexArray(0);
 
     try {
         // init texture
@@ -71,6 +78,9 @@ SkyBox::SkyBox(const std::vector<std::string>& textureFilenames) {
         _shader->attachVertexShader(vsCode);
         _shader->attachFragmentShader(fsCode);
         _shader->link();
+
+        _projectionLocation = _shader->getUniformLocation("projection");
+        _viewLocation = _shader->getUniformLocation("view");
     } catch (const std::exception&) {
         cleanup();
         throw;
@@ -86,10 +96,12 @@ SkyBox::SkyBox(const std::vector<std::string>& textureFilenames) {
 }
 
 SkyBox::SkyBox(SkyBox&& rhs) noexcept
-    : _vao(rhs._vao), _vbo(rhs._vbo), _texture(std::move(rhs._texture)),
-      _shader(std::move(rhs._shader)) {
+    : _vao(rhs._vao), _vbo(rhs._vbo), _memory(rhs._memory), _texture(std::move(rhs._texture)),
+      _shader(std::move(rhs._shader)), _projectionLocation(rhs._projectionLocation),
+      _viewLocation(rhs._viewLocation) {
     rhs._vao = 0;
     rhs._vbo = 0;
+    rhs._memory = MemoryTracker::invalidId;
 }
 
 SkyBox::~SkyBox() {
@@ -97,29 +109,51 @@ SkyBox::~SkyBox() {
 }
 
 void SkyBox::draw(const glm::mat4& projection, const glm::mat4& view) {
-    glDepthFunc(GL_LEQUAL);
-    glDisable(GL_DEPTH_WRITEMASK);
+    GLStateCache& state = GLStateCache::get();
+    state.setDepthFunc(GL_LEQUAL);
+    state.setDepthMask(false);
     _shader->use();
 
     _shader->setUniformMat4("projection", projection);
     _shader->setUniformMat4("view", glm::mat4(glm::mat3(view)));
     _texture->bind();
 
-    glBindVertexArray(_vao);
+    state.bindVertexArray(_vao);
     glDrawArrays(GL_TRIANGLES, 0, 36);
-    glBindVertexArray(0);
-    glEnable(GL_DEPTH_WRITEMASK);
-    glDepthFunc(GL_LESS);
+    RenderStatistics::get().addDraw(12);
+    state.setDepthMask(true);
+    state.setDepthFunc(GL_LESS);
+}
+
+void SkyBox::record(CommandBuffer& commands, const glm::mat4& projection, const glm::mat4& view) const {
+    commands.setDepthFunc(GL_LEQUAL);
+    commands.setDepthMask(false);
+    commands.useProgram(_shader->getHandle());
+
+    commands.setUniformMat4(_projectionLocation, projection);
+    commands.setUniformMat4(_viewLocation, glm::mat4(glm::mat3(view)));
+    commands.bindTexture(0, GL_TEXTURE_CUBE_MAP, _texture->getHandle());
+
+    commands.bindVertexArray(_vao);
+    commands.drawArrays(GL_TRIANGLES, 0, 36);
+    commands.setDepthMask(true);
+    commands.setDepthFunc(GL_LESS);
 }
 
 void SkyBox::cleanup() {
     if (_vbo != 0) {
         glDeleteBuffers(1, &_vbo);
+        RenderStatistics::get().onDeleted(GLObjectType::Buffer);
         _vbo = 0;
     }
 
+    MemoryTracker::get().remove(_memory);
+    _memory = MemoryTracker::invalidId;
+
     if (_vao != 0) {
+        GLStateCache::get().onVertexArrayDeleted(_vao);
         glDeleteVertexArrays(1, &_vao);
+        RenderStatistics::get().onDeleted(GLObjectType::VertexArray);
         _vao = 0;
     }
 }
\ No newline at end of file
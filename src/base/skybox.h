@@ -6,6 +6,7 @@
 
 #include <glm/glm.hpp>
 
+#include "command_buffer.h"
 #include "gl_utility.h"
 #include "glsl_program.h"
 #include "texture_cubemap.h"
@@ -20,13 +21,18 @@ public:
 
     void draw(const glm::mat4& projection, const glm::mat4& view);
 
+    void record(CommandBuffer& commands, const glm::mat4& projection, const glm::mat4& view) const;
+
 private:
     GLuint _vao = 0;
     GLuint _vbo = 0;
+    MemoryTracker::Id _memory = MemoryTracker::invalidId;
 
     std::unique_ptr<TextureCubemap> _texture;
 
     std::unique_ptr<GLSLProgram> _shader;
+    GLint _projectionLocation = -1;
+    GLint _viewLocation = -1;
 
     void cleanup();
 };
\ No newline at end of file
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// refers to a value in a SlotMap, the generation tells a live handle from one whose value was erased
+struct SlotHandle {
+    static constexpr uint32_t invalidIndex = ~0u;
+
+    uint32_t index = invalidIndex;
+    uint32_t generation = 0;
+
+    bool isValid() const {
+        return index != invalidIndex;
+    }
+
+    bool operator==(const SlotHandle& rhs) const {
+        return index == rhs.index && generation == rhs.generation;
+    }
+
+    bool operator!=(const SlotHandle& rhs) const {
+        return !(*this == rhs);
+    }
+};
+
+// values are packed in one array, erasing moves the last value into the hole.
+// insert, erase and lookup are O(1) and iteration walks contiguous memory,
+// but values move, so they must be referred to by handle rather than by address.
+template <typename T>
+class SlotMap {
+public:
+    using iterator = typename std::vector<T>::iterator;
+    using const_iterator = typename std::vector<T>::const_iterator;
+
+    SlotHandle insert(T&& value) {
+        uint32_t index;
+        if (!_freeSlots.empty()) {
+            index = _freeSlots.back();
+            _freeSlots.pop_back();
+        } else {
+            index = static_cast<uint32_t>(_slots.size());
+            _slots.push_back({0, 0});
+        }
+
+        _slots[index].position = static_cast<uint32_t>(_values.size());
+        _values.push_back(std::move(value));
+        _slotIndices.push_back(index);
+
+        return {index, _slots[index].generation};
+    }
+
+    // stale handles are ignored
+    void erase(SlotHandle handle) {
+        if (!contains(handle)) {
+            return;
+        }
+
+        const uint32_t position = _slots[handle.index].position;
+        const uint32_t last = static_cast<uint32_t>(_values.size() - 1);
+        if (position != last) {
+            _values[position] = std::move(_values[last]);
+            _slotIndices[position] = _slotIndices[last];
+            _slots[_slotIndices[position]].position = position;
+        }
+        _values.pop_back();
+        _slotIndices.pop_back();
+
+        ++_slots[handle.index].generation;
+        _freeSlots.push_back(handle.index);
+    }
+
+    bool contains(SlotHandle handle) const {
+        // erase bumps the generation, so a freed slot never matches
+        return handle.index < _slots.size() && _slots[handle.index].generation == handle.generation;
+    }
+
+    // nullptr for a stale handle
+    T* get(SlotHandle handle) {
+        return contains(handle) ? &_values[_slots[handle.index].position] : nullptr;
+    }
+
+    const T* get(SlotHandle handle) const {
+        return contains(handle) ? &_values[_slots[handle.index].position] : nullptr;
+    }
+
+    // handle of the value currently at position
+    SlotHandle getHandle(size_t position) const {
+        const uint32_t index = _slotIndices[position];
+        return {index, _slots[index].generation};
+    }
+
+    T& operator[](size_t position) {
+        return _values[position];
+    }
+
+    const T& operator[](size_t position) const {
+        return _values[position];
+    }
+
+    T& back() {
+        return _values.back();
+    }
+
+    size_t size() const {
+        return _values.size();
+    }
+
+    bool empty() const {
+        return _values.empty();
+    }
+
+    iterator begin() {
+        return _values.begin();
+    }
+
+    iterator end() {
+        return _values.end();
+    }
+
+    const_iterator begin() const {
+        return _values.begin();
+    }
+
+    const_iterator end() const {
+        return _values.end();
+    }
+
+private:
+    struct Slot {
+        uint32_t position;
+        uint32_t generation;
+    };
+
+    std::vector<T> _values;
+    // position -> slot
+    std::vector<uint32_t> _slotIndices;
+    // slot -> position
+    std::vector<Slot> _slots;
+    std::vector<uint32_t> _freeSlots;
+};
\ No newline at end of file
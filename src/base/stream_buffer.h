@@ -0,0 +1,63 @@
+#pragma once
+
+#include <algorithm>
+
+#include "gl_utility.h"
+#include "memory_tracker.h"
+#include "render_statistics.h"
+
+// buffer whose whole content is replaced every frame, e.g. instance records or indirect commands
+class StreamBuffer {
+public:
+    StreamBuffer(GLenum target) : _target(target) {
+        glGenBuffers(1, &_handle);
+        RenderStatistics::get().onCreated(GLObjectType::Buffer);
+        _memory = MemoryTracker::get().add(MemoryCategory::Buffer, 0);
+    }
+
+    StreamBuffer(const StreamBuffer&) = delete;
+
+    StreamBuffer(StreamBuffer&& rhs) noexcept
+        : _target(rhs._target), _handle(rhs._handle), _capacity(rhs._capacity), _memory(rhs._memory) {
+        rhs._handle = 0;
+        rhs._capacity = 0;
+        rhs._memory = MemoryTracker::invalidId;
+    }
+
+    ~StreamBuffer() {
+        if (_handle != 0) {
+            glDeleteBuffers(1, &_handle);
+            RenderStatistics::get().onDeleted(GLObjectType::Buffer);
+            _handle = 0;
+        }
+
+        MemoryTracker::get().remove(_memory);
+    }
+
+    // the storage is orphaned on every upload so the driver never waits on last frame's draws
+    void upload(const void* data, size_t size) {
+        glBindBuffer(_target, _handle);
+        if (size > _capacity) {
+            _capacity = std::max(size, _capacity * 2);
+            MemoryTracker::get().resize(_memory, _capacity);
+        }
+        glBufferData(_target, _capacity, nullptr, GL_STREAM_DRAW);
+        glBufferSubData(_target, 0, size, data);
+        glBindBuffer(_target, 0);
+        RenderStatistics::get().add(RenderCounter::BufferUploadBytes, size);
+    }
+
+    GLenum getTarget() const {
+        return _target;
+    }
+
+    GLuint getHandle() const {
+        return _handle;
+    }
+
+private:
+    GLenum _target;
+    GLuint _handle = 0;
+    size_t _capacity = 0;
+    MemoryTracker::Id _memory = MemoryTracker::invalidId;
+};
\ No newline at end of file
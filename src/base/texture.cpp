@@ -1,28 +1,49 @@
 #include <cassert>
 
 #include "texture.h"
+#include "gl_state_cache.h"
+#include "render_statistics.h"
 
 Texture::Texture() {
     // create texture object
     glGenTextures(1, &_handle);
+    RenderStatistics::get().onCreated(GLObjectType::Texture);
 }
 
-Texture::Texture(Texture&& rhs) noexcept : _handle(rhs._handle) {
+Texture::Texture(Texture&& rhs) noexcept : _handle(rhs._handle), _memory(rhs._memory) {
     rhs._handle = 0;
+    rhs._memory = MemoryTracker::invalidId;
 }
 
 Texture::~Texture() {
     // destroy texture object
     if (_handle != 0) {
+        GLStateCache::get().onTextureDeleted(_handle);
         glDeleteTextures(1, &_handle);
+        RenderStatistics::get().onDeleted(GLObjectType::Texture);
         _handle = 0;
     }
+
+    MemoryTracker::get().remove(_memory);
+    _memory = MemoryTracker::invalidId;
 }
 
 GLuint Texture::getHandle() const {
     return _handle;
 }
 
+void Texture::setMemorySize(size_t bytes) {
+    if (_memory == MemoryTracker::invalidId) {
+        _memory = MemoryTracker::get().add(MemoryCategory::Texture, bytes);
+    } else {
+        MemoryTracker::get().resize(_memory, bytes);
+    }
+}
+
+MemoryTracker::Id Texture::getMemoryId() const {
+    return _memory;
+}
+
 void Texture::check() {
     GLenum error = glGetError();
     if (error != GL_NO_ERROR) {
@@ -35,7 +56,12 @@ void Texture::check() {
 
 void Texture::cleanup() {
     if (_handle != 0) {
+        GLStateCache::get().onTextureDeleted(_handle);
         glDeleteTextures(1, &_handle);
+        RenderStatistics::get().onDeleted(GLObjectType::Texture);
         _handle = 0;
     }
+
+    MemoryTracker::get().remove(_memory);
+    _memory = MemoryTracker::invalidId;
 }
\ No newline at end of file
@@ -8,6 +8,7 @@
 #include <stb_image_write.h>
 
 #include "gl_utility.h"
+#include "memory_tracker.h"
 
 class Texture {
 public:
@@ -27,8 +28,14 @@ public:
 
     GLuint getHandle() const;
 
+    // bytes of the texture's storage, the subclasses set it when they allocate the storage
+    void setMemorySize(size_t bytes);
+
+    MemoryTracker::Id getMemoryId() const;
+
 protected:
     GLuint _handle = {};
+    MemoryTracker::Id _memory = MemoryTracker::invalidId;
 
     void check();
 
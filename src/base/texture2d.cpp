@@ -3,24 +3,31 @@
 #include <stb_image.h>
 
 #include "texture2d.h"
+#include "gl_state_cache.h"
+#include "render_statistics.h"
+#include "trace_recorder.h"
 
 Texture2D::Texture2D(
     GLint internalFormat, int width, int height, GLenum format, GLenum dataType, void* data) {
-    glBindTexture(GL_TEXTURE_2D, _handle);
+    GLStateCache::get().bindTexture(GL_TEXTURE_2D, _handle);
     setDefaultParameters();
     glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, dataType, data);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    setMemorySize(MemoryTracker::getTexelSize(internalFormat) * width * height);
+    if (data != nullptr) {
+        RenderStatistics::get().add(
+            RenderCounter::TextureUploadBytes, RenderStatistics::getImageSize(width, height, 1, format, dataType));
+    }
+    GLStateCache::get().bindTexture(GL_TEXTURE_2D, 0);
 }
 
 Texture2D::Texture2D(Texture2D&& rhs) noexcept : Texture(std::move(rhs)) {}
 
 void Texture2D::bind(int slot) const {
-    glActiveTexture(GL_TEXTURE0 + slot);
-    glBindTexture(GL_TEXTURE_2D, _handle);
+    GLStateCache::get().bindTexture(slot, GL_TEXTURE_2D, _handle);
 }
 
 void Texture2D::unbind() const {
-    glBindTexture(GL_TEXTURE_2D, 0);
+    GLStateCache::get().bindTexture(GL_TEXTURE_2D, 0);
 }
 
 void Texture2D::generateMipmap() const {
@@ -43,6 +50,9 @@ void Texture2D::setDefaultParameters() {
 }
 
 ImageTexture2D::ImageTexture2D(const std::string& path) : _uri(path) {
+    TraceScope scope("load texture");
+    MemoryOwnerScope owner("texture " + path);
+
     // load image to the memory
     stbi_set_flip_vertically_on_load(true);
     int width = 0, height = 0, channels = 0;
@@ -65,7 +75,7 @@ ImageTexture2D::ImageTexture2D(const std::string& path) : _uri(path) {
     }
     GLint internalFormat = static_cast<GLint>(format);
 
-    glBindTexture(GL_TEXTURE_2D, _handle);
+    GLStateCache::get().bindTexture(GL_TEXTURE_2D, _handle);
 
     // set texture parameters
     setDefaultParameters();
@@ -73,7 +83,7 @@ ImageTexture2D::ImageTexture2D(const std::string& path) : _uri(path) {
     // transfer the image data to GPU
     upload(data, width, height, channels, internalFormat, format, GL_UNSIGNED_BYTE);
 
-    glBindTexture(GL_TEXTURE_2D, 0);
+    GLStateCache::get().bindTexture(GL_TEXTURE_2D, 0);
 
     // free data
     stbi_image_free(data);
@@ -86,7 +96,8 @@ ImageTexture2D::ImageTexture2D(
     const void* data, int width, int height, int channels, GLint internalformat, GLenum format,
     GLenum type, const std::string& uri)
     : _uri(uri) {
-    glBindTexture(GL_TEXTURE_2D, _handle);
+    MemoryOwnerScope owner("texture " + uri);
+    GLStateCache::get().bindTexture(GL_TEXTURE_2D, _handle);
 
     // set texture parameters
     setDefaultParameters();
@@ -94,7 +105,7 @@ ImageTexture2D::ImageTexture2D(
     // transfer the image data to GPU
     upload(data, width, height, channels, internalformat, format, type);
 
-    glBindTexture(GL_TEXTURE_2D, 0);
+    GLStateCache::get().bindTexture(GL_TEXTURE_2D, 0);
 
     // check error
     check();
@@ -135,6 +146,9 @@ void ImageTexture2D::upload(
 
     // 2. transfer data
     glTexImage2D(GL_TEXTURE_2D, 0, internalformat, width, height, 0, format, type, data);
+    setMemorySize(MemoryTracker::getTexelSize(internalformat) * width * height);
+    RenderStatistics::get().add(
+        RenderCounter::TextureUploadBytes, RenderStatistics::getImageSize(width, height, 1, format, type));
 
     // 3. restore alignment
     glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
@@ -142,23 +156,23 @@ void ImageTexture2D::upload(
 
 Texture2DArray::Texture2DArray(
     GLint internalFormat, int width, int height, int layers, GLenum format, GLenum dataType) {
-    glBindTexture(GL_TEXTURE_2D_ARRAY, _handle);
+    GLStateCache::get().bindTexture(GL_TEXTURE_2D_ARRAY, _handle);
     glTexImage3D(
         GL_TEXTURE_2D_ARRAY, 0, internalFormat, width, height, layers, 0, format, dataType,
         nullptr);
+    setMemorySize(MemoryTracker::getTexelSize(internalFormat) * width * height * layers);
     setDefaultParameters();
-    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    GLStateCache::get().bindTexture(GL_TEXTURE_2D_ARRAY, 0);
 }
 
 Texture2DArray::Texture2DArray(Texture2DArray&& rhs) noexcept : Texture(std::move(rhs)) {}
 
 void Texture2DArray::bind(int slot) const {
-    glActiveTexture(GL_TEXTURE0 + slot);
-    glBindTexture(GL_TEXTURE_2D_ARRAY, _handle);
+    GLStateCache::get().bindTexture(slot, GL_TEXTURE_2D_ARRAY, _handle);
 }
 
 void Texture2DArray::unbind() const {
-    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    GLStateCache::get().bindTexture(GL_TEXTURE_2D_ARRAY, 0);
 }
 
 void Texture2DArray::generateMipmap() const {
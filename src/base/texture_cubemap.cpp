@@ -2,10 +2,13 @@
 #include <stb_image.h>
 
 #include "texture_cubemap.h"
+#include "gl_state_cache.h"
+#include "render_statistics.h"
+#include "trace_recorder.h"
 
 TextureCubemap::TextureCubemap(
     GLint internalFormat, int width, int height, GLenum format, GLenum dataType) {
-    glBindTexture(GL_TEXTURE_CUBE_MAP, _handle);
+    GLStateCache::get().bindTexture(GL_TEXTURE_CUBE_MAP, _handle);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
@@ -17,19 +20,19 @@ TextureCubemap::TextureCubemap(
             GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, internalFormat, width, height, 0, format,
             dataType, nullptr);
     }
+    setMemorySize(MemoryTracker::getTexelSize(internalFormat) * width * height * 6);
 
-    glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+    GLStateCache::get().bindTexture(GL_TEXTURE_CUBE_MAP, 0);
 }
 
 TextureCubemap::TextureCubemap(TextureCubemap&& rhs) noexcept : Texture(std::move(rhs)) {}
 
 void TextureCubemap::bind(int slot) const {
-    glActiveTexture(GL_TEXTURE0 + slot);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, _handle);
+    GLStateCache::get().bindTexture(slot, GL_TEXTURE_CUBE_MAP, _handle);
 }
 
 void TextureCubemap::unbind() const {
-    glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+    GLStateCache::get().bindTexture(GL_TEXTURE_CUBE_MAP, 0);
 }
 
 void TextureCubemap::generateMipmap() const {
@@ -44,20 +47,27 @@ ImageTextureCubemap::ImageTextureCubemap(const std::vector<std::string>& filepat
     : _uris(filepaths) {
     assert(filepaths.size() == 6);
 
-    glBindTexture(GL_TEXTURE_CUBE_MAP, _handle);
+    GLStateCache::get().bindTexture(GL_TEXTURE_CUBE_MAP, _handle);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 
+    TraceScope scope("load cubemap");
     int width, height, nrChannels;
     unsigned char* data;
+    size_t memorySize = 0;
     for (unsigned int i = 0; i < _uris.size(); i++)
     {
         data = stbi_load(_uris[i].c_str(), &width, &height, &nrChannels, 0);
         glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
+        RenderStatistics::get().add(
+            RenderCounter::TextureUploadBytes,
+            RenderStatistics::getImageSize(width, height, 1, GL_RGB, GL_UNSIGNED_BYTE));
+        memorySize += MemoryTracker::getTexelSize(GL_RGB) * width * height;
     }
+    setMemorySize(memorySize);
 }
 
 ImageTextureCubemap::ImageTextureCubemap(ImageTextureCubemap&& rhs) noexcept
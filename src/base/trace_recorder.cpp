@@ -0,0 +1,157 @@
+#include <fstream>
+#include <iostream>
+
+#include "trace_recorder.h"
+
+static void writeName(std::ofstream& stream, const char* name) {
+    stream << '"';
+    for (const char* c = name; *c != '\0'; ++c) {
+        if (*c == '"' || *c == '\\') {
+            stream << '\\';
+        }
+        stream << *c;
+    }
+    stream << '"';
+}
+
+TraceRecorder& TraceRecorder::get() {
+    static TraceRecorder recorder;
+    return recorder;
+}
+
+void TraceRecorder::start(int frameCount, const std::string& filepath) {
+    if (frameCount <= 0) {
+        return;
+    }
+
+    _startFrames = frameCount;
+    _filepath = filepath;
+}
+
+void TraceRecorder::stop() {
+    if (!_enabled.load()) {
+        return;
+    }
+
+    _enabled.store(false);
+    _remainingFrames = 0;
+    if (write(_filepath)) {
+        std::cout << "trace written to " << _filepath << std::endl;
+    }
+}
+
+bool TraceRecorder::isRecording() const {
+    return _enabled.load() || _startFrames > 0;
+}
+
+void TraceRecorder::onFrameBoundary() {
+    if (_enabled.load() && --_remainingFrames <= 0) {
+        stop();
+    }
+
+    if (_startFrames > 0) {
+        // nothing is written while disabled, the rings can be reset
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            for (const std::unique_ptr<ThreadBuffer>& thread : _threads) {
+                thread->head.store(0);
+            }
+        }
+
+        _remainingFrames = _startFrames;
+        _startFrames = 0;
+        _enabled.store(true);
+    }
+}
+
+void TraceRecorder::setThreadName(const std::string& name) {
+    ThreadBuffer& buffer = getThreadBuffer();
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    buffer.name = name;
+}
+
+TraceRecorder::ThreadBuffer& TraceRecorder::getThreadBuffer() {
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (buffer == nullptr) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _threads.push_back(std::make_unique<ThreadBuffer>());
+        buffer = _threads.back().get();
+        buffer->id = static_cast<uint32_t>(_threads.size());
+        buffer->name = "thread " + std::to_string(buffer->id);
+    }
+
+    return *buffer;
+}
+
+void TraceRecorder::record(const char* name, char phase, double value) {
+    ThreadBuffer& buffer = getThreadBuffer();
+    if (buffer.events.empty()) {
+        buffer.events.resize(ringSize);
+    }
+
+    const uint64_t time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - _epoch).count();
+
+    // only this thread moves the head, the release publishes the event to the writer
+    const uint64_t head = buffer.head.load(std::memory_order_relaxed);
+    buffer.events[head & (ringSize - 1)] = {name, time, value, phase};
+    buffer.head.store(head + 1, std::memory_order_release);
+}
+
+bool TraceRecorder::write(const std::string& filepath) {
+    std::ofstream stream(filepath);
+    if (!stream) {
+        std::cerr << "write trace " + filepath + " failure" << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    const auto separate = [&stream, &first]() {
+        stream << (first ? "\n" : ",\n");
+        first = false;
+    };
+
+    for (const std::unique_ptr<ThreadBuffer>& thread : _threads) {
+        separate();
+        stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread->id
+               << ",\"args\":{\"name\":";
+        writeName(stream, thread->name.c_str());
+        stream << "}}";
+
+        const uint64_t head = thread->head.load(std::memory_order_acquire);
+        const uint64_t oldest = head > ringSize ? head - ringSize : 0;
+
+        // an end whose begin was overwritten or happened before the recording is dropped
+        int depth = 0;
+        for (uint64_t i = oldest; i < head; ++i) {
+            const Event& event = thread->events[i & (ringSize - 1)];
+            if (event.phase == 'E') {
+                if (depth == 0) {
+                    continue;
+                }
+                --depth;
+            } else if (event.phase == 'B') {
+                ++depth;
+            }
+
+            separate();
+            stream << "{\"name\":";
+            writeName(stream, event.name);
+            stream << ",\"ph\":\"" << event.phase << "\",\"ts\":" << event.time / 1000 << '.'
+                   << event.time / 100 % 10 << event.time / 10 % 10 << event.time % 10
+                   << ",\"pid\":1,\"tid\":" << thread->id;
+            if (event.phase == 'C') {
+                stream << ",\"args\":{\"value\":" << event.value << '}';
+            }
+            stream << '}';
+        }
+    }
+
+    stream << "\n]}\n";
+
+    return static_cast<bool>(stream);
+}
\ No newline at end of file
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// records begin, end and counter events of every thread for a number of frames and writes them
+// as chrome trace event json, which chrome://tracing and the perfetto ui open. each thread appends
+// to its own ring without locking, the rings are only read once recording has stopped.
+// event names are not copied, they must outlive the recorder, string literals do.
+class TraceRecorder {
+public:
+    static TraceRecorder& get();
+
+    TraceRecorder(const TraceRecorder&) = delete;
+
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+    // records the next frameCount frames and writes them to filepath
+    void start(int frameCount, const std::string& filepath);
+
+    // writes what was recorded so far
+    void stop();
+
+    bool isRecording() const;
+
+    // call between two frames on the main thread, recording starts and stops here,
+    // so the frames in the file are whole
+    void onFrameBoundary();
+
+    void setThreadName(const std::string& name);
+
+    void begin(const char* name) {
+        if (_enabled.load(std::memory_order_relaxed)) {
+            record(name, 'B', 0.0);
+        }
+    }
+
+    void end(const char* name) {
+        if (_enabled.load(std::memory_order_relaxed)) {
+            record(name, 'E', 0.0);
+        }
+    }
+
+    void counter(const char* name, double value) {
+        if (_enabled.load(std::memory_order_relaxed)) {
+            record(name, 'C', value);
+        }
+    }
+
+private:
+    // events kept per thread, the oldest are overwritten
+    static constexpr uint64_t ringSize = 1 << 16;
+
+    struct Event {
+        const char* name;
+        uint64_t time;
+        double value;
+        char phase;
+    };
+
+    struct ThreadBuffer {
+        uint32_t id;
+        std::string name;
+        // allocated by the first event
+        std::vector<Event> events;
+        std::atomic<uint64_t> head{0};
+    };
+
+    std::mutex _mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> _threads;
+
+    std::atomic<bool> _enabled{false};
+    int _startFrames = 0;
+    int _remainingFrames = 0;
+    std::string _filepath;
+    std::chrono::time_point<std::chrono::steady_clock> _epoch = std::chrono::steady_clock::now();
+
+    TraceRecorder() = default;
+
+    ThreadBuffer& getThreadBuffer();
+
+    void record(const char* name, char phase, double value);
+
+    bool write(const std::string& filepath);
+};
+
+// a begin and end event around the enclosing block
+class TraceScope {
+public:
+    explicit TraceScope(const char* name) : _name(name) {
+        TraceRecorder::get().begin(name);
+    }
+
+    TraceScope(const TraceScope&) = delete;
+
+    ~TraceScope() {
+        TraceRecorder::get().end(_name);
+    }
+
+private:
+    const char* const _name;
+};
\ No newline at end of file
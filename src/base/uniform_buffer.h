@@ -4,26 +4,34 @@
 #include <string>
 
 #include "gl_utility.h"
+#include "memory_tracker.h"
+#include "render_statistics.h"
 
 class UniformBuffer {
 public:
     UniformBuffer(size_t bufferSize, GLenum usage) {
         glGenBuffers(1, &_handle);
+        RenderStatistics::get().onCreated(GLObjectType::Buffer);
         glBindBuffer(GL_UNIFORM_BUFFER, _handle);
         glBufferData(GL_UNIFORM_BUFFER, bufferSize, nullptr, usage);
         glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        _memory = MemoryTracker::get().add(MemoryCategory::Buffer, bufferSize);
     }
 
     UniformBuffer(UniformBuffer&& rhs) noexcept
-        : _handle(rhs._handle), _offsetMap(std::move(rhs._offsetMap)) {
+        : _handle(rhs._handle), _memory(rhs._memory), _offsetMap(std::move(rhs._offsetMap)) {
         rhs._handle = 0;
+        rhs._memory = MemoryTracker::invalidId;
     }
 
     ~UniformBuffer() {
         if (_handle != 0) {
             glDeleteBuffers(1, &_handle);
+            RenderStatistics::get().onDeleted(GLObjectType::Buffer);
             _handle = 0;
         }
+
+        MemoryTracker::get().remove(_memory);
     }
 
     void setBindingPoint(uint32_t index) const {
@@ -45,10 +53,12 @@ public:
         glBindBuffer(GL_UNIFORM_BUFFER, _handle);
         glBufferSubData(GL_UNIFORM_BUFFER, iter->second, sizeof(T), &value);
         glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        RenderStatistics::get().add(RenderCounter::BufferUploadBytes, sizeof(T));
     }
 
 private:
     GLuint _handle{};
+    MemoryTracker::Id _memory = MemoryTracker::invalidId;
     std::map<std::string, size_t> _offsetMap;
 };
 
@@ -64,4 +74,5 @@ inline void UniformBuffer::update<bool>(const std::string& name, const bool& val
     glBindBuffer(GL_UNIFORM_BUFFER, _handle);
     glBufferSubData(GL_UNIFORM_BUFFER, iter->second, sizeof(int), &intVal);
     glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    RenderStatistics::get().add(RenderCounter::BufferUploadBytes, sizeof(int));
 }
\ No newline at end of file
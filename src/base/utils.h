@@ -3,6 +3,7 @@
 #include "framebuffer.h"
 #include "texture2d.h"
 
+// the images are written in the background by ReadbackService, the calls do not wait for the gpu
 void saveFramebufferToImage(Framebuffer* framebuffer, int width, int height, const std::string& colorFile, const std::string& depthFile);
 void saveRGBTextureToImage(Texture2D* texture, int width, int height, const std::string& file);
 void saveDepthTextureToImage(Texture2D* texture, int width, int height, const std::string& file);
\ No newline at end of file
@@ -0,0 +1,190 @@
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "base/allocation_counter.h"
+#include "base/camera.h"
+#include "base/mesh_data.h"
+#include "base/transform.h"
+#include "primitive_factory.h"
+
+// results are folded in here so the optimizer cannot drop the work
+static volatile float sink = 0.0f;
+
+static double minSeconds = 0.25;
+static std::string filter;
+
+// calls body until minSeconds have passed. body handles items items, the times and allocations
+// are reported per item, bytes is what one call reads or writes, 0 when a rate makes no sense
+template <typename Body>
+static void run(const std::string& name, size_t items, size_t bytes, const Body& body) {
+    if (!filter.empty() && name.find(filter) == std::string::npos) {
+        return;
+    }
+
+    body();
+
+    size_t calls = 0;
+    const size_t allocationsBefore = getHeapAllocationCount();
+    const size_t bytesBefore = getHeapAllocationBytes();
+    const auto start = std::chrono::steady_clock::now();
+    double seconds = 0.0;
+    for (size_t batch = 1; seconds < minSeconds; batch *= 2) {
+        for (size_t i = 0; i < batch; ++i) {
+            body();
+        }
+        calls += batch;
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    const double itemCount = static_cast<double>(calls) * items;
+    std::printf(
+        "%-36s %12.1f ns/op %14.0f op/s", name.c_str(), seconds * 1e9 / itemCount, itemCount / seconds);
+    if (bytes > 0) {
+        std::printf(" %9.1f MB/s", static_cast<double>(calls) * bytes / seconds / (1024.0 * 1024.0));
+    } else {
+        std::printf(" %14s", "");
+    }
+    std::printf(
+        " %10.2f allocs/op %12.0f B/op\n", (getHeapAllocationCount() - allocationsBefore) / itemCount,
+        (getHeapAllocationBytes() - bytesBefore) / itemCount);
+}
+
+// every triangle corner as its own vertex, the input of the welding step of loadObj
+static std::vector<Vertex> expand(const MeshData& mesh) {
+    std::vector<Vertex> corners;
+    corners.reserve(mesh.indices.size());
+    for (const uint32_t index : mesh.indices) {
+        corners.push_back(mesh.vertices[index]);
+    }
+    return corners;
+}
+
+static void benchmarkMesh(const std::string& label, const std::filesystem::path& path) {
+    const size_t fileSize = std::filesystem::file_size(path);
+    run("loadObj " + label, 1, fileSize, [&path]() {
+        sink = sink + static_cast<float>(MeshData::loadObj(path.string()).indices.size());
+    });
+
+    const MeshData mesh = MeshData::loadObj(path.string());
+    const std::vector<Vertex> corners = expand(mesh);
+    run("fromTriangles " + label, corners.size(), corners.size() * sizeof(Vertex), [&corners]() {
+        sink = sink + static_cast<float>(MeshData::fromTriangles(corners).vertices.size());
+    });
+
+    MeshData boxed = mesh;
+    run("computeBoundingBox " + label, boxed.vertices.size(), boxed.vertices.size() * sizeof(Vertex), [&boxed]() {
+        boxed.computeBoundingBox();
+        sink = sink + boxed.boundingBox.max.x;
+    });
+
+    const std::filesystem::path exported = std::filesystem::temp_directory_path() / "scene_modeling_bench.obj";
+    mesh.exportObj(exported.string());
+    run("exportObj " + label, 1, std::filesystem::file_size(exported), [&mesh, &exported]() {
+        mesh.exportObj(exported.string());
+    });
+    std::filesystem::remove(exported);
+}
+
+int main(int argc, char* argv[]) {
+    std::string mediaDir = "../media/";
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--media" && i + 1 < argc) {
+            mediaDir = argv[++i];
+        } else if (arg == "--time" && i + 1 < argc) {
+            minSeconds = std::atof(argv[++i]);
+        } else if (arg == "--help") {
+            std::printf(
+                "usage: scene_modeling_bench [--media DIR] [--time SECONDS] [FILTER]\n"
+                "  runs the benchmarks whose name contains FILTER, each for at least SECONDS\n");
+            return EXIT_SUCCESS;
+        } else {
+            filter = arg;
+        }
+    }
+
+    // the assets as they are
+    std::vector<std::filesystem::path> assets;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(mediaDir + "obj", error)) {
+        if (entry.path().extension() == ".obj") {
+            assets.push_back(entry.path());
+        }
+    }
+    std::sort(assets.begin(), assets.end());
+    if (assets.empty()) {
+        std::fprintf(stderr, "no obj files in %sobj, the asset benchmarks are skipped\n", mediaDir.c_str());
+    }
+    for (const std::filesystem::path& asset : assets) {
+        benchmarkMesh(asset.stem().string(), asset);
+    }
+
+    // a synthetic mesh far bigger than the assets
+    const std::filesystem::path synthetic = std::filesystem::temp_directory_path() / "scene_modeling_bench_sphere.obj";
+    PrimitiveFactory::buildSphere(1.0f, 256, 256).exportObj(synthetic.string());
+    benchmarkMesh("sphere 256x256", synthetic);
+    std::filesystem::remove(synthetic);
+
+    // scene sized batches of boxes and transforms with a fixed seed
+    constexpr size_t objectCount = 4096;
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+    std::uniform_real_distribution<float> angle(-3.14f, 3.14f);
+    std::uniform_real_distribution<float> scale(0.5f, 2.0f);
+
+    std::vector<Transform> transforms(objectCount);
+    std::vector<glm::mat4> matrices(objectCount);
+    for (size_t i = 0; i < objectCount; ++i) {
+        transforms[i].position = glm::vec3(position(random), position(random), position(random));
+        transforms[i].rotation = glm::quat(glm::vec3(angle(random), angle(random), angle(random)));
+        transforms[i].scale = glm::vec3(scale(random));
+        matrices[i] = transforms[i].getLocalMatrix();
+    }
+
+    run("Transform::getLocalMatrix", objectCount, 0, [&transforms]() {
+        float sum = 0.0f;
+        for (const Transform& transform : transforms) {
+            sum += transform.getLocalMatrix()[3][0];
+        }
+        sink = sink + sum;
+    });
+
+    PerspectiveCamera camera(glm::radians(60.0f), 16.0f / 9.0f, 0.3f, 1000.0f);
+    camera.transform.position = glm::vec3(0.0f, 0.0f, 60.0f);
+    // the Frustum shape of primitive_factory.h hides the struct name
+    const auto frustum = camera.getFrustum();
+    const BoundingBox box{glm::vec3(-1.0f), glm::vec3(1.0f)};
+    run("Frustum::intersect", objectCount, 0, [&frustum, &box, &matrices]() {
+        int visible = 0;
+        for (const glm::mat4& matrix : matrices) {
+            visible += frustum.intersect(box, matrix) ? 1 : 0;
+        }
+        sink = sink + static_cast<float>(visible);
+    });
+
+    // the meshes PrimitiveFactory::create* upload, with the defaults of the add model panel
+    const auto primitive = [](const std::string& name, const auto& build) {
+        const size_t bytes = build().vertices.size() * sizeof(Vertex);
+        run("PrimitiveFactory::" + name, 1, bytes, [&build]() {
+            sink = sink + static_cast<float>(build().vertices.size());
+        });
+    };
+    primitive("buildCube", []() { return PrimitiveFactory::buildCube(1.0f); });
+    primitive("buildSphere", []() { return PrimitiveFactory::buildSphere(1.0f, 16, 16); });
+    primitive("buildSphere 512x512", []() { return PrimitiveFactory::buildSphere(1.0f, 512, 512); });
+    primitive("buildPlane", []() { return PrimitiveFactory::buildPlane(1.0f, 1.0f); });
+    primitive("buildPlane 256x256", []() { return PrimitiveFactory::buildPlane(1.0f, 1.0f, 256, 256); });
+    primitive("buildCylinder", []() { return PrimitiveFactory::buildCylinder(1.0f, 2.0f, 16, 1); });
+    primitive("buildCone", []() { return PrimitiveFactory::buildCone(1.0f, 2.0f, 16); });
+    primitive("buildPrism", []() { return PrimitiveFactory::buildPrism(1.0f, 2.0f, 3); });
+    primitive("buildFrustum", []() { return PrimitiveFactory::buildFrustum(1.0f, 0.5f, 2.0f, 3); });
+
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
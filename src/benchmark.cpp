@@ -0,0 +1,349 @@
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <regex>
+#include <sstream>
+#include <stdexcept>
+
+#include "benchmark.h"
+#include "primitive_factory.h"
+#include "base/profiler.h"
+#include "base/render_statistics.h"
+
+static std::string escapeJson(const std::string& text) {
+    std::string escaped;
+    for (const char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+// the flat "metrics" object of a report, name -> milliseconds
+static std::map<std::string, double> readMetrics(const std::string& filepath) {
+    std::ifstream file(filepath);
+    if (!file) {
+        throw std::runtime_error("open benchmark report " + filepath + " failure");
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    const std::string text = buffer.str();
+
+    const size_t begin = text.find('{', text.find("\"metrics\""));
+    const size_t end = text.find('}', begin);
+    if (begin == std::string::npos || end == std::string::npos) {
+        throw std::runtime_error("benchmark report " + filepath + " has no metrics");
+    }
+
+    std::map<std::string, double> metrics;
+    const std::regex entry("\"([^\"]+)\"\\s*:\\s*(-?[0-9.eE+-]+)");
+    const std::string object = text.substr(begin, end - begin);
+    for (std::sregex_iterator it(object.begin(), object.end(), entry), last; it != last; ++it) {
+        metrics[(*it)[1]] = std::stod((*it)[2]);
+    }
+
+    return metrics;
+}
+
+Model BenchmarkModel::create(const std::string& assetRootDir) const {
+    Model model = [this, &assetRootDir]() {
+        if (!primitive) {
+            return Model(source, assetRootDir + source);
+        }
+
+        // the defaults of the add model panel
+        if (source == "cube") {
+            return PrimitiveFactory::createCube(source, 1.0f);
+        } else if (source == "sphere") {
+            return PrimitiveFactory::createSphere(source, 1.0f, 16, 16);
+        } else if (source == "plane") {
+            return PrimitiveFactory::createPlane(source, 1.0f, 1.0f);
+        } else if (source == "cylinder") {
+            return PrimitiveFactory::createCylinder(source, 1.0f, 2.0f, 16, 1);
+        } else if (source == "cone") {
+            return PrimitiveFactory::createCone(source, 1.0f, 2.0f, 16);
+        } else if (source == "prism") {
+            return PrimitiveFactory::createPrism(source, 1.0f, 2.0f, 3);
+        } else if (source == "frustum") {
+            return PrimitiveFactory::createFrustum(source, 1.0f, 0.5f, 2.0f, 3);
+        }
+        throw std::runtime_error("unknown primitive " + source);
+    }();
+
+    model.transform.position = position;
+    model.transform.scale = glm::vec3(scale);
+    return model;
+}
+
+BenchmarkScript BenchmarkScript::load(const std::string& filepath) {
+    std::ifstream file(filepath);
+    if (!file) {
+        throw std::runtime_error("open benchmark script " + filepath + " failure");
+    }
+
+    BenchmarkScript script;
+    std::string line;
+    for (int lineNumber = 1; std::getline(file, line); ++lineNumber) {
+        line = line.substr(0, line.find('#'));
+        std::istringstream stream(line);
+        std::string statement;
+        if (!(stream >> statement)) {
+            continue;
+        }
+
+        bool valid = true;
+        if (statement == "resolution") {
+            std::string size;
+            valid = stream >> size
+                    && std::sscanf(size.c_str(), "%dx%d", &script.width, &script.height) == 2
+                    && script.width > 0 && script.height > 0;
+        } else if (statement == "warmup") {
+            valid = stream >> script.warmupFrames && script.warmupFrames >= 0;
+        } else if (statement == "frames") {
+            valid = stream >> script.measuredFrames && script.measuredFrames > 0;
+        } else if (statement == "timestep") {
+            valid = stream >> script.timeStep && script.timeStep > 0.0f;
+        } else if (statement == "model" || statement == "primitive") {
+            BenchmarkModel model;
+            model.primitive = statement == "primitive";
+            valid = static_cast<bool>(
+                stream >> model.source >> model.position.x >> model.position.y >> model.position.z);
+            if (valid && !(stream >> model.scale)) {
+                model.scale = 1.0f;
+            }
+            script.models.push_back(model);
+        } else if (statement == "camera") {
+            CameraKeyframe key;
+            valid = stream >> key.time >> key.eye.x >> key.eye.y >> key.eye.z >> key.target.x
+                    >> key.target.y >> key.target.z
+                    && (script.cameraPath.empty() || key.time > script.cameraPath.back().time);
+            script.cameraPath.push_back(key);
+        } else if (statement == "configuration") {
+            BenchmarkConfiguration configuration;
+            valid = static_cast<bool>(stream >> configuration.name);
+            for (std::string feature; valid && stream >> feature;) {
+                if (feature == "ssao") {
+                    configuration.ssao = true;
+                } else if (feature == "bloom") {
+                    configuration.bloom = true;
+                } else {
+                    valid = false;
+                }
+            }
+            script.configurations.push_back(configuration);
+        } else {
+            valid = false;
+        }
+
+        if (!valid) {
+            throw std::runtime_error(
+                "benchmark script " + filepath + ":" + std::to_string(lineNumber) + " invalid: " + line);
+        }
+    }
+
+    if (script.configurations.empty()) {
+        script.configurations = {
+            {"base", false, false}, {"ssao", true, false}, {"bloom", false, true}, {"ssao+bloom", true, true}};
+    }
+
+    return script;
+}
+
+Benchmark::Benchmark(BenchmarkScript script, std::string reportPath, std::string renderer, int width, int height)
+    : _script(std::move(script)), _reportPath(std::move(reportPath)), _renderer(std::move(renderer)),
+      _width(width), _height(height), _frames(_script.measuredFrames) {
+    _result.configuration = _script.configurations[0];
+}
+
+bool Benchmark::beginFrame() {
+    if (_configuration == _script.configurations.size()) {
+        return false;
+    }
+
+    const auto now = std::chrono::high_resolution_clock::now();
+    const int warmupEnd = _script.warmupFrames;
+    const int measureEnd = warmupEnd + _script.measuredFrames;
+
+    // the time of a frame is from its beginning to the beginning of the next one
+    if (_frameIndex > warmupEnd && _frameIndex <= measureEnd) {
+        _frames.push(std::chrono::duration<float, std::milli>(now - _lastFrameTime).count());
+    }
+    _lastFrameTime = now;
+
+    Profiler& profiler = Profiler::get();
+    if (_frameIndex == measureEnd) {
+        // the frames to come only wait for the gpu results, their cpu times are not taken
+        _result.frames = _frames.getWindowSummary();
+        const RenderStatistics& statistics = RenderStatistics::get();
+        for (size_t i = 0; i < RenderStatistics::counterCount; ++i) {
+            _result.counters.push_back(statistics.getMean(static_cast<RenderCounter>(i)));
+        }
+        for (const Profiler::Pass& pass : profiler.getPasses()) {
+            if (pass.cpuTotalCount > 0) {
+                PassResult result;
+                result.name = pass.name;
+                result.cpuMs = pass.getMeanCpuTime();
+                result.cpuP95Ms = Profiler::getPercentile(pass.cpuHistory, pass.cpuCount, 95.0f);
+                _result.passes.push_back(result);
+            }
+        }
+    } else if (_frameIndex == measureEnd + drainFrames) {
+        for (PassResult& result : _result.passes) {
+            for (const Profiler::Pass& pass : profiler.getPasses()) {
+                if (pass.name == result.name && pass.gpuTotalCount > 0) {
+                    result.gpuMs = pass.getMeanGpuTime();
+                    result.gpuP95Ms = Profiler::getPercentile(pass.gpuHistory, pass.gpuCount, 95.0f);
+                }
+            }
+        }
+
+        _results.push_back(std::move(_result));
+        _result = Result();
+        _frameIndex = 0;
+        if (++_configuration == _script.configurations.size()) {
+            return false;
+        }
+        _result.configuration = _script.configurations[_configuration];
+        std::cout << "benchmark configuration " << _result.configuration.name << std::endl;
+    }
+
+    if (_frameIndex == warmupEnd) {
+        profiler.reset();
+        RenderStatistics::get().reset();
+        _frames.reset();
+    }
+
+    // the warm-up walks the path from its start too, the measured frames begin again at 0
+    const int pathFrame = _frameIndex < warmupEnd ? _frameIndex : _frameIndex - warmupEnd;
+    _time = pathFrame * _script.timeStep;
+    ++_frameIndex;
+
+    return true;
+}
+
+const BenchmarkConfiguration& Benchmark::getConfiguration() const {
+    return _script.configurations[std::min(_configuration, _script.configurations.size() - 1)];
+}
+
+float Benchmark::getTime() const {
+    return _time;
+}
+
+bool Benchmark::writeReport() const {
+    std::ofstream file(_reportPath);
+    if (!file) {
+        std::cerr << "write benchmark report " + _reportPath + " failure" << std::endl;
+        return false;
+    }
+
+    const std::string resolution = std::to_string(_width) + "x" + std::to_string(_height);
+    file << std::setprecision(6);
+    file << "{\n  \"renderer\": \"" << escapeJson(_renderer) << "\",\n  \"resolution\": \"" << resolution
+         << "\",\n  \"warmup_frames\": " << _script.warmupFrames
+         << ",\n  \"measured_frames\": " << _script.measuredFrames
+         << ",\n  \"timestep\": " << _script.timeStep << ",\n  \"configurations\": [";
+
+    for (size_t i = 0; i < _results.size(); ++i) {
+        const Result& result = _results[i];
+        file << (i == 0 ? "\n" : ",\n") << "    {\"name\": \"" << escapeJson(result.configuration.name)
+             << "\", \"ssao\": " << (result.configuration.ssao ? "true" : "false")
+             << ", \"bloom\": " << (result.configuration.bloom ? "true" : "false")
+             << ",\n     \"frames\": " << result.frames.toJson() << ",\n     \"passes\": {";
+        for (size_t j = 0; j < result.passes.size(); ++j) {
+            const PassResult& pass = result.passes[j];
+            file << (j == 0 ? "\n" : ",\n") << "       \"" << escapeJson(pass.name)
+                 << "\": {\"cpu_ms\": " << pass.cpuMs << ", \"cpu_p95_ms\": " << pass.cpuP95Ms;
+            if (pass.gpuMs >= 0.0) {
+                file << ", \"gpu_ms\": " << pass.gpuMs << ", \"gpu_p95_ms\": " << pass.gpuP95Ms;
+            }
+            file << "}";
+        }
+        file << "},\n     \"counters\": {";
+        for (size_t j = 0; j < result.counters.size(); ++j) {
+            file << (j == 0 ? "" : ", ") << "\"" << RenderStatistics::getName(static_cast<RenderCounter>(j))
+                 << "\": " << result.counters[j];
+        }
+        file << "}}";
+    }
+
+    // the same numbers flattened for the comparison, keyed by resolution and configuration
+    file << "\n  ],\n  \"metrics\": {";
+    bool first = true;
+    const auto metric = [&](const std::string& name, double value) {
+        file << (first ? "\n" : ",\n") << "    \"" << escapeJson(name) << "\": " << value;
+        first = false;
+    };
+    for (const Result& result : _results) {
+        const std::string prefix = resolution + "/" + result.configuration.name + "/";
+        metric(prefix + "frame_mean_ms", result.frames.meanMs);
+        metric(prefix + "frame_p50_ms", result.frames.p50Ms);
+        metric(prefix + "frame_p95_ms", result.frames.p95Ms);
+        metric(prefix + "frame_p99_ms", result.frames.p99Ms);
+        for (const PassResult& pass : result.passes) {
+            metric(prefix + pass.name + "_cpu_ms", pass.cpuMs);
+            if (pass.gpuMs >= 0.0) {
+                metric(prefix + pass.name + "_gpu_ms", pass.gpuMs);
+            }
+        }
+        // counts per frame, more is worse as with the times
+        for (size_t i = 0; i < result.counters.size(); ++i) {
+            std::string name = RenderStatistics::getName(static_cast<RenderCounter>(i));
+            std::replace(name.begin(), name.end(), ' ', '_');
+            metric(prefix + name, result.counters[i]);
+        }
+    }
+    file << "\n  }\n}\n";
+
+    if (!file) {
+        std::cerr << "write benchmark report " + _reportPath + " failure" << std::endl;
+        return false;
+    }
+
+    std::cout << "benchmark report written to " << _reportPath << std::endl;
+    return true;
+}
+
+bool compareBenchmarkReports(
+    const std::string& baselinePath, const std::string& currentPath, double tolerancePercent) {
+    // differences below this are timer noise, whatever the ratio
+    constexpr double noiseFloorMs = 0.02;
+
+    const std::map<std::string, double> baseline = readMetrics(baselinePath);
+    const std::map<std::string, double> current = readMetrics(currentPath);
+
+    int regressions = 0;
+    for (const auto& [name, before] : baseline) {
+        const auto it = current.find(name);
+        if (it == current.end()) {
+            std::cout << std::left << std::setw(48) << name << " missing" << std::endl;
+            continue;
+        }
+
+        const double after = it->second;
+        // a metric growing from zero has no ratio, e.g. uploads or state changes a baseline had
+        // none of, so any growth beyond the noise counts
+        const bool fromZero = before <= 0.0;
+        const double change = fromZero ? 0.0 : (after - before) / before * 100.0;
+        const bool regressed =
+            (fromZero || change > tolerancePercent) && after - before > noiseFloorMs;
+        regressions += regressed ? 1 : 0;
+
+        std::cout << std::left << std::setw(48) << name << std::right << std::fixed
+                  << std::setprecision(3) << std::setw(10) << before << std::setw(10) << after;
+        if (fromZero && after > before) {
+            std::cout << std::setw(10) << "new";
+        } else {
+            std::cout << std::showpos << std::setprecision(1) << std::setw(9) << change << '%'
+                      << std::noshowpos;
+        }
+        std::cout << (regressed ? "  REGRESSION" : "") << std::endl;
+    }
+
+    std::cout << regressions << " regression(s) beyond " << tolerancePercent << "%" << std::endl;
+    return regressions > 0;
+}
\ No newline at end of file
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "base/capture_recorder.h"
+#include "base/frame_statistics.h"
+#include "base/model.h"
+
+// the features a measured run turns on
+struct BenchmarkConfiguration {
+    std::string name;
+    bool ssao = false;
+    bool bloom = false;
+};
+
+// an obj file relative to the asset root, or the name of a primitive shape
+struct BenchmarkModel {
+    std::string source;
+    bool primitive = false;
+    glm::vec3 position = glm::vec3(0.0f);
+    float scale = 1.0f;
+
+    Model create(const std::string& assetRootDir) const;
+};
+
+// a benchmark scene and camera path, read from a text file with one statement per line:
+//   resolution 1280x720
+//   warmup 30
+//   frames 120
+//   timestep 0.0166667
+//   model obj/bunny.obj x y z [scale]
+//   primitive sphere x y z [scale]
+//   camera time eye_x eye_y eye_z target_x target_y target_z
+//   configuration name [ssao] [bloom]
+// # starts a comment. without configurations every combination of ssao and bloom is run
+struct BenchmarkScript {
+    // 0 keeps the window size
+    int width = 0;
+    int height = 0;
+    int warmupFrames = 30;
+    int measuredFrames = 120;
+    float timeStep = 1.0f / 60.0f;
+    std::vector<BenchmarkModel> models;
+    std::vector<CameraKeyframe> cameraPath;
+    std::vector<BenchmarkConfiguration> configurations;
+
+    static BenchmarkScript load(const std::string& filepath);
+};
+
+// runs every configuration of a script: warm-up frames, then measured frames at a fixed time
+// step along the camera path, then a few frames until the last gpu timings arrive
+class Benchmark {
+public:
+    Benchmark(BenchmarkScript script, std::string reportPath, std::string renderer, int width, int height);
+
+    // false when every configuration was run, the configuration and time are those of the new frame
+    bool beginFrame();
+
+    const BenchmarkConfiguration& getConfiguration() const;
+
+    // on the camera path
+    float getTime() const;
+
+    bool writeReport() const;
+
+private:
+    // frames rendered after the measured ones so that their gpu queries are read back
+    static constexpr int drainFrames = 2;
+
+    struct PassResult {
+        std::string name;
+        double cpuMs = 0.0;
+        double cpuP95Ms = 0.0;
+        // negative for a cpu only pass
+        double gpuMs = -1.0;
+        double gpuP95Ms = -1.0;
+    };
+
+    struct Result {
+        BenchmarkConfiguration configuration;
+        FrameTimeSummary frames;
+        std::vector<PassResult> passes;
+        // mean per measured frame of every RenderCounter
+        std::vector<double> counters;
+    };
+
+    BenchmarkScript _script;
+    std::string _reportPath;
+    std::string _renderer;
+    int _width;
+    int _height;
+
+    size_t _configuration = 0;
+    int _frameIndex = 0;
+    float _time = 0.0f;
+    FrameStatistics _frames;
+    std::chrono::time_point<std::chrono::high_resolution_clock> _lastFrameTime;
+
+    Result _result;
+    std::vector<Result> _results;
+};
+
+// prints the metrics of current that are more than tolerancePercent slower than in baseline,
+// returns whether there was one
+bool compareBenchmarkReports(
+    const std::string& baselinePath, const std::string& currentPath, double tolerancePercent);
\ No newline at end of file
@@ -1,4 +1,6 @@
+#include <cfloat>
 #include <filesystem>
+#include <fstream>
 #include <random>
 
 #include <imgui.h>
@@ -8,6 +10,13 @@
 
 #include "editor.h"
 #include "primitive_factory.h"
+#include "base/asset_index.h"
+#include "base/frame_allocator.h"
+#include "base/gl_state_cache.h"
+#include "base/memory_tracker.h"
+#include "base/profiler.h"
+#include "base/readback_service.h"
+#include "base/render_statistics.h"
 #include "base/utils.h"
 
 const std::string geometryVsRelPath = "shader/geometry.vert";
@@ -21,6 +30,9 @@ const std::string brightColorFsRelPath = "shader/extract_bright_color.frag";
 const std::string gaussianBlurFsRelPath = "shader/gaussian_blur.frag";
 const std::string blendBloomMapFsRelPath = "shader/blend_bloom_map.frag";
 
+const std::string gpuCullCsRelPath = "shader/gpu_cull.comp";
+const std::string hiZBuildCsRelPath = "shader/hiz_build.comp";
+
 const std::string quadVsRelPath = "shader/quad.vert";
 const std::string quadFsRelPath = "shader/quad.frag";
 
@@ -36,36 +48,45 @@ Editor::Editor(const Options& options) : Application(options) {
     for (size_t i = 0; i < skyboxTextureRelPaths.size(); ++i) {
         skyboxTextureFullPaths.push_back(getAssetFullPath(skyboxTextureRelPaths[i]));
     }
-    _skybox.reset(new SkyBox(skyboxTextureFullPaths));
+    {
+        MemoryOwnerScope owner("skybox");
+        _skybox.reset(new SkyBox(skyboxTextureFullPaths));
+    }
     
-    Model* ground = PrimitiveFactory::createPlane("Ground", 10, 10, 1, 1);
-    ground->transform.position = glm::vec3(0, -2, 0);
-    _models.push_back(ground);
+    Model ground = PrimitiveFactory::createPlane("Ground", 10, 10, 1, 1);
+    ground.transform.position = glm::vec3(0, -2, 0);
+    addObject(_models, std::move(ground));
 
     _ambientLight.reset(new AmbientLight("Ambient Light"));
     _ambientLight->intensity = 0.3f;
     _ambientLight->color = glm::vec3(0.21f, 0.239f, 0.3135f);
 
-    DirectionalLight* directionalLight = new DirectionalLight("Directional Light");
-    directionalLight->transform.rotation = glm::quat(glm::vec3(glm::radians(-129.0f), glm::radians(-18.0f), 0));
-    directionalLight->color = glm::vec3(1, 0.9568627f, 0.8392157f);
-    _directionalLights.push_back(directionalLight);
-
-    PointLight* pointLight = new PointLight("Point Light");
-    pointLight->transform.position = glm::vec3(-2.21f, 1.18f, 6.68f);
-    pointLight->color = glm::vec3(0.8716981f, 0.4588751f, 0.4588751f);
-    _pointLights.push_back(pointLight);
-
-    _screenQuad.reset(new FullscreenQuad);
-
-    float defaultData[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
-    _defaultTexture.reset(new Texture2D(GL_RGBA, 1, 1, GL_RGBA, GL_FLOAT, defaultData));
-    _defaultTexture->bind();
-    _defaultTexture->setParamterInt(GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    _defaultTexture->setParamterInt(GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    _defaultTexture->setParamterInt(GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    _defaultTexture->setParamterInt(GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    _defaultTexture->unbind();
+    DirectionalLight directionalLight("Directional Light");
+    directionalLight.transform.rotation = glm::quat(glm::vec3(glm::radians(-129.0f), glm::radians(-18.0f), 0));
+    directionalLight.color = glm::vec3(1, 0.9568627f, 0.8392157f);
+    addObject(_directionalLights, std::move(directionalLight));
+
+    PointLight pointLight("Point Light");
+    pointLight.transform.position = glm::vec3(-2.21f, 1.18f, 6.68f);
+    pointLight.color = glm::vec3(0.8716981f, 0.4588751f, 0.4588751f);
+    addObject(_pointLights, std::move(pointLight));
+
+    {
+        MemoryOwnerScope owner("editor");
+        _screenQuad.reset(new FullscreenQuad);
+
+        _instanceBuffer.reset(new StreamBuffer(GL_ARRAY_BUFFER));
+        _indirectBuffer.reset(new StreamBuffer(GL_DRAW_INDIRECT_BUFFER));
+
+        float defaultData[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+        _defaultTexture.reset(new Texture2D(GL_RGBA, 1, 1, GL_RGBA, GL_FLOAT, defaultData));
+        _defaultTexture->bind();
+        _defaultTexture->setParamterInt(GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        _defaultTexture->setParamterInt(GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        _defaultTexture->setParamterInt(GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        _defaultTexture->setParamterInt(GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        _defaultTexture->unbind();
+    }
 
     initGeometryPassResources();
 
@@ -75,6 +96,47 @@ Editor::Editor(const Options& options) : Application(options) {
 
     initShaders();
 
+    if (!options.benchmarkScript.empty()) {
+        BenchmarkScript script = BenchmarkScript::load(options.benchmarkScript);
+        for (const BenchmarkModel& model : script.models) {
+            addObject(_models, model.create(_assetRootDir));
+        }
+        _benchmarkPath = CaptureRecorder::makePath(script.cameraPath);
+        _benchmark = std::make_unique<Benchmark>(
+            std::move(script), options.benchmarkReport,
+            reinterpret_cast<const char*>(glGetString(GL_RENDERER)), _windowWidth, _windowHeight);
+    }
+
+    if (!options.stressObjectCounts.empty()) {
+        _stressSettings.seed = options.stressSeed;
+        _stressSettings.pointLightCount = (options.stressLightCount + 1) / 2;
+        _stressSettings.spotLightCount = options.stressLightCount / 2;
+        _stressRun = std::make_unique<StressRun>(_stressSettings, options.stressObjectCounts, 10, 60);
+
+        // a fixed view, the part of the scene in sight stays the same as it grows
+        _camera->transform.position = glm::vec3(0.0f, 15.0f, 30.0f);
+        _camera->transform.lookAt(glm::vec3(0.0f));
+    }
+
+    if (options.checkHiZ) {
+        for (Model& model : HiZCheck::createScene()) {
+            addObject(_models, std::move(model));
+        }
+        _hiZCheck = std::make_unique<HiZCheck>(24);
+    }
+
+    if (_headless) {
+        _batchAssets = options.batchAssets;
+        _batchOutputDir = options.outputDir;
+        _batchTurntableFrames = options.turntableFrames;
+        _captureQoi = options.imageFormat == "qoi";
+        _batchStartTime = std::chrono::high_resolution_clock::now();
+        return;
+    }
+
+    // the combo boxes list the assets from memory, the tree is walked once in the background
+    AssetIndex::get().start(_assetRootDir);
+
     // init imGUI
     IMGUI_CHECKVERSION();
     ImGui::CreateContext();
@@ -93,18 +155,34 @@ Editor::Editor(const Options& options) : Application(options) {
     renderScenePanel();
     ImGui::SetNextWindowPos(ImVec2(_windowWidth * 0.70, 0));
     renderInspectorPanel();
+    ImGui::SetNextWindowPos(ImVec2(_windowWidth * 0.70, _windowHeight * 0.55));
+    renderProfilerPanel();
+    ImGui::SetNextWindowPos(ImVec2(_windowWidth * 0.35f, 0));
+    ImGui::SetNextWindowCollapsed(true);
+    renderStatisticsPanel();
+    ImGui::SetNextWindowPos(ImVec2(_windowWidth * 0.35f, _windowHeight * 0.55f));
+    ImGui::SetNextWindowCollapsed(true);
+    renderMemoryPanel();
 
     ImGui::Render();
     ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 }
 
 Editor::~Editor() {
+    if (_headless) {
+        return;
+    }
+
+    AssetIndex::get().stop();
+
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
 }
 
 void Editor::initGeometryPassResources() {
+    MemoryOwnerScope owner("g-buffer");
+
     _gPosition.reset(new Texture2D(GL_RGB32F, _windowWidth, _windowHeight, GL_RGB, GL_FLOAT));
     _gPosition->bind();
     _gPosition->setParamterInt(GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -182,9 +260,30 @@ void Editor::initGeometryPassResources() {
     _gBufferShader->attachVertexShaderFromFile(getAssetFullPath(geometryVsRelPath));
     _gBufferShader->attachFragmentShaderFromFile(getAssetFullPath(geometryFsRelPath));
     _gBufferShader->link();
+    _gBufferProjectionLocation = _gBufferShader->getUniformLocation("projection");
+    _gBufferViewLocation = _gBufferShader->getUniformLocation("view");
+    _gBufferObjectDataLocation = _gBufferShader->getUniformLocation("objectData");
+
+    {
+        MemoryOwnerScope objectDataOwner("object data");
+        _objectData.reset(new ObjectDataBuffer);
+    }
+
+    // about a quarter of the window width is enough to find large occluded objects
+    const int occlusionWidth = 256;
+    _occlusionRasterizer.reset(
+        new OcclusionRasterizer(occlusionWidth, occlusionWidth * _windowHeight / _windowWidth));
+
+    if (GPUCuller::isSupported()) {
+        MemoryOwnerScope cullerOwner("gpu culler");
+        _gpuCuller.reset(new GPUCuller(
+            getAssetFullPath(gpuCullCsRelPath), getAssetFullPath(hiZBuildCsRelPath)));
+    }
 }
 
 void Editor::initSSAOPassResources() {
+    MemoryOwnerScope owner("ssao");
+
     _ssaoFBO.reset(new Framebuffer);
     _ssaoFBO->bind();
     _ssaoFBO->drawBuffer(GL_COLOR_ATTACHMENT0);
@@ -256,6 +355,8 @@ void Editor::initSSAOPassResources() {
 }
 
 void Editor::initBloomPassResources() {
+    MemoryOwnerScope owner("bloom");
+
     _bloomFBO.reset(new Framebuffer);
     _bloomFBO->bind();
     _bloomFBO->drawBuffer(GL_COLOR_ATTACHMENT0);
@@ -319,6 +420,11 @@ void Editor::initShaders() {
 }
 
 void Editor::handleInput() {
+    // a benchmark replays its camera path, input would make it irreproducible
+    if (_headless || _benchmark != nullptr || _stressRun != nullptr || _hiZCheck != nullptr) {
+        return;
+    }
+
     if (_input.keyboard.keyStates[GLFW_KEY_ESCAPE] != GLFW_RELEASE) {
         glfwSetWindowShouldClose(_window, true);
         return;
@@ -393,95 +499,254 @@ void Editor::handleInput() {
 }
 
 void Editor::renderFrame() {
+    if (_benchmark != nullptr) {
+        renderBenchmarkFrame();
+        return;
+    }
+
+    if (_stressRun != nullptr) {
+        renderStressFrame();
+        return;
+    }
+
+    if (_hiZCheck != nullptr) {
+        renderHiZCheckFrame();
+        return;
+    }
+
+    if (_headless) {
+        renderBatchFrame();
+        return;
+    }
+
     showFpsInWindowTitle();
-    
+
+    _capture.animate(_camera->transform);
+    _sceneGraph.update();
+
     renderScene();
+    _capture.capture(GLStateCache::get().getDefaultFramebuffer(), _windowWidth, _windowHeight);
     renderUI();
 }
 
-std::vector<std::string> Editor::getModelFiles() const {
-    std::vector<std::string> modelFiles;
-    for (const auto& entry : std::filesystem::directory_iterator(getAssetFullPath("obj"))) {
-        if (entry.is_regular_file() && entry.path().extension() == ".obj") {
-            modelFiles.push_back(entry.path().filename().string());
+void Editor::renderBenchmarkFrame() {
+    if (!_benchmark->beginFrame()) {
+        _benchmark->writeReport();
+        requestClose();
+        return;
+    }
+
+    const BenchmarkConfiguration& configuration = _benchmark->getConfiguration();
+    _enableSSAO = configuration.ssao;
+    _enableBloom = configuration.bloom;
+
+    _benchmarkPath(_benchmark->getTime(), _camera->transform);
+    _sceneGraph.update();
+    renderScene();
+}
+
+void Editor::renderStressFrame() {
+    switch (_stressRun->beginFrame()) {
+    case StressRun::Step::Done:
+        _stressRun->printSummary();
+        requestClose();
+        return;
+    case StressRun::Step::Generate:
+        generateStressScene(_stressRun->getSettings());
+        _stressRun->setReport(_stressReport);
+        break;
+    case StressRun::Step::Render:
+        break;
+    }
+
+    _sceneGraph.update();
+    renderScene();
+}
+
+void Editor::renderHiZCheckFrame() {
+    if (!isGPUCullingActive()) {
+        std::cout << "hi-z check skipped, the context has no compute shaders" << std::endl;
+        requestClose(HiZCheck::skippedExitCode);
+        return;
+    }
+
+    const HiZCheck::Step step = _hiZCheck->beginFrame();
+    if (step == HiZCheck::Step::Done) {
+        _hiZCheck->printSummary();
+        requestClose(_hiZCheck->hasFailed() ? EXIT_FAILURE : EXIT_SUCCESS);
+        return;
+    }
+
+    _enableHiZCulling = step != HiZCheck::Step::Reference;
+    _hiZCheck->placeCamera(*_camera);
+    _sceneGraph.update();
+    renderScene();
+
+    if (step == HiZCheck::Step::Build) {
+        return;
+    }
+
+    // a check, so the frame is read back on the spot
+    std::vector<unsigned char> pixels(static_cast<size_t>(_windowWidth) * _windowHeight * 4);
+    GLStateCache::get().bindFramebuffer(GL_READ_FRAMEBUFFER, GLStateCache::get().getDefaultFramebuffer());
+    glReadPixels(0, 0, _windowWidth, _windowHeight, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    if (step == HiZCheck::Step::Reference) {
+        _hiZCheck->setReference(std::move(pixels));
+    } else {
+        _hiZCheck->compare(pixels, _windowWidth, _windowHeight);
+    }
+}
+
+void Editor::renderBatchFrame() {
+    ReadbackService& readback = ReadbackService::get();
+
+    // a turntable spans many frames of the same asset
+    if (!_capture.isRecording()) {
+        if (_batchIndex == _batchAssets.size()) {
+            readback.finish();
+
+            const double seconds = std::chrono::duration<double>(
+                std::chrono::high_resolution_clock::now() - _batchStartTime).count();
+            std::cout << "rendered " << readback.getWrittenCount() << " images in " << seconds
+                      << " s, " << readback.getWrittenCount() / seconds << " images/s";
+            if (readback.getFailedCount() > 0) {
+                std::cout << ", " << readback.getFailedCount() << " failed";
+            }
+            std::cout << std::endl;
+
+            requestClose();
+            return;
+        }
+
+        const std::filesystem::path asset = _batchAssets[_batchIndex++];
+
+        // the previous asset is replaced, the rest of the scene stays
+        _models.erase(_batchModel);
+        _selectedKind = ObjectKind::None;
+        try {
+            _batchModel = addObject(_models, Model(asset.stem().string(), asset.string()));
+        } catch (const std::exception& e) {
+            std::cerr << "load " + asset.string() + " failure: " << e.what() << std::endl;
+            _batchModel = SlotHandle();
+            return;
+        }
+
+        _sceneGraph.update();
+
+        // the depth of the previous asset says nothing about this one
+        if (_gpuCuller != nullptr) {
+            _gpuCuller->invalidateHiZ();
+        }
+
+        const std::filesystem::path output = std::filesystem::path(_batchOutputDir) / asset.stem();
+        if (_batchTurntableFrames > 0) {
+            startTurntable(
+                _models.get(_batchModel)->getTransformedBoundingBox(), output.string(),
+                _batchTurntableFrames, _captureQoi);
+        } else {
+            select(_models.get(_batchModel));
+            zoomToFit();
+            renderScene();
+            captureScreen(output.string() + (_captureQoi ? ".qoi" : ".png"));
+            return;
         }
     }
-    return modelFiles;
+
+    _capture.animate(_camera->transform);
+    renderScene();
+    _capture.capture(GLStateCache::get().getDefaultFramebuffer(), _windowWidth, _windowHeight);
 }
 
 void Editor::renderScene() {
     glClearColor(_clearColor.r, _clearColor.g, _clearColor.b, _clearColor.a);
 
+    GeometryArena::get().compact();
+
+    // in pipelined mode the packet submitted here was prepared during the previous frame,
+    // and a job prepares the next one while this one goes to gl
+    // a captured frame must show the camera it was animated to, without the frame of latency
+    const bool pipelining = _enablePipelining && !_capture.isRecording();
+
+    FramePacket& packet = _framePackets[_currentFramePacket];
+    if (!pipelining || !_framePacketReady) {
+        ProfileScope scope("prepare", false);
+        prepareFrame(packet);
+        _framePacketReady = pipelining;
+    }
+    _objectData->upload();
+
+    if (pipelining) {
+        FramePacket& nextPacket = _framePackets[1 - _currentFramePacket];
+        JobSystem::get().submit([this, &nextPacket]() { prepareFrame(nextPacket); }, &_prepareJob);
+    }
+
     // deferred rendering: geometry pass
     _gBufferFBO->bind();
-    glEnable(GL_DEPTH_TEST);
+    GLStateCache::get().setDepthTest(true);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    _gBufferShader->use();
-    _gBufferShader->setUniformMat4("projection", _camera->getProjectionMatrix());
-    _gBufferShader->setUniformMat4("view", _camera->getViewMatrix());
-
-    for (auto* model : _models) {
-        _gBufferShader->setUniformMat4("model", model->transform.getLocalMatrix());
-        _gBufferShader->setUniformVec3("material.ka", model->material.ka);
-        _gBufferShader->setUniformVec3("material.kd", model->material.kd);
-        _gBufferShader->setUniformVec3("material.ks", model->material.ks);
-        _gBufferShader->setUniformFloat("material.ns", model->material.ns);
-        if (model->material.texture.get() != nullptr) {
-            model->material.texture->bind();
-        } else {
-            _defaultTexture->bind();
-        }
-        model->draw();
-    }
-    _skybox->draw(_camera->getProjectionMatrix(), _camera->getViewMatrix());
+    submitGeometryPass(packet);
     _gBufferFBO->unbind();
+
+    // the depth of this frame is the occluder set of the next one
+    if (isGPUCullingActive() && _enableHiZCulling) {
+        ProfileScope scope("hi-z");
+        _gpuCuller->buildHiZ(*_gDepth, _windowWidth, _windowHeight, packet.view, packet.projection);
+    } else if (_gpuCuller != nullptr) {
+        _gpuCuller->invalidateHiZ();
+    }
     
     // deferred rendering: lighting passes
     // + SSAO pass
     if (_enableSSAO) {
-        glDisable(GL_DEPTH_TEST);
-
-        _ssaoFBO->bind();
-
-        _ssaoShader->use();
-        _ssaoShader->setUniformInt("gPosition", 0);
-        _gPosition->bind(0);
-        _ssaoShader->setUniformInt("gNormal", 1);
-        _gNormal->bind(1);
-        _ssaoShader->setUniformInt("gDepth", 2);
-        _gDepth->bind(2);
-        _ssaoShader->setUniformInt("noiseMap", 3);
-        _ssaoNoise->bind(3);
-        for (size_t i = 0; i < _sampleVecs.size(); ++i) {
-            _ssaoShader->setUniformVec3("sampleVecs[" + std::to_string(i) + "]", _sampleVecs[i]);
-        }
-
-        _ssaoShader->setUniformInt("screenWidth", _windowWidth);
-        _ssaoShader->setUniformInt("screenHeight", _windowHeight);
-        _ssaoShader->setUniformFloat("zNear", ((PerspectiveCamera*)_camera.get())->znear);
-        _ssaoShader->setUniformFloat("zFar", ((PerspectiveCamera*)_camera.get())->zfar);
-        _ssaoShader->setUniformMat4("projection", _camera->getProjectionMatrix());
-        _screenQuad->draw();
-
-        _ssaoFBO->unbind();
-
-        _ssaoBlurFBO->bind();
+        GLStateCache::get().setDepthTest(false);
+
+        {
+            ProfileScope scope("ssao");
+            _ssaoFBO->bind();
+
+            _ssaoShader->use();
+            _ssaoShader->setUniformInt("gPosition", 0);
+            _gPosition->bind(0);
+            _ssaoShader->setUniformInt("gNormal", 1);
+            _gNormal->bind(1);
+            _ssaoShader->setUniformInt("gDepth", 2);
+            _gDepth->bind(2);
+            _ssaoShader->setUniformInt("noiseMap", 3);
+            _ssaoNoise->bind(3);
+            for (size_t i = 0; i < _sampleVecs.size(); ++i) {
+                _ssaoShader->setUniformVec3(frameFormat("sampleVecs[%zu]", i), _sampleVecs[i]);
+            }
 
-        _currentReadBuffer = 0;
-        _currentWriteBuffer = 1;
-        _ssaoBlurShader->use();
-        for (int pass = 0; pass < 5; ++pass) {
-            _ssaoBlurFBO->attachTexture2D(
-                *_ssaoResult[_currentWriteBuffer], GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D);
-            _ssaoBlurShader->setUniformInt("ssaoResult", 0);
-            _ssaoResult[_currentReadBuffer]->bind(0);
+            _ssaoShader->setUniformInt("screenWidth", _windowWidth);
+            _ssaoShader->setUniformInt("screenHeight", _windowHeight);
+            _ssaoShader->setUniformFloat("zNear", ((PerspectiveCamera*)_camera.get())->znear);
+            _ssaoShader->setUniformFloat("zFar", ((PerspectiveCamera*)_camera.get())->zfar);
+            _ssaoShader->setUniformMat4("projection", packet.projection);
             _screenQuad->draw();
 
-            std::swap(_currentReadBuffer, _currentWriteBuffer);
+            _ssaoFBO->unbind();
         }
+
+        {
+            ProfileScope scope("ssao blur");
+            _ssaoBlurFBO->bind();
+
+            _currentReadBuffer = 0;
+            _currentWriteBuffer = 1;
+            _ssaoBlurShader->use();
+            for (int pass = 0; pass < 5; ++pass) {
+                _ssaoBlurFBO->attachTexture2D(
+                    *_ssaoResult[_currentWriteBuffer], GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D);
+                _ssaoBlurShader->setUniformInt("ssaoResult", 0);
+                _ssaoResult[_currentReadBuffer]->bind(0);
+                _screenQuad->draw();
+
+                std::swap(_currentReadBuffer, _currentWriteBuffer);
+            }
         
-        _ssaoBlurFBO->unbind();
+            _ssaoBlurFBO->unbind();
+        }
     } else {
         _currentReadBuffer = 0;
         static const std::vector<float> ones(_windowWidth * _windowHeight, 1.0f);
@@ -489,94 +754,634 @@ void Editor::renderScene() {
         glTexImage2D(
             GL_TEXTURE_2D, 0, GL_R32F, _windowWidth, _windowHeight, 0, GL_RED, GL_FLOAT,
             ones.data());
+        RenderStatistics::get().add(RenderCounter::TextureUploadBytes, ones.size() * sizeof(float));
         _ssaoResult[0]->unbind();
     }
 
     // + bloom pass
-    _bloomFBO->bind();
-    glDisable(GL_DEPTH_TEST);
-    glClear(GL_COLOR_BUFFER_BIT);
+    {
+        ProfileScope scope("lighting");
+        _bloomFBO->bind();
+        GLStateCache::get().setDepthTest(false);
+        glClear(GL_COLOR_BUFFER_BIT);
     
-    _ssaoLightingShader->use();
+        _ssaoLightingShader->use();
     
-    _ssaoLightingShader->setUniformVec3("ambientLight.color", _ambientLight->color);
-    _ssaoLightingShader->setUniformFloat("ambientLight.intensity", _ambientLight->intensity);
-    _ssaoLightingShader->setUniformInt("nDirectionalLight", _directionalLights.size());
+        _ssaoLightingShader->setUniformVec3("ambientLight.color", _ambientLight->color);
+        _ssaoLightingShader->setUniformFloat("ambientLight.intensity", _ambientLight->intensity);
+        _ssaoLightingShader->setUniformInt("nDirectionalLight", _directionalLights.size());
    
-    for (size_t i = 0; i < _directionalLights.size(); i++) {
-        _ssaoLightingShader->setUniformVec3("directionalLights[" + std::to_string(i) + "].direction", _directionalLights[i]->transform.getFront());
-        _ssaoLightingShader->setUniformFloat("directionalLights[" + std::to_string(i) + "].intensity", _directionalLights[i]->intensity);
-        _ssaoLightingShader->setUniformVec3("directionalLights[" + std::to_string(i) + "].color", _directionalLights[i]->color);
-    }
-    _ssaoLightingShader->setUniformInt("nPointLight", _pointLights.size());
-    for (size_t i = 0; i < _pointLights.size(); i++) {
-        _ssaoLightingShader->setUniformVec3("pointLights[" + std::to_string(i) + "].position", _pointLights[i]->transform.position);
-        _ssaoLightingShader->setUniformFloat("pointLights[" + std::to_string(i) + "].intensity", _pointLights[i]->intensity);
-        _ssaoLightingShader->setUniformVec3("pointLights[" + std::to_string(i) + "].color", _pointLights[i]->color);
-        _ssaoLightingShader->setUniformFloat("pointLights[" + std::to_string(i) + "].kc", _pointLights[i]->kc);
-        _ssaoLightingShader->setUniformFloat("pointLights[" + std::to_string(i) + "].kq", _pointLights[i]->kq);
-        _ssaoLightingShader->setUniformFloat("pointLights[" + std::to_string(i) + "].kl", _pointLights[i]->kl);
-    }
-    _ssaoLightingShader->setUniformInt("nSpotLight", _spotLights.size());
-    for (size_t i = 0; i < _spotLights.size(); i++) {
-        _ssaoLightingShader->setUniformVec3("spotLights[" + std::to_string(i) + "].position", _spotLights[i]->transform.position);
-        _ssaoLightingShader->setUniformVec3("spotLights[" + std::to_string(i) + "].direction", _spotLights[i]->transform.getFront());
-        _ssaoLightingShader->setUniformFloat("spotLights[" + std::to_string(i) + "].intensity", _spotLights[i]->intensity);
-        _ssaoLightingShader->setUniformVec3("spotLights[" + std::to_string(i) + "].color", _spotLights[i]->color);
-        _ssaoLightingShader->setUniformFloat("spotLights[" + std::to_string(i) + "].angle", _spotLights[i]->angle);
-        _ssaoLightingShader->setUniformFloat("spotLights[" + std::to_string(i) + "].kc", _spotLights[i]->kc);
-        _ssaoLightingShader->setUniformFloat("spotLights[" + std::to_string(i) + "].kq", _spotLights[i]->kq);
-        _ssaoLightingShader->setUniformFloat("spotLights[" + std::to_string(i) + "].kl", _spotLights[i]->kl);
-    }
+        for (size_t i = 0; i < _directionalLights.size(); i++) {
+            _ssaoLightingShader->setUniformVec3(frameFormat("directionalLights[%zu].direction", i), _directionalLights[i].getWorldFront());
+            _ssaoLightingShader->setUniformFloat(frameFormat("directionalLights[%zu].intensity", i), _directionalLights[i].intensity);
+            _ssaoLightingShader->setUniformVec3(frameFormat("directionalLights[%zu].color", i), _directionalLights[i].color);
+        }
+        _ssaoLightingShader->setUniformInt("nPointLight", _pointLights.size());
+        for (size_t i = 0; i < _pointLights.size(); i++) {
+            _ssaoLightingShader->setUniformVec3(frameFormat("pointLights[%zu].position", i), _pointLights[i].getWorldPosition());
+            _ssaoLightingShader->setUniformFloat(frameFormat("pointLights[%zu].intensity", i), _pointLights[i].intensity);
+            _ssaoLightingShader->setUniformVec3(frameFormat("pointLights[%zu].color", i), _pointLights[i].color);
+            _ssaoLightingShader->setUniformFloat(frameFormat("pointLights[%zu].kc", i), _pointLights[i].kc);
+            _ssaoLightingShader->setUniformFloat(frameFormat("pointLights[%zu].kq", i), _pointLights[i].kq);
+            _ssaoLightingShader->setUniformFloat(frameFormat("pointLights[%zu].kl", i), _pointLights[i].kl);
+        }
+        _ssaoLightingShader->setUniformInt("nSpotLight", _spotLights.size());
+        for (size_t i = 0; i < _spotLights.size(); i++) {
+            _ssaoLightingShader->setUniformVec3(frameFormat("spotLights[%zu].position", i), _spotLights[i].getWorldPosition());
+            _ssaoLightingShader->setUniformVec3(frameFormat("spotLights[%zu].direction", i), _spotLights[i].getWorldFront());
+            _ssaoLightingShader->setUniformFloat(frameFormat("spotLights[%zu].intensity", i), _spotLights[i].intensity);
+            _ssaoLightingShader->setUniformVec3(frameFormat("spotLights[%zu].color", i), _spotLights[i].color);
+            _ssaoLightingShader->setUniformFloat(frameFormat("spotLights[%zu].angle", i), _spotLights[i].angle);
+            _ssaoLightingShader->setUniformFloat(frameFormat("spotLights[%zu].kc", i), _spotLights[i].kc);
+            _ssaoLightingShader->setUniformFloat(frameFormat("spotLights[%zu].kq", i), _spotLights[i].kq);
+            _ssaoLightingShader->setUniformFloat(frameFormat("spotLights[%zu].kl", i), _spotLights[i].kl);
+        }
     
-    _ssaoLightingShader->setUniformVec3("viewPos", _camera->transform.position);
-
-    _ssaoLightingShader->setUniformInt("gPosition", 0);
-    _gPosition->bind(0);
-    _ssaoLightingShader->setUniformInt("gNormal", 1);
-    _gNormal->bind(1);
-    _ssaoLightingShader->setUniformInt("gAlbedo", 2);
-    _gAlbedo->bind(2);
-    _ssaoLightingShader->setUniformInt("gKa", 3);
-    _gKa->bind(3);
-    _ssaoLightingShader->setUniformInt("gKs", 4);
-    _gKs->bind(4);
-    _ssaoLightingShader->setUniformInt("gNs", 5);
-    _gNs->bind(5);
-    _ssaoLightingShader->setUniformInt("ssaoResult", 6);
-    _ssaoResult[_currentReadBuffer]->bind(6);
+        _ssaoLightingShader->setUniformVec3("viewPos", packet.eye);
 
-    _screenQuad->draw();
+        _ssaoLightingShader->setUniformInt("gPosition", 0);
+        _gPosition->bind(0);
+        _ssaoLightingShader->setUniformInt("gNormal", 1);
+        _gNormal->bind(1);
+        _ssaoLightingShader->setUniformInt("gAlbedo", 2);
+        _gAlbedo->bind(2);
+        _ssaoLightingShader->setUniformInt("gKa", 3);
+        _gKa->bind(3);
+        _ssaoLightingShader->setUniformInt("gKs", 4);
+        _gKs->bind(4);
+        _ssaoLightingShader->setUniformInt("gNs", 5);
+        _gNs->bind(5);
+        _ssaoLightingShader->setUniformInt("ssaoResult", 6);
+        _ssaoResult[_currentReadBuffer]->bind(6);
+
+        _screenQuad->draw();
 
-    glEnable(GL_DEPTH_TEST);
+        GLStateCache::get().setDepthTest(true);
 
-    _bloomFBO->unbind();
+        _bloomFBO->unbind();
+    }
 
     if (_enableBloom) {
         extractBrightColor(*_bloomMap);
         blurBrightColor();
         combineSceneMapAndBloomBlur(*_bloomMap);
     } else {
-        glDisable(GL_DEPTH_TEST);
+        ProfileScope scope("present");
+        GLStateCache::get().setDepthTest(false);
         _drawScreenShader->use();
         _drawScreenShader->setUniformInt("frame", 0);
         _bloomMap->bind(0);
         _screenQuad->draw();
     }
+
+    // the ui may change the scene, the next packet must be complete before that
+    if (pipelining) {
+        JobSystem::get().wait(_prepareJob);
+        _currentFramePacket = 1 - _currentFramePacket;
+    }
+}
+
+void Editor::prepareFrame(FramePacket& packet) {
+    enum RenderPass { OpaquePass = 0 };
+
+    packet.view = _camera->getViewMatrix();
+    packet.projection = _camera->getProjectionMatrix();
+    packet.eye = _camera->transform.position;
+    packet.frustum = _camera->getFrustum();
+    packet.gpuCulling = isGPUCullingActive();
+    packet.stats = GeometryPassStats{};
+
+    const glm::vec3 front = _camera->transform.getFront();
+    const uint32_t program = _gBufferShader->getHandle();
+
+    // the gpu path tests every object itself
+    const bool cpuCulling = !packet.gpuCulling;
+
+    // object slots follow _models, a slot whose content changes is simply recomputed
+    _objectData->resize(_models.size());
+    uint64_t sceneTriangles = 0;
+    for (size_t i = 0; i < _models.size(); ++i) {
+        _objectData->update(static_cast<uint32_t>(i), _models[i].getWorldMatrix(), _models[i].material);
+        sceneTriangles += _models[i].getFaceCount();
+    }
+    _objectData->prepare();
+    packet.stats.updatedObjects = static_cast<uint32_t>(_objectData->getUpdatedCount());
+
+    // chunks are culled as jobs and joined in order, so the result does not depend on timing
+    constexpr size_t cullGrainSize = 1024;
+    const auto& frustum = packet.frustum;
+    packet.cullChunks.resize((_models.size() + cullGrainSize - 1) / cullGrainSize);
+    JobSystem::get().parallelFor(_models.size(), cullGrainSize, [&](size_t begin, size_t end) {
+        std::vector<GeometryDraw>& chunk = packet.cullChunks[begin / cullGrainSize];
+        chunk.clear();
+        for (size_t i = begin; i < end; ++i) {
+            const glm::mat4& modelMatrix = _objectData->getModelMatrix(static_cast<uint32_t>(i));
+            if (cpuCulling && !frustum.intersect(_models[i].getBoundingBox(), modelMatrix)) {
+                continue;
+            }
+
+            chunk.push_back({&_models[i], modelMatrix, static_cast<uint32_t>(i)});
+        }
+    });
+
+    std::vector<GeometryDraw>& draws = packet.draws;
+    draws.clear();
+    for (const auto& chunk : packet.cullChunks) {
+        draws.insert(draws.end(), chunk.begin(), chunk.end());
+    }
+
+    if (cpuCulling && _enableOcclusionCulling) {
+        cullOccludedDraws(packet);
+    }
+
+    auto getTexture = [this](const Model* model) -> const std::shared_ptr<Texture2D>& {
+        const std::shared_ptr<Texture2D>& texture = model->material.texture;
+        return texture != nullptr ? texture : _defaultTexture;
+    };
+
+    DrawList& drawList = packet.drawList;
+    drawList.clear();
+    drawList.reserve(draws.size());
+    for (size_t i = 0; i < draws.size(); ++i) {
+        const Model* model = draws[i].model;
+        const glm::mat4& modelMatrix = draws[i].modelMatrix;
+        const BoundingBox& bbox = model->getBoundingBox();
+
+        // front to back inside a state bucket, helps early depth rejection
+        const glm::vec3 center = glm::vec3(modelMatrix * glm::vec4((bbox.min + bbox.max) * 0.5f, 1.0f));
+        const float depth = glm::dot(center - packet.eye, front) / _camera->zfar;
+
+        const uint64_t key = DrawKey::make(
+            OpaquePass, program, getTexture(model)->getHandle(), model->getMesh().getId(), depth);
+        drawList.add(key, static_cast<uint32_t>(i));
+    }
+    drawList.sort();
+
+    const auto& sorted = drawList.getPackets();
+    packet.stats.visibleObjects = static_cast<uint32_t>(sorted.size());
+
+    // instance records follow the sorted order, so every run of equal mesh and texture
+    // is a contiguous range of the instance buffer
+    packet.instances.resize(sorted.size());
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        packet.instances[i].objectIndex = draws[sorted[i].index].object;
+    }
+
+    if (packet.gpuCulling) {
+        packet.cullObjects.resize(sorted.size());
+        for (size_t i = 0; i < sorted.size(); ++i) {
+            const GeometryDraw& draw = draws[sorted[i].index];
+            packet.cullObjects[i].sphere =
+                CullObject::getBoundingSphere(draw.model->getBoundingBox(), draw.modelMatrix);
+        }
+    }
+
+    // one command per run of equal mesh, one batch per run of equal texture.
+    // the packet keeps the meshes and textures alive, the objects may be gone when it is submitted
+    packet.commands.clear();
+    packet.commandMeshes.clear();
+    packet.batches.clear();
+    size_t begin = 0;
+    while (begin < sorted.size()) {
+        const Model* model = draws[sorted[begin].index].model;
+        const Mesh& mesh = model->getMesh();
+        const std::shared_ptr<Texture2D>& texture = getTexture(model);
+
+        size_t end = begin + 1;
+        while (end < sorted.size()) {
+            const Model* next = draws[sorted[end].index].model;
+            if (&next->getMesh() != &mesh || getTexture(next) != texture) {
+                break;
+            }
+            ++end;
+        }
+
+        if (packet.batches.empty() || packet.batches.back().texture != texture) {
+            packet.batches.push_back({texture, static_cast<uint32_t>(packet.commands.size()), 0});
+        }
+
+        // the geometry range is filled in at submission, the arena may compact before that
+        DrawElementsIndirectCommand command = {};
+        // with gpu culling the run only reserves records, the culling shader counts the instances
+        command.instanceCount = packet.gpuCulling ? 0 : static_cast<uint32_t>(end - begin);
+        command.baseInstance = static_cast<uint32_t>(begin);
+        if (packet.gpuCulling) {
+            for (size_t i = begin; i < end; ++i) {
+                packet.cullObjects[i].command = static_cast<uint32_t>(packet.commands.size());
+            }
+        }
+        packet.commands.push_back(command);
+        packet.commandMeshes.push_back(model->getSharedMesh());
+        packet.stats.submittedTriangles += static_cast<uint64_t>(mesh.getFaceCount()) * (end - begin);
+        ++packet.batches.back().commandCount;
+
+        begin = end;
+    }
+
+    packet.stats.textureChanges = static_cast<uint32_t>(packet.batches.size());
+    packet.stats.culledTriangles = sceneTriangles - packet.stats.submittedTriangles;
+}
+
+void Editor::cullOccludedDraws(FramePacket& packet) {
+    // occluders are the models that look largest from the camera and are cheap to rasterize
+    constexpr size_t maxOccluders = 16;
+    constexpr size_t maxOccluderFaces = 4096;
+    constexpr float minOccluderScreenSize = 0.1f;
+
+    std::vector<GeometryDraw>& draws = packet.draws;
+
+    std::vector<std::pair<float, size_t>>& candidates = packet.occluderCandidates;
+    candidates.clear();
+    for (size_t i = 0; i < draws.size(); ++i) {
+        const GeometryDraw& draw = draws[i];
+        if (draw.model->getFaceCount() > maxOccluderFaces) {
+            continue;
+        }
+
+        const glm::vec4 sphere =
+            CullObject::getBoundingSphere(draw.model->getBoundingBox(), draw.modelMatrix);
+        const float distance = std::max(glm::length(glm::vec3(sphere) - packet.eye), _camera->znear);
+        const float screenSize = sphere.w / distance;
+        if (screenSize >= minOccluderScreenSize) {
+            candidates.push_back({screenSize, i});
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.first > rhs.first || (lhs.first == rhs.first && lhs.second < rhs.second);
+    });
+    candidates.resize(std::min(candidates.size(), maxOccluders));
+
+    std::vector<bool>& isOccluder = packet.isOccluder;
+    isOccluder.assign(draws.size(), false);
+    _occlusionRasterizer->beginFrame(packet.projection * packet.view);
+    for (const auto& candidate : candidates) {
+        const GeometryDraw& draw = draws[candidate.second];
+        const MeshData& data = draw.model->getMesh().getData();
+        _occlusionRasterizer->addOccluder(data.vertices, data.indices, draw.modelMatrix);
+        isOccluder[candidate.second] = true;
+    }
+    _occlusionRasterizer->rasterize();
+
+    size_t visibleCount = 0;
+    for (size_t i = 0; i < draws.size(); ++i) {
+        if (isOccluder[i] || _occlusionRasterizer->isVisible(draws[i].model->getTransformedBoundingBox())) {
+            draws[visibleCount++] = draws[i];
+        }
+    }
+
+    packet.stats.occluders = static_cast<uint32_t>(candidates.size());
+    packet.stats.occludedObjects = static_cast<uint32_t>(draws.size() - visibleCount);
+    draws.resize(visibleCount);
+}
+
+void Editor::submitGeometryPass(FramePacket& packet) {
+    Profiler& profiler = Profiler::get();
+    const int geometryPass = profiler.begin("geometry", true);
+
+    _geometryPassStats = packet.stats;
+
+    GeometryArena& arena = GeometryArena::get();
+    for (size_t i = 0; i < packet.commands.size(); ++i) {
+        const GeometryRange& range = arena.getRange(packet.commandMeshes[i]->getGeometry());
+        DrawElementsIndirectCommand& command = packet.commands[i];
+        command.count = range.indexCount;
+        command.firstIndex = range.firstIndex;
+        command.baseVertex = static_cast<int32_t>(range.baseVertex);
+    }
+
+    GLuint instanceSource = _instanceBuffer->getHandle();
+    if (!packet.commands.empty()) {
+        _instanceBuffer->upload(
+            packet.instances.data(), packet.instances.size() * sizeof(InstanceData));
+        _objectData->bind(1);
+
+        if (arena.supportsMultiDrawIndirect()) {
+            _indirectBuffer->upload(
+                packet.commands.data(), packet.commands.size() * sizeof(DrawElementsIndirectCommand));
+            if (packet.gpuCulling) {
+                _gpuCuller->cull(
+                    packet.cullObjects, _instanceBuffer->getHandle(), _indirectBuffer->getHandle(),
+                    packet.frustum, _enableHiZCulling);
+                instanceSource = _gpuCuller->getCulledInstanceBuffer();
+            }
+        }
+    }
+
+    // every job records a range of commands into its own buffer, the replay keeps the order
+    constexpr size_t recordGrainSize = 256;
+    const size_t sliceCount = (packet.commands.size() + recordGrainSize - 1) / recordGrainSize;
+    _geometryCommands.resize(sliceCount + 1);
+    JobSystem::get().parallelFor(packet.commands.size(), recordGrainSize, [&](size_t begin, size_t end) {
+        CommandBuffer& commands = _geometryCommands[begin / recordGrainSize];
+        commands.clear();
+        recordGeometryCommands(packet, begin, end, instanceSource, commands);
+    });
+
+    CommandBuffer& skyboxCommands = _geometryCommands.back();
+    skyboxCommands.clear();
+    _skybox->record(skyboxCommands, packet.projection, packet.view);
+
+    for (size_t i = 0; i < sliceCount; ++i) {
+        _geometryCommands[i].execute();
+        _geometryPassStats.drawCalls += static_cast<uint32_t>(_geometryCommands[i].getDrawCount());
+    }
+    profiler.end(geometryPass);
+    TraceRecorder::get().counter("draw calls", _geometryPassStats.drawCalls);
+
+    // the indirect commands are counted as draws, their triangles only the packet knows
+    RenderStatistics& statistics = RenderStatistics::get();
+    if (arena.supportsMultiDrawIndirect()) {
+        statistics.add(RenderCounter::TrianglesSubmitted, packet.stats.submittedTriangles);
+    }
+    statistics.add(RenderCounter::TrianglesCulled, packet.stats.culledTriangles);
+
+    ProfileScope scope("skybox");
+    skyboxCommands.execute();
+}
+
+void Editor::recordGeometryCommands(
+    const FramePacket& packet, size_t begin, size_t end, GLuint instanceSource,
+    CommandBuffer& commands) const {
+    // the replay state of the previous range is unknown, so every range sets up the pass
+    commands.useProgram(_gBufferShader->getHandle());
+    commands.setUniformMat4(_gBufferProjectionLocation, packet.projection);
+    commands.setUniformMat4(_gBufferViewLocation, packet.view);
+    commands.setUniformInt(_gBufferObjectDataLocation, 1);
+
+    const bool multiDraw = GeometryArena::get().supportsMultiDrawIndirect();
+    if (multiDraw) {
+        commands.setInstanceSource(instanceSource, 0);
+    }
+
+    // the first batch that ends after begin
+    auto batch = std::upper_bound(
+        packet.batches.begin(), packet.batches.end(), begin,
+        [](size_t command, const GeometryBatch& batch) {
+            return command < batch.firstCommand + batch.commandCount;
+        });
+    for (; batch != packet.batches.end() && batch->firstCommand < end; ++batch) {
+        const size_t first = std::max<size_t>(begin, batch->firstCommand);
+        const size_t last = std::min<size_t>(end, batch->firstCommand + batch->commandCount);
+
+        commands.bindTexture(0, GL_TEXTURE_2D, batch->texture->getHandle());
+        if (multiDraw) {
+            commands.multiDrawIndirect(
+                _indirectBuffer->getHandle(), first * sizeof(DrawElementsIndirectCommand),
+                static_cast<GLsizei>(last - first));
+        } else {
+            // gl 3.3 has no base instance, so the instance attributes are moved to each run instead
+            for (size_t i = first; i < last; ++i) {
+                const DrawElementsIndirectCommand& command = packet.commands[i];
+                commands.setInstanceSource(instanceSource, command.baseInstance * sizeof(InstanceData));
+                commands.drawElementsInstanced(
+                    command.count, command.firstIndex, command.instanceCount, command.baseVertex);
+            }
+        }
+    }
+}
+
+bool Editor::isGPUCullingActive() const {
+    return _gpuCuller != nullptr && _enableGPUCulling;
 }
 
 void Editor::renderUI() {
+    ProfileScope scope("ui");
+
     ImGui_ImplOpenGL3_NewFrame();
     ImGui_ImplGlfw_NewFrame();
     ImGui::NewFrame();
 
     renderScenePanel();
     renderInspectorPanel();
+    renderProfilerPanel();
+    renderStatisticsPanel();
+    renderMemoryPanel();
 
     ImGui::Render();
     ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 }
 
+void Editor::renderProfilerPanel() {
+    const auto flags = ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoSavedSettings;
+
+    if (!ImGui::Begin("Profiler", nullptr, flags)) {
+        ImGui::End();
+        return;
+    }
+
+    // frame times of the recent window, exact percentiles
+    const FrameTimeSummary frames = _frameStatistics.getWindowSummary();
+    char overlay[64];
+    std::snprintf(overlay, sizeof(overlay), "frame %.2f ms (%.1f fps)", frames.meanMs, frames.getFramesPerSecond());
+    ImGui::PlotLines(
+        "##frames", _frameStatistics.getHistory(), _frameStatistics.getHistorySize(),
+        _frameStatistics.getHistoryOffset(), overlay, 0.0f, FLT_MAX, ImVec2(0, 60));
+    ImGui::Text(
+        "min %.2f  max %.2f  p50 %.2f  p95 %.2f  p99 %.2f  p99.9 %.2f ms", frames.minMs, frames.maxMs,
+        frames.p50Ms, frames.p95Ms, frames.p99Ms, frames.p999Ms);
+    ImGui::Text("%zu hitches over %.0fx the median", frames.hitchCount, FrameStatistics::hitchFactor);
+
+    // the whole run, estimated
+    const FrameTimeSummary run = _frameStatistics.getSummary();
+    ImGui::Text(
+        "run: %zu frames, p99 %.2f ms, p99.9 %.2f ms, %zu hitches", run.frameCount, run.p99Ms,
+        run.p999Ms, run.hitchCount);
+    if (ImGui::Button("reset frame statistics")) {
+        _frameStatistics.reset();
+    }
+    ImGui::Separator();
+
+    Profiler& profiler = Profiler::get();
+    bool enabled = profiler.isEnabled();
+    if (ImGui::Checkbox("enabled", &enabled)) {
+        profiler.setEnabled(enabled);
+    }
+
+    TraceRecorder& trace = TraceRecorder::get();
+    if (trace.isRecording()) {
+        ImGui::Text("recording trace");
+    } else {
+        ImGui::InputInt("trace frames", &_traceFrameCount);
+        _traceFrameCount = std::max(_traceFrameCount, 1);
+        if (ImGui::Button("record trace")) {
+            std::filesystem::create_directories("../captures");
+            trace.start(_traceFrameCount, "../captures/trace.json");
+        }
+    }
+
+    // percentiles are taken over the gpu time of a gpu pass, over the cpu time otherwise
+    const std::vector<Profiler::Pass>& passes = profiler.getPasses();
+    if (ImGui::BeginTable("passes", 6, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit)) {
+        ImGui::TableSetupColumn("pass");
+        ImGui::TableSetupColumn("cpu ms");
+        ImGui::TableSetupColumn("gpu ms");
+        ImGui::TableSetupColumn("p50");
+        ImGui::TableSetupColumn("p95");
+        ImGui::TableSetupColumn("p99");
+        ImGui::TableHeadersRow();
+
+        for (size_t i = 0; i < passes.size(); ++i) {
+            const Profiler::Pass& pass = passes[i];
+            const std::vector<float>& history = pass.gpu ? pass.gpuHistory : pass.cpuHistory;
+            const size_t count = pass.gpu ? pass.gpuCount : pass.cpuCount;
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            if (ImGui::Selectable(pass.name.c_str(), _profilerPlotPass == static_cast<int>(i))) {
+                _profilerPlotPass = static_cast<int>(i);
+            }
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", pass.getLastCpuTime());
+            ImGui::TableNextColumn();
+            if (pass.gpu) {
+                ImGui::Text("%.3f", pass.getLastGpuTime());
+            } else {
+                ImGui::TextUnformatted("-");
+            }
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", Profiler::getPercentile(history, count, 50.0f));
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", Profiler::getPercentile(history, count, 95.0f));
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", Profiler::getPercentile(history, count, 99.0f));
+        }
+        ImGui::EndTable();
+    }
+
+    // the history of the selected pass, oldest sample first
+    if (_profilerPlotPass < static_cast<int>(passes.size())) {
+        const Profiler::Pass& pass = passes[_profilerPlotPass];
+        const std::vector<float>& history = pass.gpu ? pass.gpuHistory : pass.cpuHistory;
+        const size_t next = pass.gpu ? pass.gpuNext : pass.cpuNext;
+        ImGui::PlotLines(
+            "##history", history.data(), static_cast<int>(history.size()), static_cast<int>(next),
+            frameFormat("%s %s", pass.name.c_str(), pass.gpu ? "gpu ms" : "cpu ms"), 0.0f, FLT_MAX, ImVec2(0, 60));
+    }
+
+    ImGui::End();
+}
+
+void Editor::renderStatisticsPanel() {
+    const auto flags = ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoSavedSettings;
+
+    if (!ImGui::Begin("Render Statistics", nullptr, flags)) {
+        ImGui::End();
+        return;
+    }
+
+    // the frames include the editor ui, but not the gl calls of the ImGui backend itself
+    RenderStatistics& statistics = RenderStatistics::get();
+    if (ImGui::BeginTable("counters", 3, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit)) {
+        ImGui::TableSetupColumn("counter");
+        ImGui::TableSetupColumn("last frame");
+        ImGui::TableSetupColumn("mean");
+        ImGui::TableHeadersRow();
+
+        for (size_t i = 0; i < RenderStatistics::counterCount; ++i) {
+            const auto counter = static_cast<RenderCounter>(i);
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(RenderStatistics::getName(counter));
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(statistics.getLastFrame(counter)));
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", statistics.getMean(counter));
+        }
+        ImGui::EndTable();
+    }
+    if (ImGui::Button("reset mean")) {
+        statistics.reset();
+    }
+
+    ImGui::Separator();
+    ImGui::Text("live gl objects");
+    if (ImGui::BeginTable("objects", 2, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit)) {
+        for (size_t i = 0; i < RenderStatistics::objectTypeCount; ++i) {
+            const auto type = static_cast<GLObjectType>(i);
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(RenderStatistics::getName(type));
+            ImGui::TableNextColumn();
+            ImGui::Text("%lld", static_cast<long long>(statistics.getLiveCount(type)));
+        }
+        ImGui::EndTable();
+    }
+
+    ImGui::Separator();
+    const FrameAllocator& frameAllocator = FrameAllocator::get();
+    ImGui::Text(
+        "frame memory %.1f KB of %.1f KB", frameAllocator.getUsedSize() / 1024.0f,
+        frameAllocator.getCapacity() / 1024.0f);
+    if (frameAllocator.getLastFrameHeapAllocations() >= 0) {
+        ImGui::Text(
+            "heap allocations last frame %lld, max %lld",
+            static_cast<long long>(frameAllocator.getLastFrameHeapAllocations()),
+            static_cast<long long>(frameAllocator.getMaxHeapAllocations()));
+    } else {
+        ImGui::TextDisabled("heap allocations not counted");
+    }
+
+    ImGui::End();
+}
+
+void Editor::renderMemoryPanel() {
+    const auto flags = ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoSavedSettings;
+
+    if (!ImGui::Begin("Memory", nullptr, flags)) {
+        ImGui::End();
+        return;
+    }
+
+    const float megabyte = 1024.0f * 1024.0f;
+    MemoryTracker& tracker = MemoryTracker::get();
+    ImGui::Text("gpu %.2f MB (peak %.2f MB)", tracker.getGpuTotal() / megabyte, tracker.getGpuPeak() / megabyte);
+    ImGui::Text("cpu %.2f MB (peak %.2f MB)", tracker.getCpuTotal() / megabyte, tracker.getCpuPeak() / megabyte);
+    for (size_t i = 0; i < MemoryTracker::categoryCount; ++i) {
+        const auto category = static_cast<MemoryCategory>(i);
+        ImGui::BulletText("%s %.2f MB", MemoryTracker::getName(category), tracker.getTotal(category) / megabyte);
+    }
+
+    if (ImGui::Button("dump")) {
+        std::filesystem::create_directories("../captures");
+        std::ofstream file("../captures/memory.txt");
+        tracker.dump(file);
+        tracker.dump(std::cout);
+        if (!file) {
+            std::cerr << "write ../captures/memory.txt failure" << std::endl;
+        }
+    }
+
+    // a stress scene has an owner per object, only the visible rows are drawn
+    const std::vector<MemoryTracker::OwnerUsage> usages = tracker.getUsageByOwner();
+    const auto tableFlags = ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit | ImGuiTableFlags_ScrollY;
+    if (ImGui::BeginTable("owners", 3, tableFlags, ImVec2(0.0f, ImGui::GetTextLineHeightWithSpacing() * 12))) {
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableSetupColumn("owner");
+        ImGui::TableSetupColumn("gpu MB");
+        ImGui::TableSetupColumn("cpu MB");
+        ImGui::TableHeadersRow();
+
+        ImGuiListClipper clipper;
+        clipper.Begin(static_cast<int>(usages.size()));
+        while (clipper.Step()) {
+            for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
+                const MemoryTracker::OwnerUsage& usage = usages[row];
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(usage.owner.c_str());
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", usage.getGpuBytes() / megabyte);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", usage.getCpuBytes() / megabyte);
+            }
+        }
+        ImGui::EndTable();
+    }
+
+    ImGui::End();
+}
+
 void Editor::renderInspectorPanel() {
     const auto flags = ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoSavedSettings;
     
@@ -585,10 +1390,14 @@ void Editor::renderInspectorPanel() {
         return;
     }
 
+    Object* selectedObject = getSelectedObject();
     if (selectedObject != nullptr) {
         selectedObject->renderInspector();
-        if (dynamic_cast<AmbientLight*>(selectedObject) == nullptr && ImGui::Button("Delete Object")) {
-            ImGui::OpenPopup("Delete Object");
+        if (_selectedKind != ObjectKind::AmbientLight) {
+            renderParentSelector();
+            if (ImGui::Button("Delete Object")) {
+                ImGui::OpenPopup("Delete Object");
+            }
         }
     } else {
         ImGui::Text("No object selected");
@@ -619,12 +1428,12 @@ void Editor::renderScenePanel() {
         return;
     }
 
+    // children are listed under their parent, whatever section the parent is in
     int itemCount = 0;
     if (ImGui::CollapsingHeader("Models              ")) {
         for (int i = 0; i < _models.size(); i++) {
-            std::string label = _models[i]->name + "##" + std::to_string(itemCount++);
-            if (ImGui::Selectable(label.c_str(), selectedObject == _models[i])) {
-                selectedObject = _models[i];
+            if (_models[i].getParent() == nullptr) {
+                renderObjectTree(&_models[i], itemCount);
             }
         }
 
@@ -638,25 +1447,22 @@ void Editor::renderScenePanel() {
     }
 
     if (ImGui::CollapsingHeader("Lights              ")) {
-        if (ImGui::Selectable(_ambientLight->name.c_str(), selectedObject == _ambientLight.get())) {
-            selectedObject = _ambientLight.get();
+        if (ImGui::Selectable(_ambientLight->name.c_str(), _selectedKind == ObjectKind::AmbientLight)) {
+            select(_ambientLight.get());
         }
         for (int i = 0; i < _directionalLights.size(); i++) {
-            std::string label = _directionalLights[i]->name + "##" + std::to_string(itemCount++);
-            if (ImGui::Selectable(label.c_str(), selectedObject == _directionalLights[i])) {
-                selectedObject = _directionalLights[i];
+            if (_directionalLights[i].getParent() == nullptr) {
+                renderObjectTree(&_directionalLights[i], itemCount);
             }
         }
         for (int i = 0; i < _pointLights.size(); i++) {
-            std::string label = _pointLights[i]->name + "##" + std::to_string(itemCount++);
-            if (ImGui::Selectable(label.c_str(), selectedObject == _pointLights[i])) {
-                selectedObject = _pointLights[i];
+            if (_pointLights[i].getParent() == nullptr) {
+                renderObjectTree(&_pointLights[i], itemCount);
             }
         }
         for (int i = 0; i < _spotLights.size(); i++) {
-            std::string label = _spotLights[i]->name + "##" + std::to_string(itemCount++);
-            if (ImGui::Selectable(label.c_str(), selectedObject == _spotLights[i])) {
-                selectedObject = _spotLights[i];
+            if (_spotLights[i].getParent() == nullptr) {
+                renderObjectTree(&_spotLights[i], itemCount);
             }
         }
 
@@ -669,10 +1475,64 @@ void Editor::renderScenePanel() {
         }
     }
 
+    if (ImGui::CollapsingHeader("Stress Scene        ")) {
+        renderStressScenePanel();
+    }
+
     ImGui::Separator();
     ImGui::Checkbox("bloom", &_enableBloom);
     ImGui::SameLine();
     ImGui::Checkbox("ssao", &_enableSSAO);
+    if (_gpuCuller != nullptr) {
+        ImGui::Checkbox("gpu culling", &_enableGPUCulling);
+        ImGui::SameLine();
+        ImGui::Checkbox("hi-z", &_enableHiZCulling);
+    }
+    ImGui::Checkbox("occlusion", &_enableOcclusionCulling);
+    ImGui::SameLine();
+    ImGui::Checkbox("pipelined", &_enablePipelining);
+
+    const GLStateStats& glStats = GLStateCache::get().getLastFrameStats();
+    ImGui::Text("gl state: %u issued, %u skipped", glStats.issued, glStats.skipped);
+    ImGui::Text(
+        "geometry: %u objects, %u draw calls, %u texture changes, %u updated",
+        _geometryPassStats.visibleObjects, _geometryPassStats.drawCalls,
+        _geometryPassStats.textureChanges, _geometryPassStats.updatedObjects);
+    ImGui::Text(
+        "transforms: %zu nodes, %zu updated", _sceneGraph.getNodeCount(),
+        _sceneGraph.getUpdatedCount());
+    if (ImGui::Button("benchmark jobs")) {
+        benchmarkParallelFor();
+    }
+
+    if (_capture.isRecording()) {
+        ImGui::Text("capturing frame %d / %d", _capture.getFrameIndex(), _capture.getFrameCount());
+    } else {
+        ImGui::InputInt("frames", &_captureFrameCount);
+        _captureFrameCount = std::max(_captureFrameCount, 1);
+        ImGui::Checkbox("qoi", &_captureQoi);
+        ImGui::SameLine();
+        if (ImGui::Button("turntable")) {
+            // around the selected model, or the origin when there is none
+            BoundingBox bbox{glm::vec3(-1.0f), glm::vec3(1.0f)};
+            if (_selectedKind == ObjectKind::Model) {
+                bbox = _models.get(_selectedHandle)->getTransformedBoundingBox();
+            }
+            startTurntable(bbox, "../captures/turntable", _captureFrameCount, _captureQoi);
+        }
+
+        const CaptureReport& report = _capture.getReport();
+        if (report.frameCount > 0) {
+            ImGui::Text(
+                "last capture: %.1f frames/s, peak %.1f MB", report.framesPerSecond,
+                report.peakReadbackBytes / (1024.0 * 1024.0));
+        }
+    }
+    if (_enableOcclusionCulling && !isGPUCullingActive()) {
+        ImGui::Text(
+            "occlusion: %u occluders, %u objects hidden", _geometryPassStats.occluders,
+            _geometryPassStats.occludedObjects);
+    }
 
     if (_input.keyboard.keyStates[GLFW_KEY_P] != GLFW_RELEASE) {
         ImGui::OpenPopup("Screen Shot");
@@ -684,6 +1544,115 @@ void Editor::renderScenePanel() {
     ImGui::End();
 }
 
+void Editor::renderStressScenePanel() {
+    static const char* distributions[] = {"grid", "uniform", "clusters"};
+
+    int seed = static_cast<int>(_stressSettings.seed);
+    if (ImGui::InputInt("seed", &seed)) {
+        _stressSettings.seed = static_cast<uint32_t>(seed);
+    }
+    ImGui::InputInt("objects", &_stressSettings.objectCount, 100, 10000);
+    _stressSettings.objectCount = std::clamp(_stressSettings.objectCount, 0, 1000000);
+    int distribution = static_cast<int>(_stressSettings.distribution);
+    if (ImGui::Combo("distribution", &distribution, distributions, IM_ARRAYSIZE(distributions))) {
+        _stressSettings.distribution = static_cast<StressDistribution>(distribution);
+    }
+    ImGui::SliderFloat("spacing", &_stressSettings.spacing, 1.0f, 10.0f);
+    ImGui::SliderFloat("instancing", &_stressSettings.instancingRatio, 0.0f, 1.0f);
+    ImGui::SliderInt("textures", &_stressSettings.textureCount, 0, 64);
+    ImGui::Checkbox("obj assets", &_stressSettings.useAssets);
+    ImGui::SliderInt("point lights", &_stressSettings.pointLightCount, 0, StressSceneGenerator::maxLightsPerKind);
+    ImGui::SliderInt("spot lights", &_stressSettings.spotLightCount, 0, StressSceneGenerator::maxLightsPerKind);
+
+    if (ImGui::Button("generate")) {
+        _selectedKind = ObjectKind::None;
+        generateStressScene(_stressSettings);
+        _stressReport.print();
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("clear")) {
+        _selectedKind = ObjectKind::None;
+        clearStressScene();
+    }
+
+    if (!_stressModels.empty()) {
+        const StressSceneReport& report = _stressReport;
+        ImGui::Text(
+            "%zu objects, %zu meshes, %zu triangles", report.objectCount, report.uniqueMeshCount,
+            report.triangleCount);
+        ImGui::Text(
+            "placement %.1f ms, pool %.1f ms, textures %.1f ms", report.placementMs, report.poolMs,
+            report.texturesMs);
+        ImGui::Text(
+            "models %.1f ms, insert %.1f ms, total %.1f ms", report.modelsMs, report.insertMs,
+            report.getTotalMs());
+    }
+}
+
+void Editor::renderObjectTree(Object* object, int& itemCount) {
+    ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_DefaultOpen
+                               | ImGuiTreeNodeFlags_SpanAvailWidth;
+    if (object->getChildren().empty()) {
+        flags |= ImGuiTreeNodeFlags_Leaf;
+    }
+    if (getSelectedObject() == object) {
+        flags |= ImGuiTreeNodeFlags_Selected;
+    }
+
+    const char* label = frameFormat("%s##%d", object->name.c_str(), itemCount++);
+    const bool open = ImGui::TreeNodeEx(label, flags);
+    if (ImGui::IsItemClicked() && !ImGui::IsItemToggledOpen()) {
+        select(object);
+    }
+
+    if (open) {
+        for (Object* child : object->getChildren()) {
+            renderObjectTree(child, itemCount);
+        }
+        ImGui::TreePop();
+    }
+}
+
+void Editor::renderParentSelector() {
+    Object* selectedObject = getSelectedObject();
+    Object* parent = selectedObject->getParent();
+    if (!ImGui::BeginCombo("Parent", parent != nullptr ? parent->name.c_str() : "None")) {
+        return;
+    }
+
+    if (ImGui::Selectable("None", parent == nullptr)) {
+        selectedObject->setParent(nullptr);
+    }
+
+    // an object cannot become a child of itself or of one of its descendants
+    int itemCount = 0;
+    const auto addCandidate = [&](Object* candidate) {
+        if (candidate == selectedObject || selectedObject->isAncestorOf(candidate)) {
+            return;
+        }
+
+        const char* label = frameFormat("%s##%d", candidate->name.c_str(), itemCount++);
+        if (ImGui::Selectable(label, candidate == parent)) {
+            selectedObject->setParent(candidate);
+        }
+    };
+
+    for (auto& model : _models) {
+        addCandidate(&model);
+    }
+    for (auto& light : _directionalLights) {
+        addCandidate(&light);
+    }
+    for (auto& light : _pointLights) {
+        addCandidate(&light);
+    }
+    for (auto& light : _spotLights) {
+        addCandidate(&light);
+    }
+
+    ImGui::EndCombo();
+}
+
 void Editor::renderPopupModal() {
     if (ImGui::BeginPopupModal("Add Model", nullptr, ImGuiWindowFlags_AlwaysAutoResize)) {
         try {
@@ -707,13 +1676,13 @@ void Editor::renderPopupModal() {
             if (strlen(objectNameBuffer) > 0) {
                 switch (lightType) {
                 case Directional:
-                    _directionalLights.push_back(new DirectionalLight(objectNameBuffer));
+                    addObject(_directionalLights, DirectionalLight(objectNameBuffer));
                     break;
                 case Point:
-                    _pointLights.push_back(new PointLight(objectNameBuffer));
+                    addObject(_pointLights, PointLight(objectNameBuffer));
                     break;
                 case Spot:
-                    _spotLights.push_back(new SpotLight(objectNameBuffer));
+                    addObject(_spotLights, SpotLight(objectNameBuffer));
                     break;
                 }
             }
@@ -730,24 +1699,7 @@ void Editor::renderPopupModal() {
     } else if (ImGui::BeginPopupModal("Delete Object", nullptr, ImGuiWindowFlags_AlwaysAutoResize)) {
         // ȷϰť
         if (ImGui::Button("OK", ImVec2(220, 0))) {
-            auto it0 = std::remove(_models.begin(), _models.end(), dynamic_cast<Model*>(selectedObject));
-            if (it0 != _models.end()) {
-                _models.erase(it0, _models.end());
-            }
-            auto it1 = std::remove(_directionalLights.begin(), _directionalLights.end(), dynamic_cast<DirectionalLight*>(selectedObject));
-            if (it1 != _directionalLights.end()) {
-                _directionalLights.erase(it1, _directionalLights.end());
-            }
-            auto it2 = std::remove(_pointLights.begin(), _pointLights.end(), dynamic_cast<PointLight*>(selectedObject));
-            if (it2 != _pointLights.end()) {
-                _pointLights.erase(it2, _pointLights.end());
-            }
-            auto it3 = std::remove(_spotLights.begin(), _spotLights.end(), dynamic_cast<SpotLight*>(selectedObject));
-            if (it3 != _spotLights.end()) {
-                _spotLights.erase(it3, _spotLights.end());
-            }
-            delete selectedObject;
-            selectedObject = nullptr;
+            deleteSelectedObject();
             ImGui::CloseCurrentPopup();
         }
         ImGui::SameLine();
@@ -786,27 +1738,44 @@ void Editor::renderAddModelPanel() {
     ImGui::RadioButton("Primitive Shape", (int*)&option, PrimitiveShape);
 
     static std::string selectedModel = ""; // 浱ǰѡеԶģ
-    static std::vector<std::string> modelFiles = getModelFiles(); // ȡģļб
+    static char modelFilter[64] = "";
 
     switch (option) {
     case OpenFile:
         // ģѡ˵
         ImGui::Text("Select Model:");
+        ImGui::InputTextWithHint("##ModelFilter", "filter", modelFilter, sizeof(modelFilter));
         if (ImGui::BeginCombo("##ModelSelector", selectedModel.c_str())) {
-            for (const auto& model : modelFiles) {
-                bool isSelected = (selectedModel == model);
-                if (ImGui::Selectable(model.c_str(), isSelected)) {
-                    selectedModel = model;
+            const auto modelFiles = AssetIndex::get().getFiles(AssetType::Model);
+            FrameVector<const std::string*> filtered;
+            for (const std::string& model : *modelFiles) {
+                if (AssetIndex::matches(model, modelFilter)) {
+                    filtered.push_back(&model);
                 }
-                if (isSelected) {
-                    ImGui::SetItemDefaultFocus();
+            }
+
+            ImGuiListClipper clipper;
+            clipper.Begin(static_cast<int>(filtered.size()));
+            while (clipper.Step()) {
+                for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i) {
+                    const std::string& model = *filtered[i];
+                    bool isSelected = (selectedModel == model);
+                    if (ImGui::Selectable(model.c_str(), isSelected)) {
+                        selectedModel = model;
+                    }
+                    if (isSelected) {
+                        ImGui::SetItemDefaultFocus();
+                    }
                 }
             }
+            if (!AssetIndex::get().isReady()) {
+                ImGui::TextDisabled("scanning assets...");
+            }
             ImGui::EndCombo();
         }
         if (ImGui::Button("OK", ImVec2(220, 0))) {
             if (strlen(objectNameBuffer) > 0 && !selectedModel.empty()) {
-                _models.push_back(new Model(objectNameBuffer, getAssetFullPath("obj/" + selectedModel)));
+                addObject(_models, Model(objectNameBuffer, getAssetFullPath(selectedModel)));
             }
             ImGui::CloseCurrentPopup();
         }
@@ -840,7 +1809,7 @@ void Editor::renderAddModelPanel() {
 
             if (ImGui::Button("OK", ImVec2(220, 0))) {
                 if (strlen(objectNameBuffer) > 0) {
-                    _models.push_back(PrimitiveFactory::createPlane(objectNameBuffer, width, height, segmentsX, segmentsY));
+                    addObject(_models, PrimitiveFactory::createPlane(objectNameBuffer, width, height, segmentsX, segmentsY));
                 }
                 ImGui::CloseCurrentPopup();
             }
@@ -850,7 +1819,7 @@ void Editor::renderAddModelPanel() {
 
             if (ImGui::Button("OK", ImVec2(220, 0))) {
                 if (strlen(objectNameBuffer) > 0) {
-                    _models.push_back(PrimitiveFactory::createCube(objectNameBuffer, size));
+                    addObject(_models, PrimitiveFactory::createCube(objectNameBuffer, size));
                 }
                 ImGui::CloseCurrentPopup();
             }
@@ -863,7 +1832,7 @@ void Editor::renderAddModelPanel() {
 
             if (ImGui::Button("OK", ImVec2(220, 0))) {
                 if (strlen(objectNameBuffer) > 0) {
-                    _models.push_back(PrimitiveFactory::createSphere(objectNameBuffer, radius, sectors, stacks));
+                    addObject(_models, PrimitiveFactory::createSphere(objectNameBuffer, radius, sectors, stacks));
                 }
                 ImGui::CloseCurrentPopup();
             }
@@ -877,7 +1846,7 @@ void Editor::renderAddModelPanel() {
 
             if (ImGui::Button("OK", ImVec2(220, 0))) {
                 if (strlen(objectNameBuffer) > 0) {
-                    _models.push_back(PrimitiveFactory::createCylinder(objectNameBuffer, radius, height, radialSegments, heightSegments));
+                    addObject(_models, PrimitiveFactory::createCylinder(objectNameBuffer, radius, height, radialSegments, heightSegments));
                 }
                 ImGui::CloseCurrentPopup();
             }
@@ -890,7 +1859,7 @@ void Editor::renderAddModelPanel() {
 
             if (ImGui::Button("OK", ImVec2(220, 0))) {
                 if (strlen(objectNameBuffer) > 0) {
-                    _models.push_back(PrimitiveFactory::createCone(objectNameBuffer, radius, height, radialSegments));
+                    addObject(_models, PrimitiveFactory::createCone(objectNameBuffer, radius, height, radialSegments));
                 }
                 ImGui::CloseCurrentPopup();
             }
@@ -904,7 +1873,7 @@ void Editor::renderAddModelPanel() {
 
             if (ImGui::Button("OK", ImVec2(220, 0))) {
                 if (strlen(objectNameBuffer) > 0) {
-                    _models.push_back(PrimitiveFactory::createPrism(objectNameBuffer, radius, height, sides, heightSegments));
+                    addObject(_models, PrimitiveFactory::createPrism(objectNameBuffer, radius, height, sides, heightSegments));
                 }
                 ImGui::CloseCurrentPopup();
             }
@@ -919,7 +1888,7 @@ void Editor::renderAddModelPanel() {
 
             if (ImGui::Button("OK", ImVec2(220, 0))) {
                 if (strlen(objectNameBuffer) > 0) {
-                    _models.push_back(PrimitiveFactory::createFrustum(objectNameBuffer, bottomRadius, topRadius, height, sides, heightSegments));
+                    addObject(_models, PrimitiveFactory::createFrustum(objectNameBuffer, bottomRadius, topRadius, height, sides, heightSegments));
                 }
                 ImGui::CloseCurrentPopup();
             }
@@ -933,7 +1902,150 @@ void Editor::renderAddModelPanel() {
     }
 }
 
+void Editor::benchmarkParallelFor() {
+    // the culling work of a frame, repeated so that one measurement is long enough to time
+    constexpr int passes = 64;
+
+    const auto frustum = _camera->getFrustum();
+    const size_t modelCount = _models.size();
+    const int maxThreads = JobSystem::get().getWorkerCount() + 1;
+
+    std::cout << "parallel for over " << modelCount << " models, " << passes << " passes\n";
+
+    double singleThreadTime = 0.0;
+    for (int threads = 1;; threads = std::min(threads * 2, maxThreads)) {
+        // one chunk per thread
+        const size_t grainSize = std::max<size_t>((modelCount + threads - 1) / threads, 1);
+        std::atomic<size_t> visibleCount{0};
+
+        const auto start = std::chrono::high_resolution_clock::now();
+        for (int pass = 0; pass < passes; ++pass) {
+            JobSystem::get().parallelFor(modelCount, grainSize, [&](size_t begin, size_t end) {
+                size_t visible = 0;
+                for (size_t i = begin; i < end; ++i) {
+                    visible += frustum.intersect(_models[i].getBoundingBox(), _models[i].getWorldMatrix());
+                }
+                visibleCount += visible;
+            });
+        }
+        const double time =
+            std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+        if (threads == 1) {
+            singleThreadTime = time;
+        }
+        std::cout << "+ " << threads << " threads: " << time << " ms, speedup "
+                  << singleThreadTime / time << '\n';
+
+        if (threads == maxThreads) {
+            break;
+        }
+    }
+    std::cout << std::endl;
+}
+
+Object* Editor::getSelectedObject() {
+    switch (_selectedKind) {
+    case ObjectKind::Model:
+        return _models.get(_selectedHandle);
+    case ObjectKind::AmbientLight:
+        return _ambientLight.get();
+    case ObjectKind::DirectionalLight:
+        return _directionalLights.get(_selectedHandle);
+    case ObjectKind::PointLight:
+        return _pointLights.get(_selectedHandle);
+    case ObjectKind::SpotLight:
+        return _spotLights.get(_selectedHandle);
+    default:
+        return nullptr;
+    }
+}
+
+void Editor::select(Object* object) {
+    _selectedHandle = object->handle;
+    if (dynamic_cast<Model*>(object) != nullptr) {
+        _selectedKind = ObjectKind::Model;
+    } else if (dynamic_cast<AmbientLight*>(object) != nullptr) {
+        _selectedKind = ObjectKind::AmbientLight;
+    } else if (dynamic_cast<DirectionalLight*>(object) != nullptr) {
+        _selectedKind = ObjectKind::DirectionalLight;
+    } else if (dynamic_cast<PointLight*>(object) != nullptr) {
+        _selectedKind = ObjectKind::PointLight;
+    } else if (dynamic_cast<SpotLight*>(object) != nullptr) {
+        _selectedKind = ObjectKind::SpotLight;
+    } else {
+        _selectedKind = ObjectKind::None;
+    }
+}
+
+void Editor::deleteSelectedObject() {
+    switch (_selectedKind) {
+    case ObjectKind::Model:
+        _models.erase(_selectedHandle);
+        break;
+    case ObjectKind::DirectionalLight:
+        _directionalLights.erase(_selectedHandle);
+        break;
+    case ObjectKind::PointLight:
+        _pointLights.erase(_selectedHandle);
+        break;
+    case ObjectKind::SpotLight:
+        _spotLights.erase(_selectedHandle);
+        break;
+    default:
+        break;
+    }
+
+    _selectedKind = ObjectKind::None;
+    _selectedHandle = SlotHandle();
+}
+
+void Editor::generateStressScene(const StressSceneSettings& settings) {
+    clearStressScene();
+
+    StressSceneSettings capped = settings;
+    const int maxLights = StressSceneGenerator::maxLightsPerKind;
+    capped.pointLightCount = std::min(settings.pointLightCount, maxLights - static_cast<int>(_pointLights.size()));
+    capped.spotLightCount = std::min(settings.spotLightCount, maxLights - static_cast<int>(_spotLights.size()));
+    if (capped.pointLightCount < settings.pointLightCount || capped.spotLightCount < settings.spotLightCount) {
+        std::cerr << "stress scene lights capped at " << maxLights << " of each kind" << std::endl;
+    }
+
+    StressScene scene = StressSceneGenerator::generate(capped, _assetRootDir);
+
+    const auto start = std::chrono::steady_clock::now();
+    _stressModels.reserve(scene.models.size());
+    for (Model& model : scene.models) {
+        _stressModels.push_back(addObject(_models, std::move(model)));
+    }
+    for (PointLight& light : scene.pointLights) {
+        _stressPointLights.push_back(addObject(_pointLights, std::move(light)));
+    }
+    for (SpotLight& light : scene.spotLights) {
+        _stressSpotLights.push_back(addObject(_spotLights, std::move(light)));
+    }
+    scene.report.insertMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    _stressReport = scene.report;
+}
+
+void Editor::clearStressScene() {
+    for (const SlotHandle handle : _stressModels) {
+        _models.erase(handle);
+    }
+    for (const SlotHandle handle : _stressPointLights) {
+        _pointLights.erase(handle);
+    }
+    for (const SlotHandle handle : _stressSpotLights) {
+        _spotLights.erase(handle);
+    }
+    _stressModels.clear();
+    _stressPointLights.clear();
+    _stressSpotLights.clear();
+}
+
 void Editor::extractBrightColor(const Texture2D& sceneMap) {
+    ProfileScope scope("bright extract");
     _brightColorFBO->bind();
     _brightColorFBO->attachTexture2D(*_brightColorMap[0], GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D);
     _brightColorShader->use();
@@ -944,6 +2056,7 @@ void Editor::extractBrightColor(const Texture2D& sceneMap) {
 }
 
 void Editor::blurBrightColor() {
+    ProfileScope scope("blur");
     _blurFBO->bind();
     _blurFBO->drawBuffer(GL_COLOR_ATTACHMENT0);
     _blurShader->use();
@@ -966,7 +2079,8 @@ void Editor::blurBrightColor() {
 }
 
 void Editor::combineSceneMapAndBloomBlur(const Texture2D& sceneMap) {
-    glDisable(GL_DEPTH_TEST);
+    ProfileScope scope("blend");
+    GLStateCache::get().setDepthTest(false);
     _blendShader->use();
 
     _blendShader->setUniformInt("scene", 0);
@@ -979,43 +2093,42 @@ void Editor::combineSceneMapAndBloomBlur(const Texture2D& sceneMap) {
 }
 
 void Editor::zoomToFit() {
-    if (selectedObject == nullptr) {
-        return;
-    }
-    Model* model = dynamic_cast<Model*>(selectedObject);
+    const Model* model = _selectedKind == ObjectKind::Model ? _models.get(_selectedHandle) : nullptr;
     if (model == nullptr) {
         return;
     }
 
-    BoundingBox& bbox = model->getBoundingBox();
+    const BoundingBox bbox = model->getTransformedBoundingBox();
 
     glm::vec3 center = (bbox.max + bbox.min) * 0.5f;
-    float radius = glm::distance(bbox.max, bbox.min) * 0.5f;
-
-    // 룬ʹĿʺĻ
-    float marginFactor = 1.1f;
-    float distance = radius / std::tan(_camera->fovy / 2.0f) * marginFactor;
+    float distance = getFramingDistance(bbox);
 
     // λãʹĿ
     _camera->transform.position = center - distance * _camera->transform.getFront();
     _camera->transform.lookAt(center);
 }
 
-void Editor::captureScreen(const std::string& filepath) const {
-    std::vector<unsigned char> pixels(_windowWidth * _windowHeight * 4);
+float Editor::getFramingDistance(const BoundingBox& bbox) const {
+    float radius = glm::distance(bbox.max, bbox.min) * 0.5f;
 
-    // ȡ֡е
-    glReadPixels(0, 0, _windowWidth, _windowHeight, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    // 룬ʹĿʺĻ
+    float marginFactor = 1.1f;
+    return radius / std::tan(_camera->fovy / 2.0f) * marginFactor;
+}
 
-    std::vector<unsigned char> flippedPixels(_windowWidth * _windowHeight * 4);
-    for (int y = 0; y < _windowHeight; ++y) {
-        std::copy(
-            pixels.begin() + y * _windowWidth * 4,
-            pixels.begin() + (y + 1) * _windowWidth * 4,
-            flippedPixels.begin() + (_windowHeight - 1 - y) * _windowWidth * 4
-        );
-    }
+void Editor::startTurntable(const BoundingBox& bbox, const std::string& outputDir, int frameCount, bool qoi) {
+    // one turn over the whole capture, seen slightly from above
+    constexpr float frameRate = 30.0f;
+    const glm::vec3 center = (bbox.max + bbox.min) * 0.5f;
+    const float distance = getFramingDistance(bbox);
+    _capture.start(
+        outputDir, qoi ? "qoi" : "png", frameCount, frameRate,
+        CaptureRecorder::makeTurntable(center, distance, distance * 0.25f, frameCount / frameRate));
+}
 
-    // д PNG ļ
-    stbi_write_png(filepath.c_str(), _windowWidth, _windowHeight, 4, flippedPixels.data(), _windowWidth * 4);
+void Editor::captureScreen(const std::string& filepath) const {
+    // read back and written over the next frames, the render thread does not wait
+    ReadbackService::get().readFramebuffer(
+        GLStateCache::get().getDefaultFramebuffer(), ReadbackFormat::Color, _windowWidth,
+        _windowHeight, filepath);
 }
\ No newline at end of file
@@ -1,9 +1,24 @@
 #pragma once
 
 #include "base/application.h"
+#include "benchmark.h"
+#include "hiz_check.h"
+#include "stress_scene.h"
 #include "base/camera.h"
+#include "base/capture_recorder.h"
+#include "base/command_buffer.h"
+#include "base/draw_list.h"
+#include "base/geometry_arena.h"
+#include "base/gpu_culler.h"
+#include "base/occlusion_rasterizer.h"
+#include "base/instance_data.h"
+#include "base/job_system.h"
+#include "base/object_data_buffer.h"
+#include "base/stream_buffer.h"
 #include "base/light.h"
 #include "base/object.h"
+#include "base/scene_graph.h"
+#include "base/slot_map.h"
 #include "base/glsl_program.h"
 #include "base/fullscreen_quad.h"
 #include "base/framebuffer.h"
@@ -25,22 +40,111 @@ private:
 
 	std::unique_ptr<SkyBox> _skybox;
 
-	std::vector<Model*> _models;
+	SceneGraph _sceneGraph;
+
+	// objects are stored by value and packed, the scene graph must outlive them
+	SlotMap<Model> _models;
 
 	std::unique_ptr<AmbientLight> _ambientLight;
-	std::vector<DirectionalLight*> _directionalLights;
-	std::vector<PointLight*> _pointLights;
-	std::vector<SpotLight*> _spotLights;
+	SlotMap<DirectionalLight> _directionalLights;
+	SlotMap<PointLight> _pointLights;
+	SlotMap<SpotLight> _spotLights;
+
+	// storage the selected handle refers to
+	enum class ObjectKind {
+		None,
+		Model,
+		AmbientLight,
+		DirectionalLight,
+		PointLight,
+		SpotLight
+	};
 
-	Object* selectedObject = nullptr;
+	ObjectKind _selectedKind = ObjectKind::None;
+	SlotHandle _selectedHandle;
 
-	std::unique_ptr<Texture2D> _defaultTexture;
+	std::shared_ptr<Texture2D> _defaultTexture;
 
 	std::unique_ptr<GLSLProgram> _drawScreenShader;
 	std::unique_ptr<FullscreenQuad> _screenQuad;
 
 	std::unique_ptr<Framebuffer> _gBufferFBO;
 	std::unique_ptr<GLSLProgram> _gBufferShader;
+
+	struct GeometryDraw {
+		const Model* model;
+		glm::mat4 modelMatrix;
+		uint32_t object;
+	};
+
+	struct GeometryPassStats {
+		uint32_t updatedObjects = 0;
+		uint32_t visibleObjects = 0;
+		uint32_t drawCalls = 0;
+		uint32_t textureChanges = 0;
+		uint32_t occluders = 0;
+		uint32_t occludedObjects = 0;
+		uint64_t submittedTriangles = 0;
+		uint64_t culledTriangles = 0;
+	};
+
+	// indirect commands sharing one texture, submitted with a single multi draw
+	struct GeometryBatch {
+		std::shared_ptr<Texture2D> texture;
+		uint32_t firstCommand;
+		uint32_t commandCount;
+	};
+
+	// what the gl side of a frame needs from the scene. it is prepared by a job in pipelined
+	// mode and submitted a frame later, so past preparation it must not point into the scene
+	struct FramePacket {
+		glm::mat4 view;
+		glm::mat4 projection;
+		glm::vec3 eye;
+		Frustum frustum;
+		bool gpuCulling;
+
+		// only valid during preparation
+		std::vector<std::vector<GeometryDraw>> cullChunks;
+		std::vector<GeometryDraw> draws;
+		DrawList drawList;
+		// occlusion culling scratch, prepared on a worker so not in frame memory
+		std::vector<std::pair<float, size_t>> occluderCandidates;
+		std::vector<bool> isOccluder;
+
+		std::vector<InstanceData> instances;
+		std::vector<DrawElementsIndirectCommand> commands;
+		// geometry of each command, the ranges are looked up at submission
+		std::vector<std::shared_ptr<const Mesh>> commandMeshes;
+		std::vector<GeometryBatch> batches;
+		std::vector<CullObject> cullObjects;
+		GeometryPassStats stats;
+	};
+
+	FramePacket _framePackets[2];
+	uint32_t _currentFramePacket = 0;
+	bool _framePacketReady = false;
+	JobCounter _prepareJob;
+
+	std::unique_ptr<ObjectDataBuffer> _objectData;
+	std::unique_ptr<StreamBuffer> _instanceBuffer;
+	std::unique_ptr<StreamBuffer> _indirectBuffer;
+	GeometryPassStats _geometryPassStats;
+
+	// recording makes no gl calls, so the uniform locations are looked up once
+	GLint _gBufferProjectionLocation = -1;
+	GLint _gBufferViewLocation = -1;
+	GLint _gBufferObjectDataLocation = -1;
+
+	// the geometry pass is recorded in command ranges by jobs and replayed in order,
+	// the last buffer holds the skybox
+	std::vector<CommandBuffer> _geometryCommands;
+
+	// null when the context has no compute shaders
+	std::unique_ptr<GPUCuller> _gpuCuller;
+
+	std::unique_ptr<OcclusionRasterizer> _occlusionRasterizer;
+
 	std::unique_ptr<Texture2D> _gPosition;
 	std::unique_ptr<Texture2D> _gNormal;
 	std::unique_ptr<Texture2D> _gAlbedo;
@@ -76,6 +180,42 @@ private:
 
 	bool _enableBloom = false;
 	bool _enableSSAO = false;
+	bool _enableGPUCulling = true;
+	bool _enableHiZCulling = true;
+	bool _enableOcclusionCulling = false;
+	bool _enablePipelining = false;
+
+	// headless batch, one asset is loaded, framed and rendered per frame
+	std::vector<std::string> _batchAssets;
+	std::string _batchOutputDir;
+	size_t _batchIndex = 0;
+	SlotHandle _batchModel;
+	std::chrono::time_point<std::chrono::high_resolution_clock> _batchStartTime;
+	int _batchTurntableFrames = 0;
+
+	// pass whose history the profiler panel plots
+	int _profilerPlotPass = 0;
+	int _traceFrameCount = 300;
+
+	// a benchmark run replaces the editor loop until it is done
+	std::unique_ptr<Benchmark> _benchmark;
+	CameraAnimation _benchmarkPath;
+
+	// the generated objects, replaced as a whole by the next generation
+	StressSceneSettings _stressSettings;
+	StressSceneReport _stressReport;
+	std::vector<SlotHandle> _stressModels;
+	std::vector<SlotHandle> _stressPointLights;
+	std::vector<SlotHandle> _stressSpotLights;
+	// a stress run replaces the editor loop until every object count is measured
+	std::unique_ptr<StressRun> _stressRun;
+
+	// so does the hi-z check until every view is compared
+	std::unique_ptr<HiZCheck> _hiZCheck;
+
+	CaptureRecorder _capture;
+	int _captureFrameCount = 120;
+	bool _captureQoi = false;
 
 	void initGeometryPassResources();
 	void initSSAOPassResources();
@@ -83,18 +223,59 @@ private:
 	void initShaders();
 
 	void renderScene();
+	void renderBatchFrame();
+	void renderBenchmarkFrame();
+	void renderStressFrame();
+	void renderHiZCheckFrame();
+	// orbit the camera around the box, frames are written to outputDir
+	void startTurntable(const BoundingBox& bbox, const std::string& outputDir, int frameCount, bool qoi);
+	void prepareFrame(FramePacket& packet);
+	void cullOccludedDraws(FramePacket& packet);
+	void submitGeometryPass(FramePacket& packet);
+	void recordGeometryCommands(
+		const FramePacket& packet, size_t begin, size_t end, GLuint instanceSource,
+		CommandBuffer& commands) const;
+	bool isGPUCullingActive() const;
 
 	void renderUI();
 	void renderScenePanel();
 	void renderInspectorPanel();
+	void renderProfilerPanel();
+	void renderStatisticsPanel();
+
+	void renderMemoryPanel();
 	void renderPopupModal();
 	void renderAddModelPanel();
+	void renderStressScenePanel();
+	void renderObjectTree(Object* object, int& itemCount);
+	void renderParentSelector();
+
+	template <typename T>
+	SlotHandle addObject(SlotMap<T>& storage, T&& object) {
+		object.attachToSceneGraph(_sceneGraph);
+		const SlotHandle handle = storage.insert(std::move(object));
+		storage.get(handle)->handle = handle;
+		return handle;
+	}
+
+	// nullptr when nothing is selected or the selection was deleted
+	Object* getSelectedObject();
+	void select(Object* object);
+	void deleteSelectedObject();
+
+	// lights are capped so that the editor's own and the generated ones fit the lighting shader
+	void generateStressScene(const StressSceneSettings& settings);
+	void clearStressScene();
+
+	// time parallelFor over _models with a growing number of threads, printed to stdout
+	void benchmarkParallelFor();
 
 	void extractBrightColor(const Texture2D& sceneMap);
 	void blurBrightColor();
 	void combineSceneMapAndBloomBlur(const Texture2D& sceneMap);
 
-	std::vector<std::string> getModelFiles() const;
 	void zoomToFit();
+	// camera distance at which the box fills the view
+	float getFramingDistance(const BoundingBox& bbox) const;
 	void captureScreen(const std::string& filepath) const;
 };
\ No newline at end of file
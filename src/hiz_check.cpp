@@ -0,0 +1,103 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#include "hiz_check.h"
+#include "primitive_factory.h"
+
+// the wall covers x < 0 and y < wallCornerY in the plane z = 0, the camera looks down -z from
+// cameraDistance in front of it and the boxes stand about as far behind it
+static constexpr float wallCornerY = 20.0f;
+static constexpr float cameraDistance = 10.0f;
+static constexpr float boxDepth = -10.0f;
+
+HiZCheck::HiZCheck(int viewCount) : _viewCount(viewCount) {}
+
+HiZCheck::Step HiZCheck::beginFrame() {
+    if (++_step == 3) {
+        _step = 0;
+        ++_view;
+    }
+
+    if (_view == _viewCount) {
+        return Step::Done;
+    }
+
+    return static_cast<Step>(_step);
+}
+
+std::vector<Model> HiZCheck::createScene() {
+    std::vector<Model> models;
+
+    Model wall = PrimitiveFactory::createCube("Hi-Z Wall", 0.5f);
+    wall.transform.position = glm::vec3(-50.0f, wallCornerY - 50.0f, 0.0f);
+    wall.transform.scale = glm::vec3(100.0f, 100.0f, 0.5f);
+    models.push_back(std::move(wall));
+
+    // from a few pixels to over a hundred, so every level of the pyramid is sampled
+    const float sizes[] = {0.35f, 0.8f, 1.7f, 3.4f};
+    constexpr int gridSize = 16;
+    for (int y = 0; y < gridSize; ++y) {
+        for (int x = 0; x < gridSize; ++x) {
+            const int index = y * gridSize + x;
+            Model box = PrimitiveFactory::createCube("Hi-Z Box " + std::to_string(index), 0.5f);
+            // no two boxes share a depth, the order of the culled draws cannot show in the frame
+            box.transform.position =
+                glm::vec3(-6.0f + 2.0f * x, 2.0f + 2.0f * y, boxDepth - 0.013f * index);
+            box.transform.scale = glm::vec3(sizes[(x + 2 * y) % 4]);
+            models.push_back(std::move(box));
+        }
+    }
+
+    return models;
+}
+
+void HiZCheck::placeCamera(PerspectiveCamera& camera) const {
+    // where the wall corner lands in normalized device coordinates
+    const float t = (_view + 0.5f) / _viewCount;
+    const float cornerX = 0.15f + 0.8f * t;
+    const float cornerY = 0.15f + 0.8f * std::fmod(t * 5.0f + 0.37f, 1.0f);
+
+    const float halfHeight = cameraDistance * std::tan(camera.fovy * 0.5f);
+    camera.transform.position = glm::vec3(
+        -cornerX * halfHeight * camera.aspect, wallCornerY - cornerY * halfHeight, cameraDistance);
+    camera.transform.rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+}
+
+void HiZCheck::setReference(std::vector<unsigned char> pixels) {
+    _reference = std::move(pixels);
+}
+
+void HiZCheck::compare(const std::vector<unsigned char>& pixels, int width, int height) {
+    size_t differing = 0;
+    int minX = width, minY = height, maxX = -1, maxY = -1;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            const size_t offset = (static_cast<size_t>(y) * width + x) * 4;
+            const auto pixel = pixels.begin() + offset;
+            if (!std::equal(pixel, pixel + 4, _reference.begin() + offset)) {
+                ++differing;
+                minX = std::min(minX, x);
+                minY = std::min(minY, y);
+                maxX = std::max(maxX, x);
+                maxY = std::max(maxY, y);
+            }
+        }
+    }
+
+    if (differing > 0) {
+        ++_failedViews;
+        std::cerr << "hi-z check view " << _view << ": " << differing << " pixels differ in x " << minX
+                  << "-" << maxX << ", y " << minY << "-" << maxY << " from the bottom" << std::endl;
+    }
+}
+
+bool HiZCheck::hasFailed() const {
+    return _failedViews > 0;
+}
+
+void HiZCheck::printSummary() const {
+    std::cout << "hi-z check: " << _viewCount - _failedViews << " of " << _viewCount
+              << " views match the frame rendered without hi-z culling" << std::endl;
+}
\ No newline at end of file
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vector>
+
+#include "base/camera.h"
+#include "base/model.h"
+
+// hi-z culling must never hide what is in sight. views of a fixed scene are rendered once without
+// and once with hi-z culling from the same camera, and every pixel has to match. meant for a
+// window whose size is not a power of two, where the pyramid folds the odd last row and column of
+// a level into its last texels.
+class HiZCheck {
+public:
+    // ctest's SKIP_RETURN_CODE, the context has no compute shaders
+    static constexpr int skippedExitCode = 77;
+
+    enum class Step {
+        // hi-z culling off, the frame is read as the reference
+        Reference,
+        // hi-z culling on, the pyramid built from this frame serves the next one
+        Build,
+        // culled with the pyramid of the same view, the frame is read and compared
+        Compare,
+        Done
+    };
+
+    explicit HiZCheck(int viewCount);
+
+    // the step of the new frame
+    Step beginFrame();
+
+    // a wall with a corner in every view and boxes of several sizes behind it, partly hidden
+    static std::vector<Model> createScene();
+
+    // the corner of the wall sweeps the upper right part of the view. a level folded from an odd
+    // size covers less than the window there, so its texels are not at uv * size
+    void placeCamera(PerspectiveCamera& camera) const;
+
+    // rgba8 rows of the frame
+    void setReference(std::vector<unsigned char> pixels);
+
+    void compare(const std::vector<unsigned char>& pixels, int width, int height);
+
+    bool hasFailed() const;
+
+    void printSummary() const;
+
+private:
+    int _viewCount;
+    int _view = 0;
+    // -1 before the first frame
+    int _step = -1;
+    std::vector<unsigned char> _reference;
+    int _failedViews = 0;
+};
\ No newline at end of file
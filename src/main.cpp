@@ -1,8 +1,33 @@
+#include <cstdio>
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
 
 #include "editor.h"
 
+static void printUsage() {
+    std::cout << "usage: scene_modeling [--headless] [--size WIDTHxHEIGHT] [--output DIR]\n"
+              << "                      [--turntable FRAMES] [--format png|qoi]\n"
+              << "                      [--trace FILE] [--trace-frames N] [--frame-stats FILE]\n"
+              << "                      [--memory-report FILE]\n"
+              << "                      [--benchmark SCRIPT [--report FILE]] [--list FILE] [ASSET.obj ...]\n"
+              << "                      [--stress COUNTS [--stress-seed SEED] [--stress-lights N]]\n"
+              << "                      [--check-hiz]\n"
+              << "       scene_modeling --compare BASELINE.json CURRENT.json [TOLERANCE_PERCENT]\n"
+              << "  --headless   render every asset offscreen to DIR/<name>.png and exit\n"
+              << "  --turntable  render FRAMES frames around every asset to DIR/<name>/ instead\n"
+              << "  --frame-stats  write the frame time summary of the run to FILE as json on exit\n"
+              << "  --memory-report  write the gpu and cpu memory by owner at the end of the run to FILE\n"
+              << "  --trace      record the first N frames (300 by default) as a chrome trace to FILE\n"
+              << "  --benchmark  run the configurations of SCRIPT and write a json report to FILE\n"
+              << "  --stress     generate and measure a stress scene of each of the comma separated\n"
+              << "               object counts, e.g. 1000,10000,100000, with N lights (8 by default)\n"
+              << "  --check-hiz  render views with and without hi-z culling, fails unless they match\n"
+              << "  --compare    list the metrics slower than the baseline, fails if one is beyond\n"
+              << "               the tolerance (5% by default)\n"
+              << "  --list       read more assets from FILE, one path per line" << std::endl;
+}
+
 Options getOptions(int argc, char* argv[]) {
     Options options;
     options.windowTitle = "Editor";
@@ -14,16 +39,108 @@ Options getOptions(int argc, char* argv[]) {
     options.glVersion = {3, 3};
     options.backgroundColor = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
     options.assetRootDir = "../media/";
+    bool sizeGiven = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--headless") {
+            options.headless = true;
+        } else if (arg == "--size" && hasValue) {
+            if (std::sscanf(argv[++i], "%dx%d", &options.windowWidth, &options.windowHeight) != 2
+                || options.windowWidth <= 0 || options.windowHeight <= 0) {
+                throw std::runtime_error(std::string("invalid size ") + argv[i]);
+            }
+            sizeGiven = true;
+        } else if (arg == "--output" && hasValue) {
+            options.outputDir = argv[++i];
+        } else if (arg == "--turntable" && hasValue) {
+            options.turntableFrames = std::atoi(argv[++i]);
+        } else if (arg == "--format" && hasValue) {
+            options.imageFormat = argv[++i];
+            if (options.imageFormat != "png" && options.imageFormat != "qoi") {
+                throw std::runtime_error("unsupported image format " + options.imageFormat);
+            }
+        } else if (arg == "--trace" && hasValue) {
+            options.tracePath = argv[++i];
+            if (options.traceFrames == 0) {
+                options.traceFrames = 300;
+            }
+        } else if (arg == "--trace-frames" && hasValue) {
+            options.traceFrames = std::atoi(argv[++i]);
+        } else if (arg == "--frame-stats" && hasValue) {
+            options.frameStatisticsPath = argv[++i];
+        } else if (arg == "--memory-report" && hasValue) {
+            options.memoryReportPath = argv[++i];
+        } else if (arg == "--benchmark" && hasValue) {
+            options.benchmarkScript = argv[++i];
+        } else if (arg == "--report" && hasValue) {
+            options.benchmarkReport = argv[++i];
+        } else if (arg == "--stress" && hasValue) {
+            options.stressObjectCounts = parseStressCounts(argv[++i]);
+        } else if (arg == "--stress-seed" && hasValue) {
+            options.stressSeed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--stress-lights" && hasValue) {
+            options.stressLightCount = std::atoi(argv[++i]);
+        } else if (arg == "--check-hiz") {
+            options.checkHiZ = true;
+        } else if (arg == "--list" && hasValue) {
+            std::ifstream file(argv[++i]);
+            if (!file) {
+                throw std::runtime_error(std::string("open asset list ") + argv[i] + " failure");
+            }
+            std::string line;
+            while (std::getline(file, line)) {
+                if (!line.empty()) {
+                    options.batchAssets.push_back(line);
+                }
+            }
+        } else if (arg == "--help") {
+            printUsage();
+            exit(EXIT_SUCCESS);
+        } else if (arg.rfind("--", 0) == 0) {
+            printUsage();
+            throw std::runtime_error("unknown option " + arg);
+        } else {
+            options.batchAssets.push_back(arg);
+        }
+    }
+
+    if (!options.stressObjectCounts.empty()) {
+        options.vSync = false;
+    }
+
+    if (!options.benchmarkScript.empty()) {
+        // the script is read again by the editor, here only its resolution matters
+        const BenchmarkScript script = BenchmarkScript::load(options.benchmarkScript);
+        if (!sizeGiven && script.width > 0) {
+            options.windowWidth = script.width;
+            options.windowHeight = script.height;
+        }
+        // frames must not wait for the display
+        options.vSync = false;
+    }
+
+    if (options.headless) {
+        // nothing is presented, so nothing waits for the display
+        options.vSync = false;
+        options.msaa = false;
+    }
 
     return options;
 }
 
 int main(int argc, char* argv[]) {
-    Options options = getOptions(argc, argv);
-
     try {
+        // comparing reports needs no window
+        if (argc >= 4 && std::string(argv[1]) == "--compare") {
+            const double tolerance = argc >= 5 ? std::atof(argv[4]) : 5.0;
+            return compareBenchmarkReports(argv[2], argv[3], tolerance) ? EXIT_FAILURE : EXIT_SUCCESS;
+        }
+
+        Options options = getOptions(argc, argv);
         Editor app(options);
-        app.run();
+        return app.run();
     } catch (const std::exception& e) {
         std::cerr << e.what() << std::endl;
         exit(EXIT_FAILURE);
@@ -14,17 +14,31 @@ enum PrimitiveShape {
 
 class PrimitiveFactory {
 public:
-    static Model* createCube(std::string name, float size);
+    static Model createCube(std::string name, float size);
 
-    static Model* createSphere(std::string name, float radius, int sectors, int stacks);
+    static Model createSphere(std::string name, float radius, int sectors, int stacks);
 
-    static Model* createPlane(std::string name, float width, float height, int segmentsX = 1, int segmentsY = 1);
+    static Model createPlane(std::string name, float width, float height, int segmentsX = 1, int segmentsY = 1);
 
-    static Model* createCylinder(std::string name, float radius, float height, int radialSegments, int heightSegments);
+    static Model createCylinder(std::string name, float radius, float height, int radialSegments, int heightSegments);
 
-    static Model* createCone(std::string name, float radius, float height, int radialSegments);
+    static Model createCone(std::string name, float radius, float height, int radialSegments);
 
-    static Model* createPrism(std::string name, float radius, float height, int sides, int heightSegments = 1);
+    static Model createPrism(std::string name, float radius, float height, int sides, int heightSegments = 1);
 
-    static Model* createFrustum(std::string name, float bottomRadius, float topRadius, float height, int sides, int heightSegments = 1);
+    static Model createFrustum(std::string name, float bottomRadius, float topRadius, float height, int sides, int heightSegments = 1);
+
+    static MeshData buildCube(float size);
+
+    static MeshData buildSphere(float radius, int sectors, int stacks);
+
+    static MeshData buildPlane(float width, float height, int segmentsX = 1, int segmentsY = 1);
+
+    static MeshData buildCylinder(float radius, float height, int radialSegments, int heightSegments);
+
+    static MeshData buildCone(float radius, float height, int radialSegments);
+
+    static MeshData buildPrism(float radius, float height, int sides, int heightSegments = 1);
+
+    static MeshData buildFrustum(float bottomRadius, float topRadius, float height, int sides, int heightSegments = 1);
 };
\ No newline at end of file
@@ -9,22 +9,18 @@ layout(location = 5) out float gNs;
 in vec3 position;
 in vec3 normal;
 in vec2 texCoord;
+flat in vec3 ka;
+flat in vec3 kd;
+flat in vec3 ks;
+flat in float ns;
 
-struct Material {
-    vec3 ka;
-    vec3 kd;
-    vec3 ks;
-    float ns; 
-    sampler2D texture;
-};
-
-uniform Material material;
+uniform sampler2D materialTexture;
 
 void main() {
     gPosition = position;
     gNormal = gl_FrontFacing ? normal : -normal;
-    gAlbedo = texture(material.texture, texCoord).rgb * material.kd; // ɫ
-    gKa = material.ka;
-    gKs = material.ks;
-    gNs = material.ns;
+    gAlbedo = texture(materialTexture, texCoord).rgb * kd; // ɫ
+    gKa = ka;
+    gKs = ks;
+    gNs = ns;
 }
\ No newline at end of file
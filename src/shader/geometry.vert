@@ -2,19 +2,39 @@
 layout(location = 0) in vec3 aPosition;
 layout(location = 1) in vec3 aNormal;
 layout(location = 2) in vec2 aTexCoord;
+layout(location = 3) in uint aObjectIndex;
 
 uniform mat4 projection;
 uniform mat4 view;
-uniform mat4 model;
+
+// ObjectData records, 10 texels each
+uniform samplerBuffer objectData;
 
 out vec3 position;
 out vec3 normal;
 out vec2 texCoord;
+flat out vec3 ka;
+flat out vec3 kd;
+flat out vec3 ks;
+flat out float ns;
 
 void main() {
+    int base = int(aObjectIndex) * 10;
+    mat4 model = mat4(
+        texelFetch(objectData, base), texelFetch(objectData, base + 1),
+        texelFetch(objectData, base + 2), texelFetch(objectData, base + 3));
+    mat3 normalMatrix = mat3(
+        texelFetch(objectData, base + 4).xyz, texelFetch(objectData, base + 5).xyz,
+        texelFetch(objectData, base + 6).xyz);
+    vec4 kaNs = texelFetch(objectData, base + 7);
+
     vec4 viewSpacePos = view * model * vec4(aPosition, 1.0f);
     position = viewSpacePos.xyz;
-    normal = normalize(mat3(transpose(inverse(view * model))) * aNormal);
+    normal = normalize(mat3(view) * normalMatrix * aNormal);
     texCoord = aTexCoord;
+    ka = kaNs.xyz;
+    kd = texelFetch(objectData, base + 8).xyz;
+    ks = texelFetch(objectData, base + 9).xyz;
+    ns = kaNs.w;
     gl_Position = projection * viewSpacePos;
 }
\ No newline at end of file
@@ -0,0 +1,336 @@
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+#include "stress_scene.h"
+#include "primitive_factory.h"
+#include "base/profiler.h"
+
+// the engine output is fixed by the standard, the distributions of <random> are not
+static float uniform(std::mt19937& random, float min, float max) {
+    return min + (max - min) * static_cast<float>(random() >> 8) / 16777216.0f;
+}
+
+static uint32_t pick(std::mt19937& random, size_t count) {
+    return static_cast<uint32_t>(random() % count);
+}
+
+static double getElapsedMs(std::chrono::time_point<std::chrono::steady_clock>& start) {
+    const auto now = std::chrono::steady_clock::now();
+    const double elapsed = std::chrono::duration<double, std::milli>(now - start).count();
+    start = now;
+    return elapsed;
+}
+
+double StressSceneReport::getTotalMs() const {
+    return placementMs + poolMs + texturesMs + modelsMs + insertMs;
+}
+
+void StressSceneReport::print() const {
+    std::cout << std::fixed << std::setprecision(1) << "stress scene: " << objectCount << " objects, "
+              << uniqueMeshCount << " meshes, " << triangleCount << " triangles, " << pointLightCount
+              << " point and " << spotLightCount << " spot lights\n  placement " << placementMs
+              << " ms, pool " << poolMs << " ms, textures " << texturesMs << " ms, models " << modelsMs
+              << " ms, insert " << insertMs << " ms, total " << getTotalMs() << " ms" << std::endl;
+}
+
+StressScene StressSceneGenerator::generate(
+    const StressSceneSettings& settings, const std::string& assetRootDir, const std::string& namePrefix) {
+    StressScene scene;
+    StressSceneReport& report = scene.report;
+    std::mt19937 random(settings.seed);
+    auto start = std::chrono::steady_clock::now();
+
+    // the pool: primitives with the defaults of the add model panel, then the assets by name
+    std::vector<std::function<Model(const std::string&)>> pool = {
+        [](const std::string& name) { return PrimitiveFactory::createCube(name, 1.0f); },
+        [](const std::string& name) { return PrimitiveFactory::createSphere(name, 1.0f, 16, 16); },
+        [](const std::string& name) { return PrimitiveFactory::createCylinder(name, 1.0f, 2.0f, 16, 1); },
+        [](const std::string& name) { return PrimitiveFactory::createCone(name, 1.0f, 2.0f, 16); },
+        [](const std::string& name) { return PrimitiveFactory::createPrism(name, 1.0f, 2.0f, 3); },
+        [](const std::string& name) { return PrimitiveFactory::createFrustum(name, 1.0f, 0.5f, 2.0f, 3); }};
+    if (settings.useAssets) {
+        std::vector<std::string> assets;
+        std::error_code error;
+        for (const auto& entry : std::filesystem::directory_iterator(assetRootDir + "obj", error)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".obj") {
+                assets.push_back(entry.path().string());
+            }
+        }
+        std::sort(assets.begin(), assets.end());
+        for (const std::string& asset : assets) {
+            pool.push_back([asset](const std::string& name) { return Model(name, asset); });
+        }
+    }
+
+    // every random number is drawn here, in a fixed order, so the scene only depends on the settings
+    struct Placement {
+        glm::vec3 position;
+        float yaw;
+        float scale;
+        uint32_t mesh;
+        bool shared;
+        int texture;
+        glm::vec3 color;
+    };
+
+    const size_t count = static_cast<size_t>(std::max(settings.objectCount, 0));
+    const float extent = settings.spacing * std::sqrt(static_cast<float>(std::max<size_t>(count, 1)));
+    const float half = 0.5f * extent;
+    const size_t columns = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(count))));
+
+    std::vector<glm::vec3> clusters;
+    if (settings.distribution == StressDistribution::Clusters) {
+        clusters.resize(std::max<size_t>(1, (count + 255) / 256));
+        for (glm::vec3& center : clusters) {
+            center = glm::vec3(uniform(random, -half, half), 0.0f, uniform(random, -half, half));
+        }
+    }
+    // a disc holding 256 objects at the spacing
+    const float clusterRadius = settings.spacing * 9.0f;
+
+    std::vector<Placement> placements(count);
+    for (size_t i = 0; i < count; ++i) {
+        Placement& placement = placements[i];
+        switch (settings.distribution) {
+        case StressDistribution::Grid:
+            placement.position = glm::vec3(
+                (static_cast<float>(i % columns) - 0.5f * columns) * settings.spacing, 0.0f,
+                (static_cast<float>(i / columns) - 0.5f * columns) * settings.spacing);
+            break;
+        case StressDistribution::Uniform:
+            placement.position = glm::vec3(
+                uniform(random, -half, half), uniform(random, 0.0f, 2.0f * settings.spacing),
+                uniform(random, -half, half));
+            break;
+        case StressDistribution::Clusters: {
+            const glm::vec3& center = clusters[pick(random, clusters.size())];
+            const float angle = uniform(random, 0.0f, 6.2831853f);
+            const float radius = clusterRadius * std::sqrt(uniform(random, 0.0f, 1.0f));
+            placement.position = center
+                                 + glm::vec3(
+                                     radius * std::cos(angle), uniform(random, 0.0f, settings.spacing),
+                                     radius * std::sin(angle));
+            break;
+        }
+        }
+
+        placement.yaw = uniform(random, 0.0f, 6.2831853f);
+        placement.scale = uniform(random, 0.5f, 1.5f);
+        placement.mesh = pick(random, pool.size());
+        placement.shared = uniform(random, 0.0f, 1.0f) < settings.instancingRatio;
+        // drawn even without textures, the objects after it must not change with the setting
+        const uint32_t texture = random();
+        placement.texture = settings.textureCount > 0 ? static_cast<int>(texture % settings.textureCount) : -1;
+        placement.color = glm::vec3(uniform(random, 0.4f, 1.0f), uniform(random, 0.4f, 1.0f), uniform(random, 0.4f, 1.0f));
+    }
+
+    const int pointLightCount = std::clamp(settings.pointLightCount, 0, maxLightsPerKind);
+    const int spotLightCount = std::clamp(settings.spotLightCount, 0, maxLightsPerKind);
+    for (int i = 0; i < pointLightCount; ++i) {
+        PointLight light(namePrefix + "Point Light " + std::to_string(i));
+        light.transform.position = glm::vec3(
+            uniform(random, -half, half), uniform(random, 2.0f, 4.0f) * settings.spacing, uniform(random, -half, half));
+        light.color = glm::vec3(uniform(random, 0.5f, 1.0f), uniform(random, 0.5f, 1.0f), uniform(random, 0.5f, 1.0f));
+        scene.pointLights.push_back(std::move(light));
+    }
+    for (int i = 0; i < spotLightCount; ++i) {
+        SpotLight light(namePrefix + "Spot Light " + std::to_string(i));
+        light.transform.position = glm::vec3(
+            uniform(random, -half, half), uniform(random, 3.0f, 6.0f) * settings.spacing, uniform(random, -half, half));
+        // straight down
+        light.transform.rotation = glm::quat(glm::vec3(glm::radians(-90.0f), 0.0f, 0.0f));
+        light.angle = glm::radians(uniform(random, 30.0f, 60.0f));
+        light.color = glm::vec3(uniform(random, 0.5f, 1.0f), uniform(random, 0.5f, 1.0f), uniform(random, 0.5f, 1.0f));
+        scene.spotLights.push_back(std::move(light));
+    }
+
+    // the random numbers of the textures come last, so the layout does not depend on their count
+    struct Checker {
+        glm::u8vec4 colors[2];
+        int cellSize;
+    };
+    std::vector<Checker> checkers(std::max(settings.textureCount, 0));
+    for (Checker& checker : checkers) {
+        for (glm::u8vec4& color : checker.colors) {
+            color = glm::u8vec4(pick(random, 256), pick(random, 256), pick(random, 256), 255);
+        }
+        checker.cellSize = 4 << pick(random, 3);
+    }
+    report.placementMs = getElapsedMs(start);
+
+    // the first model of each pool entry builds or loads its mesh
+    std::vector<Model> prototypes;
+    prototypes.reserve(pool.size());
+    for (const auto& create : pool) {
+        prototypes.push_back(create(namePrefix + "prototype"));
+    }
+    report.poolMs = getElapsedMs(start);
+
+    constexpr int textureSize = 64;
+    std::vector<std::shared_ptr<Texture2D>> textures;
+    std::vector<glm::u8vec4> pixels(textureSize * textureSize);
+    for (size_t i = 0; i < checkers.size(); ++i) {
+        const Checker& checker = checkers[i];
+        for (int y = 0; y < textureSize; ++y) {
+            for (int x = 0; x < textureSize; ++x) {
+                pixels[y * textureSize + x] = checker.colors[(x / checker.cellSize + y / checker.cellSize) % 2];
+            }
+        }
+        textures.push_back(std::make_shared<ImageTexture2D>(
+            pixels.data(), textureSize, textureSize, 4, GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE,
+            "stress:checker" + std::to_string(i)));
+    }
+    report.texturesMs = getElapsedMs(start);
+
+    report.uniqueMeshCount = pool.size();
+    scene.models.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        const Placement& placement = placements[i];
+        const std::string name = namePrefix + std::to_string(i);
+        if (placement.shared) {
+            scene.models.push_back(pool[placement.mesh](name));
+        } else {
+            // a mesh of its own, as an edited or imported object would have
+            const Model& prototype = prototypes[placement.mesh];
+            scene.models.emplace_back(name, prototype.getVertices(), prototype.getIndices());
+            ++report.uniqueMeshCount;
+        }
+
+        Model& model = scene.models.back();
+        model.transform.position = placement.position;
+        model.transform.rotation = glm::quat(glm::vec3(0.0f, placement.yaw, 0.0f));
+        model.transform.scale = glm::vec3(placement.scale);
+        model.material.kd = placement.color;
+        if (placement.texture >= 0) {
+            model.material.texture = textures[placement.texture];
+        }
+        report.triangleCount += model.getFaceCount();
+    }
+    report.modelsMs = getElapsedMs(start);
+
+    report.objectCount = count;
+    report.pointLightCount = scene.pointLights.size();
+    report.spotLightCount = scene.spotLights.size();
+    return scene;
+}
+
+StressRun::StressRun(StressSceneSettings settings, std::vector<int> objectCounts, int warmupFrames, int measuredFrames)
+    : _settings(settings), _objectCounts(std::move(objectCounts)), _warmupFrames(warmupFrames),
+      _measuredFrames(measuredFrames), _frames(measuredFrames) {}
+
+StressRun::Step StressRun::beginFrame() {
+    if (_countIndex == _objectCounts.size()) {
+        return Step::Done;
+    }
+
+    if (_frameIndex < 0) {
+        _settings.objectCount = _objectCounts[_countIndex];
+        _result = Result();
+        _frameIndex = 0;
+        return Step::Generate;
+    }
+
+    const auto now = std::chrono::high_resolution_clock::now();
+    const int warmupEnd = _warmupFrames;
+    const int measureEnd = warmupEnd + _measuredFrames;
+
+    if (_frameIndex > warmupEnd && _frameIndex <= measureEnd) {
+        _frames.push(std::chrono::duration<float, std::milli>(now - _lastFrameTime).count());
+    }
+    _lastFrameTime = now;
+
+    Profiler& profiler = Profiler::get();
+    if (_frameIndex == measureEnd) {
+        _result.frames = _frames.getWindowSummary();
+        for (const Profiler::Pass& pass : profiler.getPasses()) {
+            if (pass.cpuTotalCount == 0) {
+                continue;
+            }
+            if (pass.name == "prepare") {
+                _result.prepareCpuMs = pass.getMeanCpuTime();
+            } else if (pass.name == "geometry") {
+                _result.geometryCpuMs = pass.getMeanCpuTime();
+            }
+        }
+    } else if (_frameIndex == measureEnd + drainFrames) {
+        for (const Profiler::Pass& pass : profiler.getPasses()) {
+            if (pass.gpuTotalCount == 0) {
+                continue;
+            }
+            if (pass.name == "geometry") {
+                _result.geometryGpuMs = pass.getMeanGpuTime();
+            } else if (pass.name == "lighting") {
+                _result.lightingGpuMs = pass.getMeanGpuTime();
+            }
+        }
+
+        std::cout << std::fixed << std::setprecision(2) << "  frames mean " << _result.frames.meanMs
+                  << " ms, p95 " << _result.frames.p95Ms << " ms, p99 " << _result.frames.p99Ms
+                  << " ms\n  passes prepare cpu " << _result.prepareCpuMs << " ms, geometry cpu "
+                  << _result.geometryCpuMs << " ms, geometry gpu " << _result.geometryGpuMs
+                  << " ms, lighting gpu " << _result.lightingGpuMs << " ms" << std::endl;
+
+        _results.push_back(_result);
+        _frameIndex = -1;
+        ++_countIndex;
+        return beginFrame();
+    }
+
+    if (_frameIndex == warmupEnd) {
+        profiler.reset();
+        _frames.reset();
+    }
+    ++_frameIndex;
+
+    return Step::Render;
+}
+
+const StressSceneSettings& StressRun::getSettings() const {
+    return _settings;
+}
+
+void StressRun::setReport(const StressSceneReport& report) {
+    _result.scene = report;
+    report.print();
+}
+
+void StressRun::printSummary() const {
+    std::cout << std::right << std::setw(9) << "objects" << std::setw(10) << "meshes" << std::setw(13)
+              << "generate ms" << std::setw(11) << "insert ms" << std::setw(10) << "frame ms" << std::setw(10)
+              << "p95 ms" << std::setw(12) << "prepare ms" << std::setw(14) << "geometry cpu" << std::setw(14)
+              << "geometry gpu" << std::setw(14) << "lighting gpu" << std::endl;
+    for (const Result& result : _results) {
+        std::cout << std::fixed << std::setprecision(2) << std::setw(9) << result.scene.objectCount << std::setw(10)
+                  << result.scene.uniqueMeshCount << std::setw(13)
+                  << result.scene.getTotalMs() - result.scene.insertMs << std::setw(11) << result.scene.insertMs
+                  << std::setw(10) << result.frames.meanMs << std::setw(10) << result.frames.p95Ms << std::setw(12)
+                  << result.prepareCpuMs << std::setw(14) << result.geometryCpuMs << std::setw(14)
+                  << result.geometryGpuMs << std::setw(14) << result.lightingGpuMs << std::endl;
+    }
+}
+
+std::vector<int> parseStressCounts(const std::string& text) {
+    std::vector<int> counts;
+    std::istringstream stream(text);
+    for (std::string item; std::getline(stream, item, ',');) {
+        size_t end = 0;
+        int count = 0;
+        try {
+            count = std::stoi(item, &end);
+        } catch (const std::exception&) {
+            end = 0;
+        }
+        if (end != item.size() || count <= 0) {
+            throw std::runtime_error("invalid stress object count " + item);
+        }
+        counts.push_back(count);
+    }
+    return counts;
+}
\ No newline at end of file
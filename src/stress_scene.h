@@ -0,0 +1,128 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "base/frame_statistics.h"
+#include "base/light.h"
+#include "base/model.h"
+
+enum class StressDistribution {
+    // a square grid on the ground
+    Grid,
+    // uniformly in a flat box
+    Uniform,
+    // dense clumps of about 256 objects
+    Clusters
+};
+
+struct StressSceneSettings {
+    uint32_t seed = 1;
+    int objectCount = 1000;
+    StressDistribution distribution = StressDistribution::Uniform;
+    // mean distance between neighbours, the scene grows with the object count at constant density
+    float spacing = 3.0f;
+    // fraction of the objects drawing a mesh of the shared pool, the others get a copy of their own
+    float instancingRatio = 0.9f;
+    // distinct textures, 0 leaves the models untextured
+    int textureCount = 8;
+    // the obj files of the asset root join the primitives in the pool
+    bool useAssets = true;
+    int pointLightCount = 4;
+    int spotLightCount = 4;
+};
+
+// where the time of a generation went, in milliseconds
+struct StressSceneReport {
+    double placementMs = 0.0;
+    double poolMs = 0.0;
+    double texturesMs = 0.0;
+    double modelsMs = 0.0;
+    // filled in by whoever adds the scene to the editor
+    double insertMs = 0.0;
+
+    size_t objectCount = 0;
+    size_t uniqueMeshCount = 0;
+    size_t triangleCount = 0;
+    size_t pointLightCount = 0;
+    size_t spotLightCount = 0;
+
+    double getTotalMs() const;
+
+    void print() const;
+};
+
+struct StressScene {
+    std::vector<Model> models;
+    std::vector<PointLight> pointLights;
+    std::vector<SpotLight> spotLights;
+    StressSceneReport report;
+};
+
+// procedural scenes for scaling tests, the same settings give the same scene on every platform
+class StressSceneGenerator {
+public:
+    // the lighting shader holds this many lights of each kind
+    static constexpr int maxLightsPerKind = 10;
+
+    // names the objects "<namePrefix><index>"
+    static StressScene generate(
+        const StressSceneSettings& settings, const std::string& assetRootDir,
+        const std::string& namePrefix = "Stress ");
+};
+
+// generates a scene of each object count in turn and renders warm-up then measured frames of it,
+// printing the generation phases, the frame times and the profiler passes for every count
+class StressRun {
+public:
+    enum class Step {
+        // the editor replaces the previous stress scene with one of getSettings()
+        Generate,
+        Render,
+        Done
+    };
+
+    StressRun(StressSceneSettings settings, std::vector<int> objectCounts, int warmupFrames, int measuredFrames);
+
+    Step beginFrame();
+
+    const StressSceneSettings& getSettings() const;
+
+    void setReport(const StressSceneReport& report);
+
+    // one row per object count
+    void printSummary() const;
+
+private:
+    // frames rendered after the measured ones so that their gpu queries are read back
+    static constexpr int drainFrames = 2;
+
+    struct Result {
+        StressSceneReport scene;
+        FrameTimeSummary frames;
+        // the main passes, negative when a pass did not run
+        double prepareCpuMs = -1.0;
+        double geometryCpuMs = -1.0;
+        double geometryGpuMs = -1.0;
+        double lightingGpuMs = -1.0;
+    };
+
+    StressSceneSettings _settings;
+    std::vector<int> _objectCounts;
+    int _warmupFrames;
+    int _measuredFrames;
+
+    size_t _countIndex = 0;
+    // -1 until the scene of the current count is generated
+    int _frameIndex = -1;
+    FrameStatistics _frames;
+    std::chrono::time_point<std::chrono::high_resolution_clock> _lastFrameTime;
+
+    Result _result;
+    std::vector<Result> _results;
+};
+
+// "1000,10000,100000" -> {1000, 10000, 100000}
+std::vector<int> parseStressCounts(const std::string& text);
\ No newline at end of file